@@ -0,0 +1,104 @@
+#include <math.h>
+#include "bitStream.h"
+
+//=============================================================================
+// Return value as a fixed point number of bits
+//=============================================================================
+unsigned int toFixed(float value, float min, float step, int bits)
+{
+    float q = floorf((value - min) / step + 0.5f);
+    float top = (float)((bits < 32 ? (1u << bits) : 0u) - 1u);
+    if (!(q > 0))                       // also catches NaN
+        return 0;
+    if (q > top)
+        q = top;
+    return (unsigned int)q;
+}
+
+//=============================================================================
+// BitWriter
+//=============================================================================
+BitWriter::BitWriter(char *buffer, int size)
+{
+    data = (unsigned char*)buffer;
+    this->size = size;
+    bit = 0;
+    scratch = 0;
+    overflowed = false;
+}
+
+//=============================================================================
+// Append the low bits of value, least significant first
+// Whole bytes are stored as they fill, the last partial byte on every write
+// so data is complete after any write.
+//=============================================================================
+void BitWriter::write(unsigned int value, int bits)
+{
+    if (bit + bits > size * 8)
+    {
+        overflowed = true;
+        return;
+    }
+    if (bits < 32)
+        value &= (1u << bits) - 1;
+    int pending = bit & 7;              // bits of the partial byte in scratch
+    scratch |= (unsigned long long)value << pending;
+    pending += bits;
+    int byte = bit >> 3;
+    bit += bits;
+    while (pending >= 8)
+    {
+        data[byte++] = (unsigned char)scratch;
+        scratch >>= 8;
+        pending -= 8;
+    }
+    if (pending > 0)
+        data[byte] = (unsigned char)scratch;
+}
+
+//=============================================================================
+// BitReader
+//=============================================================================
+BitReader::BitReader(const char *buffer, int size)
+{
+    data = (const unsigned char*)buffer;
+    this->size = size;
+    bit = 0;
+    next = 0;
+    scratch = 0;
+    loaded = 0;
+    overflowed = false;
+}
+
+//=============================================================================
+// Read bits written by BitWriter::write
+//=============================================================================
+unsigned int BitReader::read(int bits)
+{
+    if (bit + bits > size * 8)
+    {
+        overflowed = true;
+        return 0;
+    }
+    while (loaded < bits)
+    {
+        scratch |= (unsigned long long)data[next++] << loaded;
+        loaded += 8;
+    }
+    unsigned int value = (unsigned int)(scratch & ((1ull << bits) - 1));
+    scratch >>= bits;
+    loaded -= bits;
+    bit += bits;
+    return value;
+}
+
+//=============================================================================
+// Read bits and sign extend
+//=============================================================================
+int BitReader::readSigned(int bits)
+{
+    unsigned int value = read(bits);
+    if (bits < 32 && (value & (1u << (bits - 1))))
+        value |= ~((1u << bits) - 1);
+    return (int)value;
+}
@@ -0,0 +1,88 @@
+#ifndef _BITSTREAM_H            // Prevent multiple definitions if this
+#define _BITSTREAM_H            // file is included in more than one place
+
+// Bit packing for network messages
+// Values are written least significant bit first into consecutive bytes, so
+// the bytes on the wire are the same whatever the byte order, compiler or
+// structure packing of the machine. Floats are sent as fixed point numbers
+// of a chosen step and width, clamped to the range they can hold.
+// Reading or writing past the end of the buffer sets the overflow flag and
+// is otherwise ignored, reads then return 0.
+
+// Return (value-min)/step rounded to nearest, clamped to 0 .. 2^bits-1
+unsigned int toFixed(float value, float min, float step, int bits);
+
+// Return the float a fixed point number stands for
+inline float fromFixed(unsigned int q, float min, float step)  {return min + q * step;}
+
+class BitWriter
+{
+private:
+    unsigned char *data;
+    int     size;               // bytes in data
+    int     bit;                // bits written
+    unsigned long long scratch; // bits not yet in a whole byte of data
+    bool    overflowed;
+
+public:
+    // Pre: *buffer holds size bytes
+    BitWriter(char *buffer, int size);
+
+    // Write the low bits of value, bits = 1 to 32
+    void write(unsigned int value, int bits);
+
+    // Write a bool as one bit
+    void writeBool(bool b)      {write(b ? 1 : 0, 1);}
+
+    // Write a two's complement integer in bits
+    void writeSigned(int value, int bits)   {write((unsigned int)value, bits);}
+
+    // Write value as toFixed(value, min, step, bits)
+    void writeFixed(float value, float min, float step, int bits)
+    {write(toFixed(value, min, step, bits), bits);}
+
+    // Return bytes used, the last one may be partly filled
+    int  getSize() const        {return (bit + 7) / 8;}
+
+    // Return bits written
+    int  getBits() const        {return bit;}
+
+    // Return true if a write did not fit
+    bool overflow() const       {return overflowed;}
+};
+
+class BitReader
+{
+private:
+    const unsigned char *data;
+    int     size;               // bytes in data
+    int     bit;                // bits read
+    int     next;               // next byte of data to load into scratch
+    unsigned long long scratch; // bits loaded and not yet read
+    int     loaded;             // bits in scratch
+    bool    overflowed;
+
+public:
+    // Pre: *buffer holds size bytes
+    BitReader(const char *buffer, int size);
+
+    // Read bits, 1 to 32, written by BitWriter::write
+    unsigned int read(int bits);
+
+    // Read one bit as a bool
+    bool readBool()             {return read(1) != 0;}
+
+    // Read an integer written by BitWriter::writeSigned
+    int  readSigned(int bits);
+
+    // Read a float written by BitWriter::writeFixed
+    float readFixed(float min, float step, int bits)  {return fromFixed(read(bits), min, step);}
+
+    // Return bits read
+    int  getBits() const        {return bit;}
+
+    // Return true if a read went past the end of the buffer
+    bool overflow() const       {return overflowed;}
+};
+
+#endif
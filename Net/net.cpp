@@ -0,0 +1,914 @@
+#include <string.h>
+#include "net.h"
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#endif
+#ifdef __linux__
+#include "netEngine.h"
+#endif
+using namespace netNS;
+
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0          // no SIGPIPE to suppress on this platform
+#endif
+
+//=============================================================================
+// Socket calls that differ between Winsock and BSD sockets
+//=============================================================================
+#ifdef _WIN32
+static int  lastError()             {return WSAGetLastError();}
+static int  addrInfoError()         {return WSAGetLastError();}
+static int  closeSock(SOCKET s)     {return closesocket(s);}
+static bool wouldBlock(int err)     {return err == WSAEWOULDBLOCK;}
+static bool connecting(int err)     {return err == WSAEWOULDBLOCK || err == WSAEALREADY;}
+static bool connected(int err)      {return err == WSAEISCONN;}
+static bool addrInUse(int err)      {return err == WSAEADDRINUSE;}
+static const int SEND_FLAGS = 0;
+
+static int setNonBlocking(SOCKET s)
+{
+    unsigned long ul = 1;
+    return ioctlsocket(s, FIONBIO, &ul);
+}
+
+// Convert dotted quad to address, false if not a dotted quad
+static bool toAddr(const char *ip, in_addr &addr)
+{
+    addr.s_addr = inet_addr(ip);
+    return addr.s_addr != INADDR_NONE;
+}
+
+// Convert address to dotted quad
+static void toString(const in_addr &addr, char *ip)
+{
+    strncpy_s(ip, IP_SIZE, inet_ntoa(addr), IP_SIZE);
+}
+
+// Convert IPv6 text to address, false if not an IPv6 address
+static bool toAddr6(const char *ip, sockaddr_in6 &addr)
+{
+    addrinfo hints;
+    addrinfo *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET6;
+    hints.ai_flags = AI_NUMERICHOST;
+    if (getaddrinfo(ip, NULL, &hints, &result) != 0)
+        return false;
+    addr = *(sockaddr_in6 *)result->ai_addr;
+    freeaddrinfo(result);
+    return true;
+}
+
+// Convert IPv6 address to text
+static void toString6(const sockaddr_in6 &addr, char *ip)
+{
+    if (getnameinfo((const sockaddr *)&addr, sizeof(addr), ip, ADDRESS_SIZE, NULL, 0,
+                    NI_NUMERICHOST) != 0)
+        ip[0] = '\0';
+}
+#else
+static int  lastError()             {return errno;}
+static int  addrInfoError()         {return 0;}    // getaddrinfo does not set errno
+static int  closeSock(SOCKET s)     {return close(s);}
+static bool wouldBlock(int err)     {return err == EWOULDBLOCK || err == EAGAIN;}
+static bool connecting(int err)     {return wouldBlock(err) || err == EINPROGRESS || err == EALREADY;}
+static bool connected(int err)      {return err == EISCONN;}
+static bool addrInUse(int err)      {return err == EADDRINUSE;}
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+
+static int setNonBlocking(SOCKET s)
+{
+    int flags = fcntl(s, F_GETFL, 0);
+    if (flags == SOCKET_ERROR)
+        return SOCKET_ERROR;
+    return fcntl(s, F_SETFL, flags | O_NONBLOCK);
+}
+
+// Convert dotted quad to address, false if not a dotted quad
+static bool toAddr(const char *ip, in_addr &addr)
+{
+    return inet_pton(AF_INET, ip, &addr) == 1;
+}
+
+// Convert address to dotted quad
+static void toString(const in_addr &addr, char *ip)
+{
+    inet_ntop(AF_INET, &addr, ip, IP_SIZE);
+}
+
+// Convert IPv6 text to address, false if not an IPv6 address
+static bool toAddr6(const char *ip, sockaddr_in6 &addr)
+{
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    return inet_pton(AF_INET6, ip, &addr.sin6_addr) == 1;
+}
+
+// Convert IPv6 address to text
+static void toString6(const sockaddr_in6 &addr, char *ip)
+{
+    if (inet_ntop(AF_INET6, &addr.sin6_addr, ip, ADDRESS_SIZE) == NULL)
+        ip[0] = '\0';
+}
+#endif
+
+// First 12 bytes of an IPv4-mapped IPv6 address, ::ffff:nnn.nnn.nnn.nnn
+static const unsigned char V4_MAPPED[12] = {0,0,0,0,0,0,0,0,0,0,0xff,0xff};
+
+static bool isMapped(const sockaddr_in6 &addr)
+{
+    return memcmp(&addr.sin6_addr, V4_MAPPED, sizeof(V4_MAPPED)) == 0;
+}
+
+//=============================================================================
+// NetAddress
+//=============================================================================
+bool NetAddress::operator==(const NetAddress &other) const
+{
+    if (size == 0 || other.size == 0 || addr.ss_family != other.addr.ss_family)
+        return size == other.size;
+    if (addr.ss_family == AF_INET)
+    {
+        const sockaddr_in &a = (const sockaddr_in &)addr;
+        const sockaddr_in &b = (const sockaddr_in &)other.addr;
+        return a.sin_port == b.sin_port && a.sin_addr.s_addr == b.sin_addr.s_addr;
+    }
+    const sockaddr_in6 &a = (const sockaddr_in6 &)addr;
+    const sockaddr_in6 &b = (const sockaddr_in6 &)other.addr;
+    return a.sin6_port == b.sin6_port && a.sin6_scope_id == b.sin6_scope_id &&
+           memcmp(&a.sin6_addr, &b.sin6_addr, sizeof(a.sin6_addr)) == 0;
+}
+
+USHORT NetAddress::getPort() const
+{
+    if (size == 0)
+        return 0;
+    if (addr.ss_family == AF_INET6)
+        return ((const sockaddr_in6 &)addr).sin6_port;
+    return ((const sockaddr_in &)addr).sin_port;
+}
+
+bool NetAddress::isIPv6() const
+{
+    return size != 0 && addr.ss_family == AF_INET6 && !isMapped((const sockaddr_in6 &)addr);
+}
+
+void NetAddress::toString(char *ip) const
+{
+    ip[0] = '\0';
+    if (size == 0)
+        return;
+    if (addr.ss_family == AF_INET)
+        ::toString(((const sockaddr_in &)addr).sin_addr, ip);
+    else if (isIPv6())
+        toString6((const sockaddr_in6 &)addr, ip);
+    else        // IPv4-mapped, as a dotted quad
+    {
+        in_addr v4;
+        memcpy(&v4, (const char *)&((const sockaddr_in6 &)addr).sin6_addr + sizeof(V4_MAPPED),
+               sizeof(v4));
+        ::toString(v4, ip);
+    }
+}
+
+//=============================================================================
+// FNV-1a over the IP and port
+//=============================================================================
+size_t NetAddress::hash() const
+{
+    const unsigned char *ip = NULL;
+    size_t ipSize = 0;
+    if (size != 0 && addr.ss_family == AF_INET)
+    {
+        ip = (const unsigned char *)&((const sockaddr_in &)addr).sin_addr;
+        ipSize = sizeof(in_addr);
+    }
+    else if (size != 0)
+    {
+        ip = (const unsigned char *)&((const sockaddr_in6 &)addr).sin6_addr;
+        ipSize = sizeof(in6_addr);
+    }
+    unsigned int h = 2166136261u;
+    for (size_t i=0; i<ipSize; i++)
+        h = (h ^ ip[i]) * 16777619u;
+    USHORT port = getPort();
+    h = (h ^ (port & 0xff)) * 16777619u;
+    h = (h ^ (port >> 8)) * 16777619u;
+    return h;
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Net::Net()
+{
+    sock = INVALID_SOCKET;
+    ret = 0;
+    family = AF_INET;
+    netInitialized = false;
+    bound = false;
+    mode = UNINITIALIZED;
+    type = UNCONNECTED;
+    engine = NULL;
+    engineType = SOCKETS;
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+Net::~Net()
+{
+    closeSocket();                  // close connection, release memory
+}
+
+//=============================================================================
+// Initialize network
+// protocol = UDP or TCP
+// Called by netCreateServer and netCreatClient
+// Pre:
+//   port = Port number.
+//   protocol = UDP or TCP.
+//   family = AF_INET, or AF_INET6 for a dual stack socket.
+// Post:
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//=============================================================================
+int Net::initialize(int port, int protocol, int family)
+{
+    int off = 0;
+    int status;
+
+    if(netInitialized)              // if network currently initialized
+        closeSocket();              // close current network and start over
+
+    mode = UNINITIALIZED;
+
+#ifdef _WIN32
+    status = WSAStartup(0x0202, &wsd);  // initiate the use of winsock 2.2
+    if (status != 0)
+        return ( (status << 16) + NET_INIT_FAILED);
+#endif
+
+    switch (protocol)
+    {
+    case UDP:     // UDP
+        // Create UDP socket and bind it to a local interface and port
+        sock = socket(family, SOCK_DGRAM, IPPROTO_UDP);
+        type = UDP;
+        break;
+    case TCP:     // TCP
+        // Create TCP socket and bind it to a local interface and port
+        sock = socket(family, SOCK_STREAM, IPPROTO_TCP);
+        type = UNCONNECTED_TCP;
+        break;
+    default:    // Invalid type
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return (NET_INIT_FAILED);
+    }
+
+    // put socket in non-blocking mode, an IPv6 socket also takes IPv4
+    if (sock == INVALID_SOCKET || setNonBlocking(sock) == SOCKET_ERROR ||
+        (family == AF_INET6 && setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY,
+                                          (const char *)&off, sizeof(off)) == SOCKET_ERROR))
+    {
+        status = lastError();               // get detailed error
+        if (sock != INVALID_SOCKET)
+            closeSock(sock);
+        sock = INVALID_SOCKET;
+        type = UNCONNECTED;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return ( (status << 16) + NET_INVALID_SOCKET);
+    }
+
+    // set local family and port
+    memset(&localAddr, 0, sizeof(localAddr));
+    localAddr.sin_family = AF_INET;
+    localAddr.sin_port = htons((u_short)port);    // port number
+
+    // set remote family and port
+    memset(&remoteAddr, 0, sizeof(remoteAddr));
+    remoteAddr.sin_family = AF_INET;
+    remoteAddr.sin_port = htons((u_short)port);   // port number
+
+    this->family = family;
+    netInitialized = true;
+    return NET_OK;
+}
+
+//=============================================================================
+// Setup network for use as server
+// May not be configured as Server and Client at the same time.
+// Pre:
+//   port = Port number to listen on.
+//     Port numbers 0-1023 are used for well-known services.
+//     Port numbers 1024-65535 may be freely used.
+//   protocol = UDP or TCP
+//   ipv6 = true to accept IPv4 and IPv6 clients on one UDP socket
+// Post:
+//   Returns NET_OK on success
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//=============================================================================
+int Net::createServer(int port, int protocol, bool ipv6)
+{
+    int status = NET_INVALID_SOCKET;
+
+    // ----- Initialize network stuff -----
+    if (ipv6 && protocol == UDP)
+        status = initialize(port, protocol, AF_INET6);
+    if ((status & STATUS_MASK) == NET_INVALID_SOCKET)   // IPv4 only, or no IPv6 here
+        status = initialize(port, protocol, AF_INET);
+    if (status != NET_OK)
+        return status;
+
+    // bind socket, listen on all addresses
+    if (family == AF_INET6)
+    {
+        sockaddr_in6 anyAddr;
+        memset(&anyAddr, 0, sizeof(anyAddr));        // in6addr_any
+        anyAddr.sin6_family = AF_INET6;
+        anyAddr.sin6_port = htons((u_short)port);
+        ret = bind(sock, (sockaddr *)&anyAddr, sizeof(anyAddr));
+    }
+    else
+    {
+        localAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+        ret = bind(sock, (sockaddr *)&localAddr, sizeof(localAddr));
+    }
+    if (ret == SOCKET_ERROR)
+    {
+        status = lastError();                // get detailed error
+        if (addrInUse(status))
+            return ((status << 16) + NET_ADDR_IN_USE);
+        return ((status << 16) + NET_BIND_FAILED);
+    }
+    bound = true;
+    mode = SERVER;
+
+    return NET_OK;
+}
+
+//=============================================================================
+// Setup network for use as a Client
+// Pre:
+//   *server = IP address of server to connect to as null terminated
+//     string (e.g. "192.168.1.100") or null terminated domain name
+//     (e.g. "www.spacewarserver.com").
+//   port = Port number. Port numbers 0-1023 are used for well-known services.
+//     Port numbers 1024-65535 may be freely used.
+//   protocol = UDP or TCP
+// Post:
+//   Returns NET_OK on success
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   *server = IP address connected to as null terminated string.
+//=============================================================================
+int Net::createClient(char *server, int port, int protocol)
+{
+    int status;
+    char localIP[IP_SIZE];  // IP as string (e.g. "192.168.1.100");
+    addrinfo host;
+    addrinfo *result = NULL;
+
+    // ----- Initialize network stuff -----
+    status = initialize(port, protocol, AF_INET);
+    if (status != NET_OK)
+        return status;
+
+    // if server does not contain a dotted quad IP address nnn.nnn.nnn.nnn
+    if (!toAddr(server, remoteAddr.sin_addr))
+    {
+        // setup host structure for use in getaddrinfo() function
+        memset(&host, 0, sizeof(host));
+        host.ai_family = AF_INET;
+        host.ai_socktype = SOCK_STREAM;
+        host.ai_protocol = IPPROTO_TCP;
+
+        // get address information of server domain name
+        status = getaddrinfo(server,NULL,&host,&result);
+        if(status != 0)                 // if getaddrinfo failed
+        {
+            status = addrInfoError();
+            return ((status << 16) + NET_DOMAIN_NOT_FOUND);
+        }
+        // get IP address of server as string "nnn.nnn.nnn.nnn"
+        remoteAddr.sin_addr = ((SOCKADDR_IN *) result->ai_addr)->sin_addr;
+        freeaddrinfo(result);
+        toString(remoteAddr.sin_addr, server);
+    }
+
+    // set local IP address
+    if (getLocalIP(localIP) == NET_OK)
+        toAddr(localIP, localAddr.sin_addr);      // local IP
+
+    mode = CLIENT;
+    return NET_OK;
+}
+
+//=============================================================================
+// Send data to remote IP and port
+// Pre:
+//   *data = Data to send.
+//   size = Number of bytes to send.
+//   *remoteIP = Destination IP address as null terminated char array.
+//   port = Destination port number.
+// Post:
+//   Returns NET_OK on success. Success does not indicate data was sent.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   size = Number of bytes sent, 0 if no data sent.
+//=============================================================================
+int Net::sendData(const char *data, int &size, const char *remoteIP, const USHORT port)
+{
+    NetAddress destAddr;
+
+    // A client always sends to its server
+    if (mode == SERVER && !makeAddress(remoteIP, port, destAddr))
+    {
+        size = 0;
+        return NET_ERROR;       // not an address this socket can reach
+    }
+    return sendTo(data, size, destAddr);
+}
+
+//=============================================================================
+// Send data to a binary address
+// Pre:
+//   *data = Data to send.
+//   size = Number of bytes to send.
+//   to = Destination address, ignored by a client.
+// Post:
+//   Returns NET_OK on success. Success does not indicate data was sent.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   size = Number of bytes sent, 0 if no data sent.
+//=============================================================================
+int Net::sendTo(const char *data, int &size, const NetAddress &to)
+{
+    int status;
+    int sendSize = size;
+    int sent;
+    const sockaddr *destAddr = (const sockaddr *)&remoteAddr;
+    socklen_t destSize = sizeof(remoteAddr);
+
+    size = 0;       // assume 0 bytes sent, changed if send successful
+
+    // A server addresses each datagram with the caller's destination
+    // so several threads may send on the same socket.
+    if (mode == SERVER)
+    {
+        destAddr = (const sockaddr *)&to.addr;
+        destSize = to.size;
+    }
+
+    if(mode == CLIENT && type == UNCONNECTED_TCP)
+    {
+        ret = connect(sock,(sockaddr*)(&remoteAddr),sizeof(remoteAddr));
+        if (ret == SOCKET_ERROR) {
+            status = lastError();
+            if (connected(status))      // if connected
+            {
+                ret = 0;          // clear SOCKET_ERROR
+                type = CONNECTED_TCP;
+            }
+            else
+            {
+                if (connecting(status))
+                    return NET_OK;  // no connection yet
+                else
+                    return ((status << 16) + NET_ERROR);
+            }
+        }
+    }
+
+    sent = sendto(sock, data, sendSize, SEND_FLAGS, destAddr, destSize);
+    if (sent == SOCKET_ERROR)
+    {
+        status = lastError();
+        if (wouldBlock(status))
+            return NET_OK;  // socket buffer full, nothing sent
+        return ((status << 16) + NET_ERROR);
+    }
+    if (!bound)
+        bound = true;     // automatic binding by sendto if unbound
+    size = sent;          // number of bytes sent, may be 0
+    return NET_OK;
+}
+
+//=============================================================================
+// Read data, return sender's IP and port
+// Pre:
+//   *data = Buffer for received data.
+//   size = Number of bytes to receive.
+//   *senderIP = NULL
+// Post:
+//   Returns NET_OK on success.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   size = Number of bytes received, may be 0.
+//   *senderIP = IP address of sender as null terminated string.
+//   port = port number of sender.
+//=============================================================================
+int Net::readData(char *data, int &size, char *senderIP, USHORT &port)
+{
+    NetAddress senderAddr;
+    int status = readFrom(data, size, senderAddr);
+
+    if (size > 0)
+    {
+        senderAddr.toString(senderIP);  // IP of sender
+        port = senderAddr.getPort();    // port number of sender
+    }
+    return status;
+}
+
+//=============================================================================
+// Read data, return sender's binary address
+// Pre:
+//   *data = Buffer for received data.
+//   size = Number of bytes to receive.
+// Post:
+//   Returns NET_OK on success.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   size = Number of bytes received, may be 0.
+//   from = Address of sender when size > 0.
+//=============================================================================
+int Net::readFrom(char *data, int &size, NetAddress &from)
+{
+    int status;
+    int readSize = size;
+
+    size = 0;           // assume 0 bytes read, changed if read successful
+    if(bound == false)  // no receive from unbound socket
+        return NET_OK;
+
+    if(mode == SERVER && type == UNCONNECTED_TCP)
+    {
+        ret = listen(sock,1);
+        if (ret == SOCKET_ERROR)
+        {
+            status = lastError();
+            return ((status << 16) + NET_ERROR);
+        }
+        SOCKET tempSock;
+        tempSock = accept(sock,NULL,NULL);
+        if (tempSock == INVALID_SOCKET)
+        {
+            status = lastError();
+            if (!wouldBlock(status))    // don't report WOULDBLOCK error
+                return ((status << 16) + NET_ERROR);
+            return NET_OK;      // no connection yet
+        }
+        closeSock(sock);        // don't need old socket
+        sock = tempSock;        // TCP client connected
+        type = CONNECTED_TCP;
+    }
+
+    if(mode == CLIENT && type == UNCONNECTED_TCP)
+        return NET_OK;  // no connection yet
+
+    if(sock != INVALID_SOCKET)
+    {
+        from.size = sizeof(from.addr);
+        ret = recvfrom(sock, data, readSize, 0, (sockaddr *)&from.addr, &from.size);
+        if (ret == SOCKET_ERROR) {
+            status = lastError();
+            if (!wouldBlock(status))    // don't report WOULDBLOCK error
+                return ((status << 16) + NET_ERROR);
+            ret = 0;            // clear SOCKET_ERROR
+        // if TCP connection did graceful close
+        } else if(ret == 0 && type == CONNECTED_TCP)
+            // return Remote Disconnect error
+            return ((REMOTE_DISCONNECT << 16) + NET_ERROR);
+        if (ret && type == CONNECTED_TCP)   // a stream has no sender address
+        {
+            memcpy(&from.addr, &remoteAddr, sizeof(remoteAddr));
+            from.size = sizeof(remoteAddr);
+        }
+        size = ret;           // number of bytes read, may be 0
+    }
+    return NET_OK;
+}
+
+//=============================================================================
+// Build the address of ip:port in the form this socket sends to
+// An IPv4 address becomes IPv4-mapped IPv6 on a dual stack socket.
+//=============================================================================
+bool Net::makeAddress(const char *ip, USHORT port, NetAddress &address)
+{
+    in_addr v4;
+
+    address.clear();
+    if (toAddr(ip, v4))
+    {
+        if (family == AF_INET6)
+        {
+            sockaddr_in6 &a = (sockaddr_in6 &)address.addr;
+            memset(&a, 0, sizeof(a));
+            a.sin6_family = AF_INET6;
+            a.sin6_port = port;
+            memcpy(&a.sin6_addr, V4_MAPPED, sizeof(V4_MAPPED));
+            memcpy((char *)&a.sin6_addr + sizeof(V4_MAPPED), &v4, sizeof(v4));
+            address.size = sizeof(a);
+        }
+        else
+        {
+            sockaddr_in &a = (sockaddr_in &)address.addr;
+            memset(&a, 0, sizeof(a));
+            a.sin_family = AF_INET;
+            a.sin_port = port;
+            a.sin_addr = v4;
+            address.size = sizeof(a);
+        }
+        return true;
+    }
+    sockaddr_in6 v6;
+    if (family == AF_INET6 && toAddr6(ip, v6))
+    {
+        v6.sin6_port = port;
+        memcpy(&address.addr, &v6, sizeof(v6));
+        address.size = sizeof(v6);
+        return true;
+    }
+    return false;
+}
+
+//=============================================================================
+// Read up to count waiting datagrams
+// Pre:
+//   packets[0 to count-1].data = Buffers for received data.
+//   packets[0 to count-1].size = Buffer sizes.
+// Post:
+//   Returns NET_OK on success.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   count = Number of datagrams read, 0 if none are waiting.
+//   packets[0 to count-1] = size and sender address of each datagram read.
+//=============================================================================
+int Net::readBatch(NetPacket *packets, int &count)
+{
+    int status;
+    int wanted = count;
+
+    count = 0;          // assume none read, changed if read successful
+#ifdef __linux__
+    if(type == UDP)
+    {
+        if(bound == false)  // no receive from unbound socket
+            return NET_OK;
+        count = wanted;
+        if (engine)
+            return engine->read(packets, count);
+        return NetEngine::receive(sock, packets, count);
+    }
+#endif
+    while (count < wanted)
+    {
+        NetPacket &packet = packets[count];
+        status = readFrom(packet.data, packet.size, packet.address);
+        if (status != NET_OK)
+            return status;
+        if (packet.size == 0)   // no more waiting
+            break;
+        count++;
+    }
+    return NET_OK;
+}
+
+//=============================================================================
+// Send count datagrams
+// Pre:
+//   packets[0 to count-1] = data, size and destination address.
+// Post:
+//   Returns NET_OK on success. Success does not indicate data was sent.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//   count = Number of datagrams sent.
+//=============================================================================
+int Net::sendBatch(const NetPacket *packets, int &count)
+{
+    int status;
+    int wanted = count;
+
+    count = 0;          // assume none sent, changed if send successful
+#ifdef __linux__
+    if(type == UDP && mode == SERVER)
+    {
+        count = wanted;
+        if (engine)
+        {
+            engine->queueSends(packets, count);
+            return NET_OK;
+        }
+        return NetEngine::transmit(sock, packets, count);
+    }
+#endif
+    while (count < wanted)
+    {
+        const NetPacket &packet = packets[count];
+        int size = packet.size;
+        status = sendTo(packet.data, size, packet.address);
+        if (status != NET_OK)
+            return status;
+        if (size == 0)          // socket buffer full
+            break;
+        count++;
+    }
+    return NET_OK;
+}
+
+//=============================================================================
+// Select how readBatch and sendBatch reach the socket
+// Returns the engine in use
+//=============================================================================
+int Net::setEngine(int newEngine)
+{
+#ifdef __linux__
+    if (engine)
+    {
+        flush();                    // don't lose queued datagrams
+        delete engine;
+        engine = NULL;
+    }
+    engineType = SOCKETS;
+    if (type != UDP || sock == INVALID_SOCKET)
+        return engineType;
+
+    if (newEngine == URING)
+    {
+        engine = new UringEngine;
+        if (engine->initialize(sock))
+            return (engineType = URING);
+        delete engine;
+        engine = NULL;
+        newEngine = EPOLL;          // io_uring unavailable, fall back to epoll
+    }
+    if (newEngine == EPOLL)
+    {
+        engine = new EpollEngine;
+        if (engine->initialize(sock))
+            return (engineType = EPOLL);
+        delete engine;
+        engine = NULL;
+    }
+#else
+    (void)newEngine;
+#endif
+    return engineType;
+}
+
+//=============================================================================
+// Send the datagrams queued by sendBatch
+//=============================================================================
+int Net::flush()
+{
+#ifdef __linux__
+    if (engine)
+        return engine->flush();
+#endif
+    return NET_OK;
+}
+
+//=============================================================================
+// Return the datagrams flush() has dropped
+//=============================================================================
+long Net::getDropped()
+{
+#ifdef __linux__
+    if (engine)
+        return engine->getDropped();
+#endif
+    return 0;
+}
+
+//=============================================================================
+// Close socket and free resources.
+// Post:
+//   Socket is closed
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//=============================================================================
+int Net::closeSocket()
+{
+    int status = NET_OK;
+    bool wasInitialized = netInitialized;
+
+#ifdef __linux__
+    delete engine;              // before the socket it uses is closed
+    engine = NULL;
+#endif
+    engineType = SOCKETS;
+    type = UNCONNECTED;
+    bound = false;
+    netInitialized = false;
+
+    if (sock == INVALID_SOCKET)
+        return NET_OK;
+
+    // closing implicitly causes a shutdown sequence to occur
+    if (closeSock(sock) == SOCKET_ERROR)
+    {
+        status = lastError();
+        if (!wouldBlock(status))    // don't report WOULDBLOCK error
+            status = (status << 16) + NET_ERROR;
+        else
+            status = NET_OK;
+    }
+    sock = INVALID_SOCKET;
+
+#ifdef _WIN32
+    if (wasInitialized && WSACleanup() && status == NET_OK)
+        return NET_ERROR;
+#else
+    (void)wasInitialized;
+#endif
+    return status;
+}
+
+//=============================================================================
+// Get the IP address of this computer as a string
+// Post:
+//   *localIP = IP address of local computer as null terminated string on success,
+//     the loopback address on error.
+//   Returns two part int code on error.
+//     The low 16 bits contains Status code as defined in net.h.
+//     The high 16 bits contains the socket error code.
+//=============================================================================
+int Net::getLocalIP(char *localIP)
+{
+    char hostName[40];
+    addrinfo host;
+    addrinfo *result = NULL;
+    int status;
+
+    gethostname (hostName,40);
+    hostName[39] = '\0';
+
+    // setup host structure for use in getaddrinfo() function
+    memset(&host, 0, sizeof(host));
+    host.ai_family = AF_INET;
+    host.ai_socktype = SOCK_STREAM;
+    host.ai_protocol = IPPROTO_TCP;
+
+    // get address information
+    status = getaddrinfo(hostName,NULL,&host,&result);
+    if(status != 0)                 // if getaddrinfo failed
+    {
+        status = addrInfoError();           // get detailed error
+        memcpy(localIP, "127.0.0.1", sizeof("127.0.0.1"));
+        return ( (status << 16) + NET_ERROR);
+    }
+
+    // get IP address of server
+    in_addr addr = ((SOCKADDR_IN *) result->ai_addr)->sin_addr;
+    freeaddrinfo(result);
+    toString(addr, localIP);
+
+    return NET_OK;
+}
+
+//=============================================================================
+// Returns detailed error message from two part error code
+//=============================================================================
+std::string Net::getError(int error)
+{
+    int sockErr = error >> 16;  // upper 16 bits is the socket error code
+    std::string errorStr;
+
+    error &= STATUS_MASK;       // remove extended error code
+    if(error > ERROR_CODES-2)   // if unknown error code
+        error = ERROR_CODES-1;
+    errorStr = codes[error];
+#ifdef _WIN32
+    for (int i=0; i< SOCK_CODES; i++)
+    {
+        if(errorCodes[i].sockErr == sockErr)
+        {
+            errorStr += errorCodes[i].message;
+            break;
+        }
+    }
+#else
+    if(sockErr != 0)
+        errorStr += strerror(sockErr);
+#endif
+    return errorStr;
+}
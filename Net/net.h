@@ -0,0 +1,440 @@
+#ifndef _NET_H                  // Prevent multiple definitions if this 
+#define _NET_H                  // file is included in more than one place
+
+#include <stdio.h>
+#include <string>
+
+// Network I/O
+// One Net class for every project. Windows builds use Winsock 2, all others
+// use BSD sockets. The API and the two part status codes are the same on
+// both; only the socket error code in the high 16 bits differs, a Windows
+// Socket Error Code on Windows and errno elsewhere.
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib,"Ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <errno.h>
+typedef int             SOCKET;
+typedef unsigned short  USHORT;
+typedef sockaddr_in     SOCKADDR_IN;
+#endif
+
+namespace netNS
+{
+    const int DEFAULT_PORT = 48161;
+    const int MIN_PORT = 1024;
+    const int IP_SIZE = 16;     // size of "nnn.nnn.nnn.nnn"
+    const int ADDRESS_SIZE = 64;    // size of any IPv4 or IPv6 address as text, with scope
+
+    // Mode
+    const int UNINITIALIZED = 0;
+    const int SERVER = 1;
+    const int CLIENT = 2;
+
+    // Connection type
+    const int UNCONNECTED = -1;
+    const int UDP = 0;
+    const int TCP = 1;
+    const int UNCONNECTED_TCP = 2;
+    const int CONNECTED_TCP = 3;
+
+    // Status codes
+    const int STATUS_MASK = 0X0FFFF;    // AND with return to reveal Status code
+    const int NET_OK = 0;
+    const int NET_ERROR = 1;
+    const int NET_INIT_FAILED = 2;
+    const int NET_INVALID_SOCKET = 3;
+    const int NET_GET_HOST_BY_NAME_FAILED = 4;
+    const int NET_BIND_FAILED = 5;
+    const int NET_CONNECT_FAILED = 6;
+    const int NET_ADDR_IN_USE = 7;
+    const int NET_DOMAIN_NOT_FOUND = 8;
+
+    const int PACKETS_PER_SEC = 30;         // Number of packets to send per second
+    const float NET_TIME = 1.0f/PACKETS_PER_SEC;   // time between net transmissions
+    const int MAX_ERRORS = PACKETS_PER_SEC*30;  // Packets/Sec * 30 Sec
+    const int MAX_COMM_WARNINGS = 10;       // max packets out of sync before time reset
+    const int MAX_BATCH = 64;               // datagrams per system call in readBatch/sendBatch
+
+    // Network engines, see Net::setEngine
+    // SOCKETS: readBatch and sendBatch call the socket directly
+    // EPOLL:   reads wait for epoll, sends are queued until flush (Linux only)
+    // URING:   multishot receives and queued sends on an io_uring (Linux only)
+    enum ENGINE {SOCKETS, EPOLL, URING};
+    const int ENGINES = 3;
+    static const char * const ENGINE_NAMES[ENGINES] = {"sockets", "epoll", "uring"};
+
+    // Connection response messages, ===== MUST BE SAME SIZE =====
+    const int RESPONSE_SIZE = 12;
+    const char CLIENT_ID[RESPONSE_SIZE]   = "Client v2.0";  // client ID
+    const char SERVER_ID[RESPONSE_SIZE]   = "Server v2.0";  // server ID
+    const char SERVER_FULL[RESPONSE_SIZE] = "Server Full";  // server full
+
+    const int ERROR_CODES = 10;
+    // Network error codes
+    static const char * const codes[ERROR_CODES] = {
+        "No errors reported",
+        "General network error: ",
+        "Network init failed: ",
+        "Invalid socket: ",
+        "Get host by name failed: ",
+        "Bind failed: ",
+        "Connect failed: ",
+        "Port already in use: ",
+        "Domain not found: ",
+        "Unknown network error: "
+    };
+
+#ifdef _WIN32
+    struct ErrorCode
+    {
+        int sockErr;        // Windows Socket Error Code
+        const char *message;
+    };
+
+    const int REMOTE_DISCONNECT = 0x2775;
+
+    const int SOCK_CODES = 29;
+    // Windows Socket Error Codes
+    static const ErrorCode errorCodes[SOCK_CODES] = {
+        {0x2714, "A blocking operation was interrupted"},
+        {0x271D, "Socket access permission violation"},
+        {0x2726, "Invalid argument"},
+        {0x2728, "Too many open sockets"},
+        {0x2735, "Operation in progress"},
+        {0x2736, "Operation on non-socket"},
+        {0x2737, "Address missing"},
+        {0x2738, "Message bigger than buffer"},
+        {0x273F, "Address incompatible with protocol"},
+        {0x2740, "Address is already in use"},
+        {0x2741, "Address not valid in current context"},
+        {0x2742, "Network is down"},
+        {0x2743, "Network unreachable"},
+        {0x2744, "Connection broken during operation"},
+        {0x2745, "Connection aborted by host software"},
+        {0x2746, "Connection reset by remote host"},
+        {0x2747, "Insufficient buffer space"},
+        {0x2748, "Connect request on already connected socket"},
+        {0x2749, "Socket not connected or address not specified"},
+        {0x274A, "Socket already shut down"},
+        {0x274C, "Operation timed out"},
+        {0x274D, "Connection refused by target"},
+        {0x274E, "Cannot translate name"},
+        {0x274F, "Name too long"},
+        {0x2750, "Destination host down"},
+        {0x2751, "Host unreachable"},
+        {0x276B, "Network cannot initialize, system unavailable"},
+        {0x276D, "Network has not been initialized"},
+        {0x2775, "Remote has disconnected"},
+    };
+#else
+    const int REMOTE_DISCONNECT = ECONNRESET;
+    const int INVALID_SOCKET = -1;
+    const int SOCKET_ERROR = -1;
+#endif
+}
+
+// Binary address of a peer, IPv4 or IPv6, in the form the socket uses
+// Servers compare and hash these instead of converting each datagram's
+// address to and from text. On a dual stack server socket IPv4 peers are
+// IPv4-mapped IPv6 addresses, printed as dotted quads.
+struct NetAddress
+{
+    sockaddr_storage addr;
+    socklen_t   size;           // bytes of addr in use, 0 for no address
+
+    NetAddress()    {size = 0;}
+
+    // Forget the address
+    void clear()    {size = 0;}
+
+    // Return true if both are the same IP, port and, for IPv6, scope
+    bool operator==(const NetAddress &other) const;
+    bool operator!=(const NetAddress &other) const  {return !(*this == other);}
+
+    // Return port, network byte order
+    USHORT getPort() const;
+
+    // Return true for an IPv6 peer, false for IPv4 or IPv4-mapped
+    bool isIPv6() const;
+
+    // Write the IP as null terminated text
+    // Pre: *ip holds netNS::ADDRESS_SIZE chars
+    void toString(char *ip) const;
+
+    // Return a hash of the IP and port
+    size_t hash() const;
+};
+
+// Hash functor for unordered containers keyed by NetAddress
+struct NetAddressHash
+{
+    size_t operator()(const NetAddress &address) const {return address.hash();}
+};
+
+// One datagram of a readBatch or sendBatch call
+struct NetPacket
+{
+    char   *data;               // packet buffer
+    int     size;               // bytes to send, or buffer size before a read
+                                // and bytes received after it
+    NetAddress address;         // destination or sender
+};
+
+class NetEngine;
+
+class Net 
+{
+private:
+    // Network Variables
+#ifdef _WIN32
+    WSADATA     wsd;
+#endif
+    SOCKET      sock;
+    int         ret;
+    SOCKADDR_IN remoteAddr, localAddr;
+    int         family;         // AF_INET, or AF_INET6 for a dual stack server
+    bool        netInitialized;
+    bool        bound;
+    char        mode;
+    int         type;
+    USHORT      port;
+    NetEngine   *engine;        // NULL for SOCKETS
+    int         engineType;
+
+    //=============================================================================
+    // Initialize network (for class use only)
+    // protocol = UDP or TCP
+    // Called by netCreateServer and netCreatClient
+    // Pre:
+    //   port = Port number.
+    //   protocol = UDP or TCP.
+    //   family = AF_INET, or AF_INET6 for a dual stack socket.
+    // Post:
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //=============================================================================
+    int initialize(int port, int protocol, int family);    
+
+public:
+    // Constructor
+    Net();
+    // Destructor
+    virtual ~Net();
+
+    //=============================================================================
+    // Setup network for use as server
+    // May not be configured as Server and Client at the same time.
+    // Pre: 
+    //   port = Port number to listen on.
+    //     Port numbers 0-1023 are used for well-known services.
+    //     Port numbers 1024-65535 may be freely used.
+    //   protocol = UDP or TCP
+    //   ipv6 = true to accept IPv4 and IPv6 clients on one UDP socket, where
+    //     the system supports it. readData's senderIP must then hold
+    //     ADDRESS_SIZE chars.
+    // Post:
+    //   Returns NET_OK on success
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //=============================================================================
+    int createServer(int port, int protocol, bool ipv6 = false);
+
+    //=============================================================================
+    // Setup network for use as a Client
+    // Pre: 
+    //   *server = IP address of server to connect to as null terminated
+    //     string (e.g. "192.168.1.100") or null terminated domain name
+    //     (e.g. "www.spacewarserver.com").
+    //   port = Port number. Port numbers 0-1023 are used for well-known services.
+    //     Port numbers 1024-65535 may be freely used.
+    //   protocol = UDP or TCP
+    // Post:
+    //   Returns NET_OK on success
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //   *server = IP address connected to as null terminated string.
+    //=============================================================================
+    int createClient(char *server, int port, int protocol);
+
+    //=============================================================================
+    // Send data
+    // Pre:
+    //   *data = Data to send
+    //   size = Number of bytes to send
+    //   *remoteIP = Destination IP address as null terminated char array
+    //   port = Destination port number
+    // Post: 
+    //   Returns NET_OK on success. Success does not indicate data was sent.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //   size = Number of bytes sent, 0 if no data sent, unchanged on error.
+    // A bound server socket may send from several threads at the same time.
+    //=============================================================================
+    int sendData(const char *data, int &size, const char *remoteIP, USHORT port);
+
+    //=============================================================================
+    // Read data
+    // Pre:
+    //   *data = Buffer for received data.
+    //   size = Number of bytes to receive.
+    //   *senderIP = NULL
+    // Post: 
+    //   Returns NET_OK on success.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //   size = Number of bytes received, may be 0. Unchanged on error.
+    //   *senderIP = IP address of sender as null terminated string.
+    //   &port = port number of sender
+    //=============================================================================
+    int readData(char *data, int &size, char *senderIP, USHORT &port);
+
+    //=============================================================================
+    // Send data to a binary address, as sendData without parsing an IP string
+    // Pre:
+    //   to = Destination from readFrom, readBatch or makeAddress. Ignored by
+    //     a client, which sends to its server.
+    //=============================================================================
+    int sendTo(const char *data, int &size, const NetAddress &to);
+
+    //=============================================================================
+    // Read data and the sender's binary address, as readData without
+    // formatting an IP string
+    // Post:
+    //   from = Sender's address when size > 0.
+    //=============================================================================
+    int readFrom(char *data, int &size, NetAddress &from);
+
+    //=============================================================================
+    // Build the address of ip:port in the form this socket sends to
+    // Pre:
+    //   *ip = IPv4 dotted quad, or IPv6 address on a dual stack server.
+    //   port = Port number, network byte order.
+    // Post:
+    //   Returns true on success, false if ip is not an address the socket
+    //   can reach.
+    //=============================================================================
+    bool makeAddress(const char *ip, USHORT port, NetAddress &address);
+
+    //=============================================================================
+    // Return true for a dual stack server that accepts IPv6 clients
+    //=============================================================================
+    bool isDualStack()  {return family == AF_INET6;}
+
+    //=============================================================================
+    // Read up to count waiting datagrams
+    // Linux reads MAX_BATCH datagrams per system call with recvmmsg, or
+    // from io_uring completions with the URING engine. Other platforms call
+    // readFrom once per datagram.
+    // Pre:
+    //   packets[0 to count-1].data = Buffers for received data.
+    //   packets[0 to count-1].size = Buffer sizes.
+    // Post:
+    //   Returns NET_OK on success.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //   count = Number of datagrams read, 0 if none are waiting. Datagrams
+    //     read before an error are counted.
+    //   packets[0 to count-1] = size and sender address of each datagram read.
+    //=============================================================================
+    int readBatch(NetPacket *packets, int &count);
+
+    //=============================================================================
+    // Send count datagrams
+    // A Linux server sends MAX_BATCH datagrams per system call with sendmmsg,
+    // clients and other platforms call sendTo once per datagram.
+    // Pre:
+    //   packets[0 to count-1] = data, size and destination address.
+    //     The address is ignored by a client, as in sendTo.
+    // Post:
+    //   Returns NET_OK on success. Success does not indicate data was sent.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //   count = Number of datagrams sent, less than count if the socket
+    //     buffer filled or an error stopped the batch. With the EPOLL or
+    //     URING engine, the number queued for flush().
+    // A bound server socket may send from several threads at the same time.
+    //=============================================================================
+    int sendBatch(const NetPacket *packets, int &count);
+
+    //=============================================================================
+    // Select how readBatch and sendBatch reach the socket
+    // URING falls back to EPOLL when io_uring is unavailable, and EPOLL to
+    // SOCKETS. Other platforms always use SOCKETS. With EPOLL or URING,
+    // sendBatch only queues its datagrams and flush() sends them.
+    // Pre:
+    //   createServer or createClient was called with UDP.
+    //   engine = SOCKETS, EPOLL or URING
+    // Post:
+    //   Returns the engine in use.
+    //=============================================================================
+    int setEngine(int engine);
+
+    //=============================================================================
+    // Return the engine in use
+    //=============================================================================
+    int getEngine()     {return engineType;}
+
+    //=============================================================================
+    // Send the datagrams queued by sendBatch, call from the thread that reads
+    // Post:
+    //   Returns NET_OK on success. Success does not indicate data was sent.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //=============================================================================
+    int flush();
+
+    //=============================================================================
+    // Return the number of datagrams queued by sendBatch that flush() could
+    // not send and dropped, since the engine was installed. 0 for SOCKETS.
+    //=============================================================================
+    long getDropped();
+
+    //=============================================================================
+    // Close socket and free resources
+    // Post:
+    //   Socket is closed and buffer memory is released.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //=============================================================================
+    int closeSocket();
+
+    //=============================================================================
+    // Get the IP address of this computer as a string
+    // Post:
+    //   *localIP = IP address of local computer as null terminated string on success,
+    //     the loopback address on error.
+    //   Returns two part int code on error.
+    //     The low 16 bits contains Status code as defined in net.h.
+    //     The high 16 bits contains the socket error code.
+    //=============================================================================
+    int getLocalIP(char *localIP);
+
+    //=============================================================================
+    // Return mode
+    // Valid modes are: UNINITIALIZED, SERVER, CLIENT
+    //=============================================================================
+    char getMode()      {return mode;}
+
+    //=============================================================================
+    // Returns detailed error message from two part error code
+    //=============================================================================
+    std::string getError(int error);
+};
+
+#endif
@@ -0,0 +1,622 @@
+#ifdef __linux__
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "netEngine.h"
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+using namespace netNS;
+using namespace netEngineNS;
+
+// io_uring needs multishot receives and provided buffer rings, Linux 6.0
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define NET_URING
+#endif
+
+//=============================================================================
+// Constructor
+//=============================================================================
+NetEngine::NetEngine()
+{
+    sock = INVALID_SOCKET;
+    queued = 0;
+    dropped = 0;
+}
+
+//=============================================================================
+// Copy count datagrams into the queue
+//=============================================================================
+void NetEngine::queueSends(const NetPacket *packets, int count)
+{
+    std::lock_guard<std::mutex> lock(queueLock);
+    for (int n=0; n<count; n++)
+    {
+        if (queued == (int)queue.size())
+            queue.push_back(Outgoing());
+        Outgoing &out = queue[queued++];
+        out.data.assign(packets[n].data, packets[n].data + packets[n].size);   // keeps the old capacity
+        out.dest = packets[n].address;
+    }
+}
+
+//=============================================================================
+// Move the queue into sending, so other threads may queue during the send
+//=============================================================================
+int NetEngine::takeQueue()
+{
+    std::lock_guard<std::mutex> lock(queueLock);
+    int count = queued;
+    queue.swap(sending);
+    queued = 0;
+    return count;
+}
+
+//=============================================================================
+// recvmmsg up to count datagrams, MAX_BATCH per system call
+//=============================================================================
+int NetEngine::receive(SOCKET s, NetPacket *packets, int &count)
+{
+    mmsghdr msgs[MAX_BATCH];
+    iovec iov[MAX_BATCH];
+    int wanted = count;
+    int status;
+
+    count = 0;
+    while (count < wanted)
+    {
+        int n = wanted - count;
+        if (n > MAX_BATCH)
+            n = MAX_BATCH;
+        memset(msgs, 0, n * sizeof(mmsghdr));
+        for (int i=0; i<n; i++)
+        {
+            iov[i].iov_base = packets[count+i].data;
+            iov[i].iov_len = packets[count+i].size;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &packets[count+i].address.addr;
+            msgs[i].msg_hdr.msg_namelen = sizeof(packets[count+i].address.addr);
+        }
+        int ret = recvmmsg(s, msgs, n, MSG_DONTWAIT, NULL);
+        if (ret == SOCKET_ERROR)
+        {
+            status = errno;
+            if (status != EWOULDBLOCK && status != EAGAIN)  // don't report WOULDBLOCK error
+                return ((status << 16) + NET_ERROR);
+            return NET_OK;              // nothing more waiting
+        }
+        for (int i=0; i<ret; i++)
+        {
+            packets[count+i].size = (int)msgs[i].msg_len;
+            packets[count+i].address.size = msgs[i].msg_hdr.msg_namelen;
+        }
+        count += ret;
+        if (ret < n)                    // socket drained
+            break;
+    }
+    return NET_OK;
+}
+
+//=============================================================================
+// sendmmsg count datagrams, MAX_BATCH per system call
+//=============================================================================
+int NetEngine::transmit(SOCKET s, const NetPacket *packets, int &count)
+{
+    mmsghdr msgs[MAX_BATCH];
+    iovec iov[MAX_BATCH];
+    int wanted = count;
+    int status;
+
+    count = 0;
+    while (count < wanted)
+    {
+        int n = wanted - count;
+        if (n > MAX_BATCH)
+            n = MAX_BATCH;
+        memset(msgs, 0, n * sizeof(mmsghdr));
+        for (int i=0; i<n; i++)
+        {
+            const NetPacket &packet = packets[count+i];
+            iov[i].iov_base = packet.data;
+            iov[i].iov_len = packet.size;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = (void*)&packet.address.addr;
+            msgs[i].msg_hdr.msg_namelen = packet.address.size;
+        }
+        int sent = sendmmsg(s, msgs, n, MSG_NOSIGNAL);
+        if (sent == SOCKET_ERROR)
+        {
+            status = errno;
+            if (status == EWOULDBLOCK || status == EAGAIN)
+                return NET_OK;          // socket buffer full
+            return ((status << 16) + NET_ERROR);
+        }
+        count += sent;
+        if (sent < n)                   // socket buffer full
+            break;
+    }
+    return NET_OK;
+}
+
+//=============================================================================
+// EpollEngine
+//=============================================================================
+EpollEngine::EpollEngine()
+{
+    epollFd = -1;
+}
+
+EpollEngine::~EpollEngine()
+{
+    if (epollFd >= 0)
+        close(epollFd);
+}
+
+//=============================================================================
+// Watch socket s for datagrams
+//=============================================================================
+bool EpollEngine::initialize(SOCKET s)
+{
+    sock = s;
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        return false;
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, sock, &ev) < 0)
+        return false;
+    return true;
+}
+
+//=============================================================================
+// Read only when epoll reports the socket readable
+//=============================================================================
+int EpollEngine::read(NetPacket *packets, int &count)
+{
+    epoll_event ev;
+    int ready = epoll_wait(epollFd, &ev, 1, 0);     // don't wait
+    if (ready <= 0)
+    {
+        count = 0;
+        if (ready < 0 && errno != EINTR)
+            return ((errno << 16) + NET_ERROR);
+        return NET_OK;
+    }
+    return receive(sock, packets, count);
+}
+
+//=============================================================================
+// Send the queue with sendmmsg
+// Datagrams that do not fit in the socket buffer are dropped, as sendData
+// would drop them.
+//=============================================================================
+int EpollEngine::flush()
+{
+    int count = takeQueue();
+    NetPacket packets[MAX_BATCH];
+
+    for (int done=0; done<count; )
+    {
+        int n = count - done;
+        if (n > MAX_BATCH)
+            n = MAX_BATCH;
+        for (int i=0; i<n; i++)
+        {
+            Outgoing &out = sending[done+i];
+            packets[i].data = out.data.empty() ? NULL : &out.data[0];
+            packets[i].size = (int)out.data.size();
+            packets[i].address = out.dest;
+        }
+        int sent = n;
+        int status = transmit(sock, packets, sent);
+        if (status != NET_OK)
+        {
+            dropped += count - done;
+            return status;
+        }
+        if (sent < n)                   // socket buffer full
+        {
+            dropped += count - done - sent;
+            break;
+        }
+        done += n;
+    }
+    return NET_OK;
+}
+
+//=============================================================================
+// UringEngine
+//=============================================================================
+#ifdef NET_URING
+
+static const __u64 RECV_DATA = ~0ULL;  // user_data of the multishot receive
+
+static int uringSetup(unsigned entries, io_uring_params *p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+static int uringRegister(int fd, unsigned opcode, void *arg, unsigned args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, args);
+}
+#endif
+
+UringEngine::UringEngine()
+{
+    ringFd = -1;
+    sqRing = MAP_FAILED;
+    sqRingSize = 0;
+    sqHead = sqTail = sqMask = sqFlags = sqArray = NULL;
+    sqEntries = 0;
+    sqLocalTail = 0;
+    sqes = (io_uring_sqe*)MAP_FAILED;
+    sqesSize = 0;
+    cqRing = MAP_FAILED;
+    cqRingSize = 0;
+    cqHead = cqTail = cqMask = NULL;
+    cqes = NULL;
+    bufRing = (io_uring_buf_ring*)MAP_FAILED;
+    bufRingSize = 0;
+    bufTail = 0;
+    memset(&recvMsg, 0, sizeof(recvMsg));
+    recvArmed = false;
+}
+
+UringEngine::~UringEngine()
+{
+    release();
+}
+
+//=============================================================================
+// Close the ring, which cancels the receive and any sends in flight
+//=============================================================================
+void UringEngine::release()
+{
+    if (ringFd >= 0)
+        close(ringFd);
+    ringFd = -1;
+    if (cqRing != MAP_FAILED && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+        munmap(sqRing, sqRingSize);
+    if ((void*)sqes != MAP_FAILED)
+        munmap(sqes, sqesSize);
+    if ((void*)bufRing != MAP_FAILED)
+        munmap(bufRing, bufRingSize);
+    sqRing = cqRing = MAP_FAILED;
+    sqes = (io_uring_sqe*)MAP_FAILED;
+    bufRing = (io_uring_buf_ring*)MAP_FAILED;
+    for (size_t i=0; i<slots.size(); i++)
+        delete slots[i];
+    slots.clear();
+    freeSlots.clear();
+    received.clear();
+    recvArmed = false;
+}
+
+//=============================================================================
+// Create the ring, provide the receive buffers and post the receive
+// Returns false if io_uring or a feature it needs is missing
+//=============================================================================
+bool UringEngine::initialize(SOCKET s)
+{
+#ifdef NET_URING
+    io_uring_params p;
+
+    sock = s;
+    // completions are run when the thread next enters the kernel anyway,
+    // e.g. in the tick scheduler's sleep, instead of interrupting it
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+    ringFd = uringSetup(RING_ENTRIES, &p);
+    if (ringFd < 0)
+        return false;
+
+    // map the rings
+    sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (cqRingSize > sqRingSize)
+            sqRingSize = cqRingSize;
+        cqRingSize = sqRingSize;
+    }
+    sqRing = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        {release(); return false;}
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        cqRing = sqRing;
+    else
+    {
+        cqRing = mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+            {release(); return false;}
+    }
+    sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    sqes = (io_uring_sqe*)mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               ringFd, IORING_OFF_SQES);
+    if ((void*)sqes == MAP_FAILED)
+        {release(); return false;}
+
+    char *sq = (char*)sqRing;
+    sqHead = (unsigned*)(sq + p.sq_off.head);
+    sqTail = (unsigned*)(sq + p.sq_off.tail);
+    sqMask = (unsigned*)(sq + p.sq_off.ring_mask);
+    sqFlags = (unsigned*)(sq + p.sq_off.flags);
+    sqArray = (unsigned*)(sq + p.sq_off.array);
+    sqEntries = p.sq_entries;
+    sqLocalTail = *sqTail;
+    char *cq = (char*)cqRing;
+    cqHead = (unsigned*)(cq + p.cq_off.head);
+    cqTail = (unsigned*)(cq + p.cq_off.tail);
+    cqMask = (unsigned*)(cq + p.cq_off.ring_mask);
+    cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    // provide the receive buffers
+    bufRingSize = RECV_BUFFERS * sizeof(io_uring_buf);
+    bufRing = (io_uring_buf_ring*)mmap(NULL, bufRingSize, PROT_READ | PROT_WRITE,
+                                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void*)bufRing == MAP_FAILED)
+        {release(); return false;}
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (__u64)(unsigned long)bufRing;
+    reg.ring_entries = RECV_BUFFERS;
+    reg.bgid = BUFFER_GROUP;
+    if (uringRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        {release(); return false;}
+    recvBuffers.resize(RECV_BUFFERS * RECV_BUFFER_SIZE);
+    bufTail = 0;
+    for (unsigned bid=0; bid<RECV_BUFFERS; bid++)
+        recycleBuffer(bid);
+    __atomic_store_n(&bufRing->tail, bufTail, __ATOMIC_RELEASE);
+
+    // each buffer holds an io_uring_recvmsg_out, the sender address and the datagram
+    memset(&recvMsg, 0, sizeof(recvMsg));
+    recvMsg.msg_namelen = sizeof(sockaddr_storage);
+    armReceive();
+    if (submit() != NET_OK)
+        {release(); return false;}
+    return true;
+#else
+    (void)s;
+    return false;
+#endif
+}
+
+#ifdef NET_URING
+//=============================================================================
+// Return the next free SQE
+//=============================================================================
+io_uring_sqe *UringEngine::getSqe()
+{
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (sqLocalTail - head >= sqEntries)
+    {
+        submit();               // full, hand the queue to the kernel
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqLocalTail - head >= sqEntries)
+            return NULL;
+    }
+    unsigned index = sqLocalTail & *sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    sqLocalTail++;
+    return sqe;
+}
+
+//=============================================================================
+// Post the multishot receive, one completion per datagram until it stops
+//=============================================================================
+void UringEngine::armReceive()
+{
+    io_uring_sqe *sqe = getSqe();
+    if (sqe == NULL)
+        return;
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = sock;
+    sqe->addr = (__u64)(unsigned long)&recvMsg;
+    sqe->len = 1;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = RECV_DATA;
+    recvArmed = true;
+}
+
+//=============================================================================
+// Add buffer bid at the local tail, published by the caller
+//=============================================================================
+void UringEngine::recycleBuffer(unsigned bid)
+{
+    // indexed by hand, bufs is not at offset 0 when the header is compiled as C++
+    io_uring_buf &buf = ((io_uring_buf*)bufRing)[bufTail & (RECV_BUFFERS - 1)];
+    buf.addr = (__u64)(unsigned long)&recvBuffers[bid * RECV_BUFFER_SIZE];
+    buf.len = RECV_BUFFER_SIZE;
+    buf.bid = (__u16)bid;
+    bufTail++;
+}
+
+//=============================================================================
+// Take every completion from the queue
+// Sends are reaped even when read() is not called or stops early, so their
+// slots are reused instead of new ones being made for every flush.
+//=============================================================================
+void UringEngine::reap()
+{
+    unsigned head = *cqHead;
+    unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+        io_uring_cqe &cqe = cqes[head & *cqMask];
+        head++;
+        if (cqe.user_data != RECV_DATA)     // a send completed
+        {
+            freeSlots.push_back((int)cqe.user_data);
+            continue;
+        }
+        if (!(cqe.flags & IORING_CQE_F_MORE))
+            recvArmed = false;              // receive stopped, post it again
+        Received r = {cqe.res, cqe.flags};
+        received.push_back(r);
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+}
+
+//=============================================================================
+// Publish new SQEs and let the kernel run completed work
+//=============================================================================
+int UringEngine::submit()
+{
+    unsigned toSubmit = sqLocalTail - *sqTail;
+    __atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+    int ret = uringEnter(ringFd, toSubmit, 0, IORING_ENTER_GETEVENTS);
+    if (ret < 0 && errno != EINTR && errno != EBUSY)
+        return ((errno << 16) + NET_ERROR);
+    return NET_OK;
+}
+#else
+io_uring_sqe *UringEngine::getSqe()         {return NULL;}
+void UringEngine::armReceive()              {}
+void UringEngine::recycleBuffer(unsigned)   {}
+void UringEngine::reap()                    {}
+int  UringEngine::submit()                  {return NET_ERROR;}
+#endif
+
+//=============================================================================
+// Read up to count datagrams from the completion queue
+// Every send completion frees its slot. A system call is only made when the
+// kernel has completions it could not post by itself or the receive must
+// be posted again.
+//=============================================================================
+int UringEngine::read(NetPacket *packets, int &count)
+{
+#ifdef NET_URING
+    int wanted = count;
+    int status = NET_OK;
+
+    count = 0;
+    if (__atomic_load_n(sqFlags, __ATOMIC_RELAXED) & IORING_SQ_TASKRUN)
+        status = submit();          // run completions waiting for us
+
+    reap();
+    bool recycled = false;
+    size_t taken = 0;
+    for (; taken < received.size() && count < wanted; taken++)
+    {
+        const Received &cqe = received[taken];
+        if (cqe.res < 0)
+        {
+            if (cqe.res != -ENOBUFS)        // out of buffers only stops the receive
+                status = ((-cqe.res) << 16) + NET_ERROR;
+            continue;
+        }
+        if (!(cqe.flags & IORING_CQE_F_BUFFER))
+            continue;
+        unsigned bid = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+        char *buf = &recvBuffers[bid * RECV_BUFFER_SIZE];
+        io_uring_recvmsg_out *out = (io_uring_recvmsg_out*)buf;
+        char *name = buf + sizeof(io_uring_recvmsg_out);
+        char *payload = name + recvMsg.msg_namelen + recvMsg.msg_controllen;
+        int size = (int)out->payloadlen;
+        if (size > cqe.res - (int)(payload - buf))  // cut short by the buffer size
+            size = cqe.res - (int)(payload - buf);
+        if (size > packets[count].size)     // truncate like recvfrom
+            size = packets[count].size;
+        memcpy(packets[count].data, payload, size);
+        packets[count].size = size;
+        NetAddress &from = packets[count].address;
+        from.size = out->namelen < sizeof(from.addr) ? out->namelen : sizeof(from.addr);
+        memcpy(&from.addr, name, from.size);
+        count++;
+        recycleBuffer(bid);
+        recycled = true;
+    }
+    received.erase(received.begin(), received.begin() + taken);
+    if (recycled)
+        __atomic_store_n(&bufRing->tail, bufTail, __ATOMIC_RELEASE);
+    if (!recvArmed)
+    {
+        armReceive();
+        int s = submit();
+        if (status == NET_OK)
+            status = s;
+    }
+    return status;
+#else
+    (void)packets;
+    count = 0;
+    return NET_ERROR;
+#endif
+}
+
+//=============================================================================
+// Submit the queued sends with one io_uring_enter
+// Each send keeps its slot until its completion is reaped.
+//=============================================================================
+int UringEngine::flush()
+{
+#ifdef NET_URING
+    int count = takeQueue();
+    if (count == 0)
+        return NET_OK;
+    reap();                         // free the slots of sends already done
+    for (int n=0; n<count; n++)
+    {
+        io_uring_sqe *sqe = getSqe();
+        if (sqe == NULL)
+        {
+            dropped += count - n;   // ring full, drop the rest as UDP would
+            break;
+        }
+        int slotN;
+        if (freeSlots.empty())
+        {
+            slotN = (int)slots.size();
+            slots.push_back(new SendSlot);
+        }
+        else
+        {
+            slotN = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        SendSlot &slot = *slots[slotN];
+        slot.data.swap(sending[n].data);    // no copy, both keep their capacity
+        slot.dest = sending[n].dest;
+        slot.iov.iov_base = slot.data.empty() ? NULL : &slot.data[0];
+        slot.iov.iov_len = slot.data.size();
+        memset(&slot.msg, 0, sizeof(slot.msg));
+        slot.msg.msg_name = &slot.dest.addr;
+        slot.msg.msg_namelen = slot.dest.size;
+        slot.msg.msg_iov = &slot.iov;
+        slot.msg.msg_iovlen = 1;
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = sock;
+        sqe->addr = (__u64)(unsigned long)&slot.msg;
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = (__u64)slotN;
+    }
+    return submit();
+#else
+    return NET_ERROR;
+#endif
+}
+
+#endif  // __linux__
@@ -0,0 +1,178 @@
+#ifndef _NETENGINE_H            // Prevent multiple definitions if this
+#define _NETENGINE_H            // file is included in more than one place
+
+#include <vector>
+#include <mutex>
+#include <sys/uio.h>
+#include "net.h"
+
+// Network engines for a UDP Net socket, Linux only
+// Net::setEngine installs one of these. With an engine, Net::sendBatch
+// copies its datagrams into a queue from any thread and they all go out
+// when the main thread calls Net::flush() at the end of the tick.
+//   EpollEngine  reads after epoll reports the socket readable and sends
+//                the queue with sendmmsg, MAX_BATCH datagrams per call.
+//   UringEngine  keeps a multishot receive posted on an io_uring. Datagrams
+//                land in a ring of buffers provided to the kernel and are
+//                read from the completion queue without a system call. The
+//                queued sends are submitted with a single io_uring_enter.
+// NetEngine also holds the recvmmsg and sendmmsg loops used by Net itself
+// when no engine is installed.
+
+namespace netEngineNS
+{
+    const unsigned RING_ENTRIES = 4096;     // io_uring submission queue size
+    const unsigned RECV_BUFFERS = 1024;     // receive buffers provided to io_uring, power of 2
+    const int RECV_BUFFER_SIZE = 2048;      // bytes per receive buffer, largest datagram read
+    const int BUFFER_GROUP = 1;             // provided buffer group id
+}
+
+class NetEngine
+{
+protected:
+    // A queued datagram, with its own copy of the data
+    struct Outgoing
+    {
+        std::vector<char> data;
+        NetAddress dest;
+    };
+
+    SOCKET sock;
+    std::mutex queueLock;               // guards queue and queued
+    std::vector<Outgoing> queue;        // entries are reused, the first queued are in use
+    int queued;
+    std::vector<Outgoing> sending;      // queue taken by flush()
+    long dropped;                       // queued datagrams flush() could not send
+
+    // Move the queue into sending, returns the number of datagrams taken
+    int takeQueue();
+
+public:
+    // Constructor
+    NetEngine();
+    // Destructor
+    virtual ~NetEngine() {}
+
+    // Set up the engine for UDP socket s
+    // Post: returns true if the engine can run on this system
+    virtual bool initialize(SOCKET s) = 0;
+
+    // Read up to count waiting datagrams, called by the main thread
+    // Pre: packets[].data and packets[].size describe the buffers
+    // Post: count = datagrams read, packets[].size and address are set
+    //       returns NET_OK or a two part error code
+    virtual int read(NetPacket *packets, int &count) = 0;
+
+    // Copy count datagrams into the queue, safe from any thread
+    void queueSends(const NetPacket *packets, int count);
+
+    // Send every queued datagram, called by the main thread
+    // Datagrams that can not be sent are dropped, as UDP would, and counted.
+    // Post: returns NET_OK or a two part error code
+    virtual int flush() = 0;
+
+    // Return the number of queued datagrams flush() has dropped
+    long getDropped() const     {return dropped;}
+
+    // recvmmsg up to count datagrams from socket s, see read()
+    static int receive(SOCKET s, NetPacket *packets, int &count);
+
+    // sendmmsg count datagrams to their addresses from socket s
+    // Post: count = datagrams sent, fewer if the socket buffer filled
+    //       returns NET_OK or a two part error code
+    static int transmit(SOCKET s, const NetPacket *packets, int &count);
+};
+
+// Wait for the socket with epoll, move datagrams with recvmmsg and sendmmsg
+class EpollEngine : public NetEngine
+{
+private:
+    int epollFd;
+
+public:
+    EpollEngine();
+    virtual ~EpollEngine();
+    virtual bool initialize(SOCKET s);
+    virtual int read(NetPacket *packets, int &count);
+    virtual int flush();
+};
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+// Multishot receives into provided buffers and batched sends on an io_uring
+class UringEngine : public NetEngine
+{
+private:
+    // A send in flight. Owns the data until its completion is read.
+    struct SendSlot
+    {
+        msghdr msg;
+        iovec iov;
+        NetAddress dest;
+        std::vector<char> data;
+    };
+
+    // A receive completion taken from the queue, not yet read
+    struct Received
+    {
+        int res;
+        unsigned flags;
+    };
+
+    int ringFd;
+    // submission queue
+    void *sqRing;
+    size_t sqRingSize;
+    unsigned *sqHead, *sqTail, *sqMask, *sqFlags, *sqArray;
+    unsigned sqEntries;
+    unsigned sqLocalTail;           // tail including SQEs not yet published
+    io_uring_sqe *sqes;
+    size_t sqesSize;
+    // completion queue
+    void *cqRing;
+    size_t cqRingSize;
+    unsigned *cqHead, *cqTail, *cqMask;
+    io_uring_cqe *cqes;
+    // provided receive buffers
+    io_uring_buf_ring *bufRing;
+    size_t bufRingSize;
+    unsigned short bufTail;         // buffers handed back to the kernel
+    std::vector<char> recvBuffers;
+    msghdr recvMsg;                 // sizes of the name and control parts of each buffer
+    bool recvArmed;                 // true while the multishot receive is posted
+    std::vector<Received> received; // in arrival order
+    // sends
+    std::vector<SendSlot*> slots;
+    std::vector<int> freeSlots;
+
+    // Return the next free SQE, submitting first if the queue is full
+    io_uring_sqe *getSqe();
+
+    // Post the multishot receive
+    void armReceive();
+
+    // Hand buffer bid back to the kernel
+    void recycleBuffer(unsigned bid);
+
+    // Take every completion, sends free their slots and receives wait in
+    // received for read()
+    void reap();
+
+    // Publish new SQEs and run completed work
+    // Post: returns NET_OK or a two part error code
+    int submit();
+
+    // Free everything, safe on a partly initialized engine
+    void release();
+
+public:
+    UringEngine();
+    virtual ~UringEngine();
+    virtual bool initialize(SOCKET s);
+    virtual int read(NetPacket *packets, int &count);
+    virtual int flush();
+};
+
+#endif
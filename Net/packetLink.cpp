@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include "packetLink.h"
+#include "bitStream.h"
+using namespace packetLinkNS;
+
+namespace
+{
+    const unsigned long long WINDOW_MASK = (1ull << WINDOW) - 1;
+}
+
+//=============================================================================
+// Return the number of bits set in bits
+//=============================================================================
+static int countBits(unsigned long long bits)
+{
+    int count = 0;
+    for (; bits; bits &= bits - 1)
+        count++;
+    return count;
+}
+
+//=============================================================================
+// Return part/(part+rest), 0 if both are 0
+//=============================================================================
+static float rate(unsigned int part, unsigned int rest)
+{
+    if (part + rest == 0)
+        return 0;
+    return (float)part / (float)(part + rest);
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+PacketLink::PacketLink()
+{
+    reset();
+}
+
+//=============================================================================
+// Start a new connection
+//=============================================================================
+void PacketLink::reset()
+{
+    localSequence = 0;
+    remoteSequence = 0;
+    started = false;
+    receivedWindow = 0;
+    ackedWindow = 0;
+    sent = received = duplicates = late = lost = 0;
+    acked = unacked = 0;
+}
+
+//=============================================================================
+// Fill header for the next packet to send
+// The packet WINDOW sequences back leaves the window, if the peer has not
+// acked it by now it never arrived.
+//=============================================================================
+void PacketLink::stamp(PacketHeader &header)
+{
+    if (sent >= (unsigned int)WINDOW && !(ackedWindow & (1ull << (WINDOW-1))))
+        unacked++;
+    ackedWindow = (ackedWindow << 1) & WINDOW_MASK;
+    localSequence++;
+    if (localSequence == 0)     // 0 is no sequence
+        localSequence = 1;
+    sent++;
+
+    header.sequence = localSequence;
+    header.ack = started ? remoteSequence : 0;
+    header.ackBits = started ? (unsigned int)(receivedWindow >> 1) : 0;
+}
+
+//=============================================================================
+// Record the peer's acks of our packets
+//=============================================================================
+void PacketLink::readAcks(const PacketHeader &header)
+{
+    if (header.ack == 0 || sent == 0)
+        return;
+    int offset = (USHORT)(localSequence - header.ack);
+    if (header.ack > localSequence)
+        offset--;               // wrapped past 0, which is never sent
+    if (offset >= WINDOW)       // too old to tell, or not one of ours
+        return;
+    unsigned long long bits = (1ull << offset) | ((unsigned long long)header.ackBits << (offset + 1));
+    bits &= WINDOW_MASK;
+    if (sent < (unsigned int)WINDOW)    // only sequences sent so far
+        bits &= (1ull << sent) - 1;
+    unsigned long long newly = bits & ~ackedWindow;
+    acked += countBits(newly);
+    ackedWindow |= newly;
+}
+
+//=============================================================================
+// Record a received header, returns false if the packet must be dropped
+//=============================================================================
+bool PacketLink::receive(const PacketHeader &header)
+{
+    if (header.sequence == 0)
+        return false;
+    readAcks(header);
+    if (!started)
+    {
+        started = true;
+        remoteSequence = header.sequence;
+        receivedWindow = WINDOW_MASK;   // nothing before the first is missing
+        received++;
+        return true;
+    }
+
+    int ahead = (short)(header.sequence - remoteSequence);
+    if (ahead > 0 && header.sequence < remoteSequence)
+        ahead--;                // wrapped past 0, which is never sent
+    else if (ahead < 0 && header.sequence > remoteSequence)
+        ahead++;
+    if (ahead > 0)              // newest yet
+    {
+        if (ahead >= WINDOW)
+        {
+            lost += WINDOW - countBits(receivedWindow) + (ahead - WINDOW);
+            receivedWindow = 1;
+        }
+        else
+        {
+            // sequences moving out of the window were lost if not received
+            lost += ahead - countBits(receivedWindow >> (WINDOW - ahead));
+            receivedWindow = ((receivedWindow << ahead) | 1) & WINDOW_MASK;
+        }
+        remoteSequence = header.sequence;
+        received++;
+        return true;
+    }
+
+    int behind = -ahead;
+    if (behind < WINDOW)
+    {
+        if (receivedWindow & (1ull << behind))
+        {
+            duplicates++;
+            return false;
+        }
+        receivedWindow |= 1ull << behind;   // no longer missing, but stale
+    }
+    else if (lost > 0)
+        lost--;                 // counted lost when it left the window
+    late++;
+    return false;
+}
+
+//=============================================================================
+// Rates
+//=============================================================================
+float PacketLink::getLossRate() const
+{
+    return rate(lost, received + late);
+}
+
+float PacketLink::getReorderRate() const
+{
+    return rate(late, received);
+}
+
+float PacketLink::getDuplicateRate() const
+{
+    return rate(duplicates, received + late);
+}
+
+float PacketLink::getSendLossRate() const
+{
+    return rate(unacked, acked);
+}
+
+//=============================================================================
+// Return the counts and rates as text
+//=============================================================================
+std::string PacketLink::getStatsString() const
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+        "in %u loss %.1f%% reorder %.1f%% dup %.1f%%, out %u loss %.1f%%",
+        received, getLossRate()*100, getReorderRate()*100, getDuplicateRate()*100,
+        sent, getSendLossRate()*100);
+    return std::string(buffer);
+}
+
+//=============================================================================
+// Write header as HEADER_SIZE bytes
+//=============================================================================
+void PacketLink::writeHeader(const PacketHeader &header, char *buffer)
+{
+    BitWriter out(buffer, HEADER_SIZE);
+    out.write(header.sequence, 16);
+    out.write(header.ack, 16);
+    out.write(header.ackBits, 32);
+}
+
+//=============================================================================
+// Read a header written by writeHeader
+//=============================================================================
+bool PacketLink::readHeader(const char *buffer, int size, PacketHeader &header)
+{
+    if (size < HEADER_SIZE)
+        return false;
+    BitReader in(buffer, HEADER_SIZE);
+    header.sequence = (USHORT)in.read(16);
+    header.ack = (USHORT)in.read(16);
+    header.ackBits = in.read(32);
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef _PACKETLINK_H            // Prevent multiple definitions if this
+#define _PACKETLINK_H            // file is included in more than one place
+
+#include <string>
+#include "net.h"
+
+// Sequence numbers and acks for one connection
+// Every game packet, in both directions, carries a PacketHeader with its
+// own sequence number and the newest sequence received from the peer plus
+// a bitfield of the 32 before it. The receiver drops a packet that is a
+// duplicate or older than one it already has, so stale input or game
+// state is never applied. Sequences that leave the 33 packet window
+// without arriving are counted as lost, those the peer never acks as lost
+// on the way out.
+
+namespace packetLinkNS
+{
+    const int WINDOW = 33;          // newest sequence and the 32 in ackBits
+    const int HEADER_SIZE = 8;      // bytes of a header written by writeHeader
+}
+
+// Sent at the start of every game packet, 8 bytes
+struct PacketHeader
+{
+    USHORT       sequence;  // this packet, from 1 and never 0
+    USHORT       ack;       // newest sequence received from the peer, 0 for none
+    unsigned int ackBits;   // bit n set if sequence ack-1-n was received
+};
+
+class PacketLink
+{
+private:
+    USHORT       localSequence;     // last sequence sent
+    USHORT       remoteSequence;    // newest sequence received
+    bool         started;           // true once a packet was received
+    unsigned long long receivedWindow;  // bit n = remoteSequence-n received
+    unsigned long long ackedWindow;     // bit n = localSequence-n acked by the peer
+    unsigned int sent;              // packets stamped
+    unsigned int received;          // packets accepted
+    unsigned int duplicates;        // packets received twice, dropped
+    unsigned int late;              // packets older than the newest, dropped
+    unsigned int lost;              // sequences that never arrived
+    unsigned int acked;             // packets sent that the peer acked
+    unsigned int unacked;           // packets sent that the peer never acked
+
+    // Record the peer's acks of our packets
+    void readAcks(const PacketHeader &header);
+
+public:
+    // Constructor
+    PacketLink();
+
+    // Start a new connection, forget all sequences and counts
+    void reset();
+
+    // Forget the peer's sequence so the next packet is accepted whatever
+    // its sequence, counts are kept
+    void resync()               {started = false;}
+
+    // Fill header for the next packet to send
+    void stamp(PacketHeader &header);
+
+    // Record a received header
+    // Post: returns false if the packet is a duplicate or stale and must be
+    //       dropped, the acks it carries are used either way
+    bool receive(const PacketHeader &header);
+
+    // Incoming sequences lost, 0 to 1
+    float getLossRate() const;
+
+    // Incoming packets that arrived after a newer one, 0 to 1
+    float getReorderRate() const;
+
+    // Incoming packets that arrived more than once, 0 to 1
+    float getDuplicateRate() const;
+
+    // Outgoing packets the peer never acked, 0 to 1
+    float getSendLossRate() const;
+
+    // Return the sequence the next stamp will use
+    USHORT getNextSequence() const   {return localSequence == 0xFFFF ? 1 : localSequence + 1;}
+
+    // Return packets accepted
+    unsigned int getReceived() const {return received;}
+
+    // Return packets sent
+    unsigned int getSent() const     {return sent;}
+
+    // Return the counts and rates as text
+    std::string getStatsString() const;
+
+    // Write header as HEADER_SIZE bytes, little-endian
+    static void writeHeader(const PacketHeader &header, char *buffer);
+
+    // Read a header written by writeHeader
+    // Post: returns false if size is less than HEADER_SIZE
+    static bool readHeader(const char *buffer, int size, PacketHeader &header);
+};
+
+#endif
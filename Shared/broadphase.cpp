@@ -0,0 +1,254 @@
+#include <math.h>
+#include <algorithm>
+#include "broadphase.h"
+using namespace broadphaseNS;
+
+//=============================================================================
+// Order pairs so duplicates are adjacent
+//=============================================================================
+static bool pairLess(const BroadphasePair &a, const BroadphasePair &b)
+{
+    return (a.a < b.a) || (a.a == b.a && a.b < b.b);
+}
+
+static bool pairEqual(const BroadphasePair &a, const BroadphasePair &b)
+{
+    return a.a == b.a && a.b == b.b;
+}
+
+//=============================================================================
+// Return true if a is left of b on the sweep list
+//=============================================================================
+bool Broadphase::sweepLess(const SweepEntry &a, const SweepEntry &b)
+{
+    return a.minX < b.minX;
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Broadphase::Broadphase()
+{
+    width = 1;
+    height = 1;
+    cellSize = DEFAULT_CELL_SIZE;
+    maxRadius = 0;
+    method = GRID;
+}
+
+//=============================================================================
+// Set world size, method and grid cell size
+//=============================================================================
+void Broadphase::initialize(float worldWidth, float worldHeight, int method, float cell)
+{
+    width = (worldWidth > 1) ? worldWidth : 1;
+    height = (worldHeight > 1) ? worldHeight : 1;
+    this->method = method;
+    cellSize = (cell > 1) ? cell : 1;
+    clear();
+}
+
+//=============================================================================
+// Remove all entities
+//=============================================================================
+void Broadphase::clear()
+{
+    proxies.clear();
+    pairs.clear();
+    maxRadius = 0;
+}
+
+//=============================================================================
+// Add an entity, its center is wrapped into the world
+// Returns the index used in BroadphasePair
+//=============================================================================
+int Broadphase::add(float x, float y, float radius)
+{
+    Proxy p;
+    p.x = fmodf(x, width);
+    if (p.x < 0)
+        p.x += width;
+    p.y = fmodf(y, height);
+    if (p.y < 0)
+        p.y += height;
+    p.radius = radius;
+    if (radius > maxRadius)
+        maxRadius = radius;
+    proxies.push_back(p);
+    return (int)proxies.size() - 1;
+}
+
+//=============================================================================
+// Return true if the bounding boxes of a and b overlap
+// The distance on each axis is the shorter way around the wrapped world.
+//=============================================================================
+bool Broadphase::overlaps(const Proxy &a, const Proxy &b) const
+{
+    float reach = a.radius + b.radius;
+    float dx = fabsf(a.x - b.x);
+    if (dx > width*0.5f)
+        dx = width - dx;
+    if (dx > reach)
+        return false;
+    float dy = fabsf(a.y - b.y);
+    if (dy > height*0.5f)
+        dy = height - dy;
+    return dy <= reach;
+}
+
+//=============================================================================
+// Return every pair of entities that may collide
+//=============================================================================
+const std::vector<BroadphasePair>& Broadphase::findPairs()
+{
+    pairs.clear();
+    if (proxies.size() < 2)
+        return pairs;
+    if (method == SWEEP)
+        sweepPairs();
+    else
+        gridPairs();
+    return pairs;
+}
+
+//=============================================================================
+// Uniform grid
+// Cells are at least as wide as the largest entity so every overlapping pair
+// lies in the same or neighbouring cells. Entities are bucketed with a
+// counting sort, then each entity is tested against higher numbered entities
+// in its own and the 8 surrounding cells, wrapping at the world edges.
+//=============================================================================
+void Broadphase::gridPairs()
+{
+    float cell = cellSize;
+    if (cell < 2*maxRadius)
+        cell = 2*maxRadius;
+    int cols = (int)(width / cell);
+    int rows = (int)(height / cell);
+    if (cols < 1)
+        cols = 1;
+    if (rows < 1)
+        rows = 1;
+    float cellW = width / cols;     // cells tile the world exactly
+    float cellH = height / rows;
+    int cells = cols * rows;
+    int count = (int)proxies.size();
+
+    // count entities in each cell
+    cellStart.assign(cells + 1, 0);
+    proxyCell.resize(count);
+    for (int i=0; i<count; i++)
+    {
+        int cx = (int)(proxies[i].x / cellW);
+        int cy = (int)(proxies[i].y / cellH);
+        if (cx >= cols)             // x == width after rounding
+            cx = cols - 1;
+        if (cy >= rows)
+            cy = rows - 1;
+        proxyCell[i] = cy*cols + cx;
+        cellStart[proxyCell[i] + 1]++;
+    }
+    for (int c=0; c<cells; c++)
+        cellStart[c+1] += cellStart[c];
+
+    // place entities in cell order
+    cellItems.resize(count);
+    for (int i=0; i<count; i++)
+    {
+        int c = proxyCell[i];
+        cellItems[cellStart[c]] = i;
+        cellStart[c]++;
+    }
+    for (int c=cells; c>0; c--)     // restore cell starts
+        cellStart[c] = cellStart[c-1];
+    cellStart[0] = 0;
+
+    // neighbour offsets, without repeats when the grid is under 3 cells wide
+    int nx[3], ny[3];
+    int nxCount = 0, nyCount = 0;
+    for (int d=-1; d<=1 && nxCount<cols; d++)
+        nx[nxCount++] = d;
+    for (int d=-1; d<=1 && nyCount<rows; d++)
+        ny[nyCount++] = d;
+
+    for (int c=0; c<cells; c++)
+    {
+        int cx = c % cols;
+        int cy = c / cols;
+        for (int k=cellStart[c]; k<cellStart[c+1]; k++)
+        {
+            int a = cellItems[k];
+            for (int j=0; j<nyCount; j++)
+            {
+                int ry = (cy + ny[j] + rows) % rows;
+                for (int i=0; i<nxCount; i++)
+                {
+                    int n = ry*cols + (cx + nx[i] + cols) % cols;
+                    for (int m=cellStart[n]; m<cellStart[n+1]; m++)
+                    {
+                        int b = cellItems[m];
+                        if (b > a && overlaps(proxies[a], proxies[b]))
+                        {
+                            BroadphasePair pair;
+                            pair.a = a;
+                            pair.b = b;
+                            pairs.push_back(pair);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//=============================================================================
+// Sweep and prune along X
+// An entity crossing the left or right world edge is also added shifted by
+// the world width so pairs across the wrap are found. Pairs found twice
+// that way are removed.
+//=============================================================================
+void Broadphase::sweepPairs()
+{
+    int count = (int)proxies.size();
+    bool wrapped = false;
+
+    sweepList.clear();
+    for (int i=0; i<count; i++)
+    {
+        SweepEntry e;
+        e.minX = proxies[i].x - proxies[i].radius;
+        e.maxX = proxies[i].x + proxies[i].radius;
+        e.proxy = i;
+        sweepList.push_back(e);
+        if (e.minX < 0 || e.maxX > width)   // crosses an edge
+        {
+            float shift = (e.minX < 0) ? width : -width;
+            e.minX += shift;
+            e.maxX += shift;
+            sweepList.push_back(e);
+            wrapped = true;
+        }
+    }
+    std::sort(sweepList.begin(), sweepList.end(), sweepLess);
+
+    for (size_t i=0; i<sweepList.size(); i++)
+    {
+        for (size_t j=i+1; j<sweepList.size() && sweepList[j].minX <= sweepList[i].maxX; j++)
+        {
+            int a = sweepList[i].proxy;
+            int b = sweepList[j].proxy;
+            if (a == b || !overlaps(proxies[a], proxies[b]))
+                continue;
+            BroadphasePair pair;
+            pair.a = (a < b) ? a : b;
+            pair.b = (a < b) ? b : a;
+            pairs.push_back(pair);
+        }
+    }
+
+    if (wrapped)                    // remove pairs found twice
+    {
+        std::sort(pairs.begin(), pairs.end(), pairLess);
+        pairs.erase(std::unique(pairs.begin(), pairs.end(), pairEqual), pairs.end());
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef _BROADPHASE_H           // Prevent multiple definitions if this 
+#define _BROADPHASE_H           // file is included in more than one place
+
+#include <vector>
+
+// Broadphase collision culling
+// Entities are added as bounding circles each frame and findPairs() returns
+// only the pairs whose bounding boxes overlap. The exact test is still done
+// by Entity::collidesWith on the pairs returned.
+// The world wraps at its width and height, as ships do at the screen edge,
+// so entities close to opposite edges are reported as candidates.
+
+namespace broadphaseNS
+{
+    // GRID:  uniform grid of cells at least as large as the largest entity,
+    //        each entity is tested against its own and the 8 neighbour cells
+    // SWEEP: sort by left edge and test entities that overlap along X
+    enum METHOD {GRID, SWEEP};
+    const float DEFAULT_CELL_SIZE = 64;     // pixels
+}
+
+// Candidate pair, a and b are the indices returned by add(), a < b
+struct BroadphasePair
+{
+    int a, b;
+};
+
+class Broadphase
+{
+private:
+    struct Proxy                // entity bounds wrapped into the world
+    {
+        float x, y;             // center
+        float radius;           // bounding radius
+    };
+    struct SweepEntry
+    {
+        float minX, maxX;       // X extent, may be shifted by the world width
+        int   proxy;
+    };
+
+    std::vector<Proxy> proxies;
+    std::vector<BroadphasePair> pairs;
+    std::vector<int> cellStart;     // first cellItems entry of each cell, size cells+1
+    std::vector<int> cellItems;     // proxy indices ordered by cell
+    std::vector<int> proxyCell;     // cell of each proxy
+    std::vector<SweepEntry> sweepList;
+    float   width, height;      // world size
+    float   cellSize;           // minimum grid cell size
+    float   maxRadius;          // largest radius added since clear()
+    int     method;
+
+    // Return true if a is left of b on the sweep list
+    static bool sweepLess(const SweepEntry &a, const SweepEntry &b);
+    // Return true if the bounding boxes overlap, measured across the wrap
+    bool overlaps(const Proxy &a, const Proxy &b) const;
+    void gridPairs();
+    void sweepPairs();
+
+public:
+    // Constructor
+    Broadphase();
+
+    // Set world size, method and grid cell size
+    // Pre: worldWidth, worldHeight = size where entities wrap around
+    //      method = broadphaseNS::GRID or SWEEP
+    //      cell = minimum grid cell size in pixels
+    void initialize(float worldWidth, float worldHeight,
+                    int method = broadphaseNS::GRID,
+                    float cell = broadphaseNS::DEFAULT_CELL_SIZE);
+
+    // Remove all entities, call at the start of each collision pass
+    void clear();
+
+    // Add an entity by the center and radius of its bounding circle.
+    // Returns the index used in BroadphasePair.
+    int add(float x, float y, float radius);
+
+    // Return every pair of added entities that may collide
+    const std::vector<BroadphasePair>& findPairs();
+
+    // Return number of entities added since clear()
+    int getCount()          {return (int)proxies.size();}
+
+    // Select broadphaseNS::GRID or SWEEP
+    void setMethod(int m)   {method = m;}
+    int  getMethod()        {return method;}
+};
+
+#endif
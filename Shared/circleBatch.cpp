@@ -0,0 +1,96 @@
+#include <string.h>
+#include "circleBatch.h"
+using namespace circleBatchNS;
+
+//=============================================================================
+// Remove all circles
+//=============================================================================
+void CircleBatch::clear()
+{
+    x.clear();
+    y.clear();
+    radius.clear();
+}
+
+//=============================================================================
+// Add a circle
+//=============================================================================
+int CircleBatch::add(float cx, float cy, float r)
+{
+    x.push_back(cx);
+    y.push_back(cy);
+    radius.push_back(r);
+    return (int)x.size() - 1;
+}
+
+//=============================================================================
+// Test one circle against the batch
+// Each block of LANES circles is tested at once and the lane results are
+// written to hitMask as bits. Collision vectors are only computed for hits,
+// which are rare compared to the number of circles tested.
+//=============================================================================
+int CircleBatch::collide(float cx, float cy, float r,
+                         unsigned int *hitMask, VECTOR2 *collisionVector) const
+{
+    const int count = getCount();
+    memset(hitMask, 0, getMaskWords() * sizeof(unsigned int));
+    int i = 0;
+
+#if defined(SIMD_AVX2)
+    const __m256 px = _mm256_set1_ps(cx);
+    const __m256 py = _mm256_set1_ps(cy);
+    const __m256 pr = _mm256_set1_ps(r);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&x[i]), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&y[i]), py);
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(&radius[i]), pr);
+        __m256 dist = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        unsigned int bits = (unsigned int)_mm256_movemask_ps(
+                                _mm256_cmp_ps(dist, _mm256_mul_ps(sum, sum), _CMP_LE_OQ));
+        hitMask[i / MASK_BITS] |= bits << (i % MASK_BITS);
+    }
+#elif defined(SIMD_SSE2)
+    const __m128 px = _mm_set1_ps(cx);
+    const __m128 py = _mm_set1_ps(cy);
+    const __m128 pr = _mm_set1_ps(r);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&x[i]), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&y[i]), py);
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(&radius[i]), pr);
+        __m128 dist = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        unsigned int bits = (unsigned int)_mm_movemask_ps(
+                                _mm_cmple_ps(dist, _mm_mul_ps(sum, sum)));
+        hitMask[i / MASK_BITS] |= bits << (i % MASK_BITS);
+    }
+#endif
+
+    // scalar fallback and the circles left over after the last full block
+    for (; i < count; i++)
+    {
+        float dx = x[i] - cx;
+        float dy = y[i] - cy;
+        float sum = radius[i] + r;
+        if (dx*dx + dy*dy <= sum*sum)
+            hitMask[i / MASK_BITS] |= 1u << (i % MASK_BITS);
+    }
+
+    // collision vectors for the hits
+    int hits = 0;
+    for (int word = 0; word < getMaskWords(); word++)
+    {
+        unsigned int bits = hitMask[word];
+        while (bits)
+        {
+            int bit = 0;
+            while (!(bits & (1u << bit)))
+                bit++;
+            bits &= bits - 1;               // clear lowest set bit
+            int n = word * MASK_BITS + bit;
+            collisionVector[n] = VECTOR2(x[n] - cx, y[n] - cy);
+            hits++;
+        }
+    }
+    return hits;
+}
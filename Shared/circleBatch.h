@@ -0,0 +1,49 @@
+#ifndef _CIRCLEBATCH_H          // Prevent multiple definitions if this 
+#define _CIRCLEBATCH_H          // file is included in more than one place
+
+#include <vector>
+#include "vector2.h"
+#include "simd.h"
+
+// Batched circle collision
+// Circles are packed into separate x, y and radius arrays so one entity can
+// be tested against all of them several lanes at a time. The test is the
+// same as Entity::collideCircle but collide() is const and uses no member
+// scratch fields, so one batch may be tested from several threads.
+// See simd.h for the instruction sets used.
+
+namespace circleBatchNS
+{
+    const int MASK_BITS = 32;       // circles per hitMask word
+}
+
+class CircleBatch
+{
+private:
+    std::vector<float> x, y;        // circle centers
+    std::vector<float> radius;      // collision radius, already scaled
+
+public:
+    // Remove all circles
+    void clear();
+
+    // Add a circle. Returns its index in the batch.
+    int add(float cx, float cy, float r);
+
+    // Number of circles in the batch
+    int getCount() const        {return (int)x.size();}
+
+    // Number of hitMask words needed by collide()
+    int getMaskWords() const    {return (getCount() + circleBatchNS::MASK_BITS - 1) / circleBatchNS::MASK_BITS;}
+
+    // Test the circle at (cx,cy) with radius r against every circle in the batch.
+    // Pre: hitMask has getMaskWords() entries
+    //      collisionVector has getCount() entries
+    // Post: bit i%32 of hitMask[i/32] is set if circle i collides
+    //       collisionVector[i] = circle i center - (cx,cy), set for hits only
+    //       returns number of hits
+    int collide(float cx, float cy, float r,
+                unsigned int *hitMask, VECTOR2 *collisionVector) const;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include <math.h>
+#include "gravityBatch.h"
+using namespace gravityBatchNS;
+
+// One register of bodies, 8 with AVX2 and 4 with SSE2, so the kernel in
+// directStep is written once for both
+#if defined(SIMD_AVX2)
+typedef __m256 Lanes;
+static inline Lanes setLanes(float a)               {return _mm256_set1_ps(a);}
+static inline Lanes loadLanes(const float *p)       {return _mm256_loadu_ps(p);}
+static inline void  storeLanes(float *p, Lanes a)   {_mm256_storeu_ps(p, a);}
+static inline Lanes addLanes(Lanes a, Lanes b)      {return _mm256_add_ps(a, b);}
+static inline Lanes subLanes(Lanes a, Lanes b)      {return _mm256_sub_ps(a, b);}
+static inline Lanes mulLanes(Lanes a, Lanes b)      {return _mm256_mul_ps(a, b);}
+static inline Lanes rsqrtLanes(Lanes a)             {return _mm256_rsqrt_ps(a);}
+// a where b > 0, else 0
+static inline Lanes positiveLanes(Lanes a, Lanes b)
+{
+    return _mm256_and_ps(a, _mm256_cmp_ps(b, _mm256_setzero_ps(), _CMP_GT_OQ));
+}
+#elif defined(SIMD_SSE2)
+typedef __m128 Lanes;
+static inline Lanes setLanes(float a)               {return _mm_set1_ps(a);}
+static inline Lanes loadLanes(const float *p)       {return _mm_loadu_ps(p);}
+static inline void  storeLanes(float *p, Lanes a)   {_mm_storeu_ps(p, a);}
+static inline Lanes addLanes(Lanes a, Lanes b)      {return _mm_add_ps(a, b);}
+static inline Lanes subLanes(Lanes a, Lanes b)      {return _mm_sub_ps(a, b);}
+static inline Lanes mulLanes(Lanes a, Lanes b)      {return _mm_mul_ps(a, b);}
+static inline Lanes rsqrtLanes(Lanes a)             {return _mm_rsqrt_ps(a);}
+// a where b > 0, else 0
+static inline Lanes positiveLanes(Lanes a, Lanes b)
+{
+    return _mm_and_ps(a, _mm_cmpgt_ps(b, _mm_setzero_ps()));
+}
+#endif
+
+//=============================================================================
+// Constructor
+//=============================================================================
+GravityBatch::GravityBatch()
+{
+    mutual = false;
+    theta = DEFAULT_THETA;
+    treeThreshold = DEFAULT_TREE_THRESHOLD;
+    usedTree = false;
+}
+
+//=============================================================================
+// Remove all bodies
+//=============================================================================
+void GravityBatch::clear()
+{
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    gm.clear();
+    m.clear();
+}
+
+//=============================================================================
+// Remove all planets
+//=============================================================================
+void GravityBatch::clearPlanets()
+{
+    px.clear();
+    py.clear();
+    pm.clear();
+}
+
+//=============================================================================
+// Add a moving body
+//=============================================================================
+int GravityBatch::add(float cx, float cy, float velX, float velY, float gravity, float mass)
+{
+    x.push_back(cx);
+    y.push_back(cy);
+    vx.push_back(velX);
+    vy.push_back(velY);
+    gm.push_back(gravity * mass);
+    m.push_back(mass);
+    return (int)x.size() - 1;
+}
+
+//=============================================================================
+// Add a planet
+//=============================================================================
+void GravityBatch::addPlanet(float cx, float cy, float mass)
+{
+    px.push_back(cx);
+    py.push_back(cy);
+    pm.push_back(mass);
+}
+
+//=============================================================================
+// Apply gravity to the bodies added to the batch
+//=============================================================================
+void GravityBatch::step(float frameTime)
+{
+    if (getCount() == 0)
+        return;
+    Bodies b = {&x[0], &y[0], &vx[0], &vy[0], &gm[0], &m[0], getCount()};
+    run(b, frameTime);
+}
+
+//=============================================================================
+// Apply gravity to bodies held by the caller
+//=============================================================================
+void GravityBatch::pull(const float *bodyX, const float *bodyY, float *velX, float *velY,
+                        const float *bodyGM, const float *bodyMass, int count, float frameTime)
+{
+    Bodies b = {bodyX, bodyY, velX, velY, bodyGM, bodyMass, count};
+    run(b, frameTime);
+}
+
+//=============================================================================
+// Apply gravity
+// Sources are the planets, followed by the bodies when gravity is mutual.
+//=============================================================================
+void GravityBatch::run(const Bodies &b, float frameTime)
+{
+    const float *srcX = px.empty() ? 0 : &px[0];
+    const float *srcY = py.empty() ? 0 : &py[0];
+    const float *srcMass = pm.empty() ? 0 : &pm[0];
+    int sources = (int)pm.size();
+    if (mutual && b.count > 0)
+    {
+        sx = px;
+        sy = py;
+        sm = pm;
+        sx.insert(sx.end(), b.x, b.x + b.count);
+        sy.insert(sy.end(), b.y, b.y + b.count);
+        sm.insert(sm.end(), b.m, b.m + b.count);
+        srcX = &sx[0];
+        srcY = &sy[0];
+        srcMass = &sm[0];
+        sources = (int)sm.size();
+    }
+
+    usedTree = sources > treeThreshold;
+    if (usedTree)
+        treeStep(b, srcX, srcY, srcMass, sources, frameTime);
+    else
+        directStep(b, srcX, srcY, srcMass, sources, frameTime);
+}
+
+//=============================================================================
+// Barnes-Hut gravity, one body at a time
+//=============================================================================
+void GravityBatch::treeStep(const Bodies &b, const float *srcX, const float *srcY,
+                            const float *srcMass, int sources, float frameTime)
+{
+    tree.build(srcX, srcY, srcMass, sources);
+    for (int i=0; i<b.count; i++)
+    {
+        float ax, ay;
+        tree.pull(b.x[i], b.y[i], theta, ax, ay);
+        b.vx[i] += ax * b.gm[i] * frameTime;
+        b.vy[i] += ay * b.gm[i] * frameTime;
+    }
+}
+
+//=============================================================================
+// Sum every source
+// Each lane is one body; the sources are looped over inside, so the
+// velocities are loaded and stored once per step.
+// A source at the exact center of a body, including the body itself,
+// does not pull it.
+//=============================================================================
+void GravityBatch::directStep(const Bodies &b, const float *srcX, const float *srcY,
+                              const float *srcMass, int sources, float frameTime)
+{
+    const int count = b.count;
+    int i = 0;
+
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+    const Lanes half = setLanes(0.5f);
+    const Lanes threeHalves = setLanes(1.5f);
+    const Lanes zero = setLanes(0);
+    for (; i + simdNS::LANES <= count; i += simdNS::LANES)
+    {
+        Lanes posX = loadLanes(&b.x[i]);
+        Lanes posY = loadLanes(&b.y[i]);
+        Lanes scale = mulLanes(loadLanes(&b.gm[i]), setLanes(frameTime));
+        Lanes dvx = zero, dvy = zero;
+        for (int p=0; p<sources; p++)
+        {
+            Lanes dx = subLanes(setLanes(srcX[p]), posX);
+            Lanes dy = subLanes(setLanes(srcY[p]), posY);
+            Lanes rr = addLanes(mulLanes(dx, dx), mulLanes(dy, dy));
+            // 1/r, refined once: r' = r * (1.5 - 0.5 * rr * r * r)
+            Lanes inv = rsqrtLanes(rr);
+            inv = mulLanes(inv, subLanes(threeHalves, mulLanes(mulLanes(half, rr), mulLanes(inv, inv))));
+            // M / r^3, zero where rr == 0
+            Lanes k = mulLanes(setLanes(srcMass[p]), mulLanes(inv, mulLanes(inv, inv)));
+            k = positiveLanes(k, rr);
+            dvx = addLanes(dvx, mulLanes(dx, k));
+            dvy = addLanes(dvy, mulLanes(dy, k));
+        }
+        storeLanes(&b.vx[i], addLanes(loadLanes(&b.vx[i]), mulLanes(dvx, scale)));
+        storeLanes(&b.vy[i], addLanes(loadLanes(&b.vy[i]), mulLanes(dvy, scale)));
+    }
+#endif
+
+    // scalar fallback and the bodies left over after the last full block
+    for (; i < count; i++)
+    {
+        float dvx = 0, dvy = 0;
+        for (int p=0; p<sources; p++)
+        {
+            float dx = srcX[p] - b.x[i];
+            float dy = srcY[p] - b.y[i];
+            float rr = dx*dx + dy*dy;
+            if (rr <= 0)
+                continue;
+            float inv = 1.0f / sqrtf(rr);
+            float k = srcMass[p] * inv * inv * inv;
+            dvx += dx * k;
+            dvy += dy * k;
+        }
+        b.vx[i] += dvx * b.gm[i] * frameTime;
+        b.vy[i] += dvy * b.gm[i] * frameTime;
+    }
+}
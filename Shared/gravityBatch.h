@@ -0,0 +1,117 @@
+#ifndef _GRAVITYBATCH_H         // Prevent multiple definitions if this 
+#define _GRAVITYBATCH_H         // file is included in more than one place
+
+#include <vector>
+#include "simd.h"
+#include "gravityTree.h"
+
+// Batched gravity
+// Does the same as calling Entity::gravityForce for every moving body
+// against every planet, with the bodies in separate arrays so several are
+// updated at once. 1/r is taken from the rsqrt estimate refined with one
+// Newton-Raphson step, which is accurate to about 1 part in 10^7.
+// See simd.h for the instruction sets used.
+//
+//   velocity += gravity * mass * planetMass / r^2 * (planet - center) / r * frameTime
+//
+// With mutual gravity on, every body also pulls every other body by its own
+// mass. Once the number of sources passes the tree threshold the pull is
+// taken from a Barnes-Hut tree instead of summing every source.
+
+namespace gravityBatchNS
+{
+    const float DEFAULT_THETA = 0.5f;       // Barnes-Hut opening angle
+    const int   DEFAULT_TREE_THRESHOLD = 2048;  // sources before the tree is used
+}
+
+// Fixed source of gravity, such as a planet or a gravity well
+struct GravitySource
+{
+    float x, y;         // center
+    float mass;
+};
+
+class GravityBatch
+{
+private:
+    std::vector<float> x, y;        // body centers
+    std::vector<float> vx, vy;      // body velocities, updated by step()
+    std::vector<float> gm;          // gravity * mass of each body
+    std::vector<float> m;           // mass of each body, used by mutual gravity
+    std::vector<float> px, py;      // planet centers
+    std::vector<float> pm;          // planet masses
+    std::vector<float> sx, sy, sm;  // planets followed by bodies, for mutual gravity
+    GravityTree tree;
+    bool    mutual;                 // bodies attract each other
+    float   theta;                  // Barnes-Hut opening angle
+    int     treeThreshold;          // sources before the tree is used
+    bool    usedTree;               // true if the last step used the tree
+
+    // Bodies being pulled, either the batch's own or the caller's arrays
+    struct Bodies
+    {
+        const float *x, *y;
+        float       *vx, *vy;
+        const float *gm, *m;
+        int         count;
+    };
+
+    // Pull bodies b by the planets, and by each other if mutual
+    void run(const Bodies &b, float frameTime);
+    // Add the pull of count sources directly
+    void directStep(const Bodies &b, const float *srcX, const float *srcY,
+                    const float *srcMass, int sources, float frameTime);
+    // Add the pull of count sources from the tree
+    void treeStep(const Bodies &b, const float *srcX, const float *srcY,
+                  const float *srcMass, int sources, float frameTime);
+
+public:
+    // Constructor
+    GravityBatch();
+
+    // Remove all bodies
+    void clear();
+
+    // Remove all planets
+    void clearPlanets();
+
+    // Add a moving body. Returns its index.
+    // gravity = gravitational constant of the body, Entity::getGravity()
+    int add(float cx, float cy, float velX, float velY, float gravity, float mass);
+
+    // Add a planet that attracts every body
+    void addPlanet(float cx, float cy, float mass);
+
+    // Add the pull of every planet, and of every body if mutual, to the
+    // velocity of every body
+    void step(float frameTime);
+
+    // Same as step() for count bodies kept in the caller's arrays.
+    // A body with gm = 0 is not pulled, one with mass = 0 does not pull.
+    void pull(const float *bodyX, const float *bodyY, float *velX, float *velY,
+              const float *bodyGM, const float *bodyMass, int count, float frameTime);
+
+    // Bodies attract each other when on
+    void  setMutual(bool on)        {mutual = on;}
+    bool  getMutual() const         {return mutual;}
+
+    // Barnes-Hut opening angle, smaller is more accurate and slower
+    void  setTheta(float t)         {theta = t;}
+    float getTheta() const          {return theta;}
+
+    // Number of sources (planets plus mutual bodies) above which the tree is used
+    void  setTreeThreshold(int n)   {treeThreshold = n;}
+    int   getTreeThreshold() const  {return treeThreshold;}
+
+    // Return true if the last step() used the tree
+    bool  getUsedTree() const       {return usedTree;}
+
+    // Number of bodies
+    int   getCount() const          {return (int)x.size();}
+
+    // Velocity of body i after step()
+    float getVelocityX(int i) const {return vx[i];}
+    float getVelocityY(int i) const {return vy[i];}
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include <math.h>
+#include <algorithm>
+#include "gravityTree.h"
+using namespace gravityTreeNS;
+
+//=============================================================================
+// Constructor
+//=============================================================================
+GravityTree::GravityTree() : sx(0), sy(0), sm(0)
+{}
+
+//=============================================================================
+// Build the tree
+//=============================================================================
+void GravityTree::build(const float *x, const float *y, const float *mass, int count)
+{
+    sx = x;
+    sy = y;
+    sm = mass;
+    nodes.clear();
+    order.resize(count);
+    if (count == 0)
+        return;
+
+    float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+    for (int i=0; i<count; i++)
+    {
+        order[i] = i;
+        minX = std::min(minX, x[i]);
+        maxX = std::max(maxX, x[i]);
+        minY = std::min(minY, y[i]);
+        maxY = std::max(maxY, y[i]);
+    }
+    Node root;
+    root.x0 = minX;
+    root.y0 = minY;
+    root.size = std::max(maxX - minX, maxY - minY) * 1.0001f + 1e-3f;
+    root.first = 0;
+    root.count = count;
+    nodes.push_back(root);
+    split(0, 0);
+
+    ox.resize(count);
+    oy.resize(count);
+    om.resize(count);
+    for (int i=0; i<count; i++)
+    {
+        ox[i] = x[order[i]];
+        oy[i] = y[order[i]];
+        om[i] = mass[order[i]];
+    }
+}
+
+//=============================================================================
+// Set the mass of node and split it into quadrants if it holds too many sources
+//=============================================================================
+void GravityTree::split(int node, int depth)
+{
+    Node &n = nodes[node];
+    n.child = -1;
+    n.mass = 0;
+    float mx = 0, my = 0;
+    for (int i=n.first; i<n.first+n.count; i++)
+    {
+        n.mass += sm[order[i]];
+        mx += sm[order[i]] * sx[order[i]];
+        my += sm[order[i]] * sy[order[i]];
+    }
+    if (n.mass > 0)
+    {
+        n.cx = mx / n.mass;
+        n.cy = my / n.mass;
+    }
+    else
+    {
+        n.cx = n.x0 + n.size/2;
+        n.cy = n.y0 + n.size/2;
+    }
+    if (n.count <= LEAF_SIZE || depth >= MAX_DEPTH)
+        return;
+
+    // Group order[] by quadrant: top left, top right, bottom left, bottom right
+    const float midX = n.x0 + n.size/2;
+    const float midY = n.y0 + n.size/2;
+    const int   first = n.first;
+    const float x0 = n.x0, y0 = n.y0, half = n.size/2;
+    int *begin = &order[first];
+    int *end = begin + n.count;
+    const float *px = sx, *py = sy;
+    int *bottom = std::partition(begin, end, [=](int i) {return py[i] < midY;});
+    int *topRight = std::partition(begin, bottom, [=](int i) {return px[i] < midX;});
+    int *bottomRight = std::partition(bottom, end, [=](int i) {return px[i] < midX;});
+    int *bounds[5] = {begin, topRight, bottom, bottomRight, end};
+
+    int child = (int)nodes.size();
+    nodes[node].child = child;      // n may move when nodes grows
+    for (int q=0; q<4; q++)
+    {
+        Node c;
+        c.x0 = x0 + ((q & 1) ? half : 0);
+        c.y0 = y0 + ((q & 2) ? half : 0);
+        c.size = half;
+        c.first = first + (int)(bounds[q] - begin);
+        c.count = (int)(bounds[q+1] - bounds[q]);
+        nodes.push_back(c);
+    }
+    for (int q=0; q<4; q++)
+        split(child + q, depth + 1);
+}
+
+//=============================================================================
+// Pull of all sources on the point (x,y)
+// A node is used as one source when size/distance < theta and the point is
+// outside it, otherwise its children are visited. Leaves are summed exactly.
+//=============================================================================
+void GravityTree::pull(float x, float y, float theta, float &ax, float &ay) const
+{
+    ax = 0;
+    ay = 0;
+    if (nodes.empty())
+        return;
+
+    int stack[3*MAX_DEPTH + 4];
+    int top = 0;
+    stack[top++] = 0;
+    const float theta2 = theta * theta;
+    while (top > 0)
+    {
+        const Node &n = nodes[stack[--top]];
+        if (n.mass <= 0)
+            continue;
+        if (n.child < 0)                // leaf
+        {
+            for (int i=n.first; i<n.first+n.count; i++)
+            {
+                float dx = ox[i] - x;
+                float dy = oy[i] - y;
+                float rr = dx*dx + dy*dy;
+                if (rr <= 0)
+                    continue;
+                float k = om[i] / (rr * sqrtf(rr));
+                ax += dx * k;
+                ay += dy * k;
+            }
+            continue;
+        }
+        float dx = n.cx - x;
+        float dy = n.cy - y;
+        float rr = dx*dx + dy*dy;
+        bool inside = x >= n.x0 && x < n.x0 + n.size && y >= n.y0 && y < n.y0 + n.size;
+        if (!inside && n.size * n.size < theta2 * rr)
+        {
+            float k = n.mass / (rr * sqrtf(rr));
+            ax += dx * k;
+            ay += dy * k;
+        }
+        else
+            for (int q=0; q<4; q++)
+                stack[top++] = n.child + q;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef _GRAVITYTREE_H          // Prevent multiple definitions if this 
+#define _GRAVITYTREE_H          // file is included in more than one place
+
+#include <vector>
+
+// Barnes-Hut quadtree of gravity sources
+// Each node stores the total mass and center of mass of the sources inside
+// it. pull() treats a node as a single source when its size seen from the
+// query point is below theta, so a body is pulled by n sources in about
+// log(n) steps instead of n. theta = 0 visits every source.
+
+namespace gravityTreeNS
+{
+    const int LEAF_SIZE = 8;        // sources in a leaf before it is split
+    const int MAX_DEPTH = 24;       // coincident sources stay in one leaf
+}
+
+class GravityTree
+{
+private:
+    struct Node
+    {
+        float x0, y0, size;     // square bounds
+        float cx, cy;           // center of mass
+        float mass;             // total mass
+        int   child;            // first of 4 children, -1 for a leaf
+        int   first, count;     // range of order[] held by the node
+    };
+    std::vector<Node> nodes;
+    std::vector<int>  order;    // source indices grouped by node
+    std::vector<float> ox, oy, om;  // sources copied in order[], read by leaves
+    const float *sx, *sy, *sm;  // sources passed to build()
+
+    void split(int node, int depth);
+
+public:
+    // Constructor
+    GravityTree();
+
+    // Build the tree over count sources
+    // Pre: x, y, mass stay valid until the next build()
+    void build(const float *x, const float *y, const float *mass, int count);
+
+    // Sum of mass * (source - point) / r^3 over all sources.
+    // Sources at the exact query point are skipped.
+    void pull(float x, float y, float theta, float &ax, float &ay) const;
+
+    // Number of nodes in the tree
+    int getNodeCount() const    {return (int)nodes.size();}
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "protocol.h"
+#include "bitStream.h"
+using namespace messageNS;
+
+//=============================================================================
+// Write data as TO_SERVER_SIZE bytes, the header first as in every packet
+//=============================================================================
+void writeToServer(const ToServerStc &data, char *buffer)
+{
+    PacketLink::writeHeader(data.header, buffer);
+    BitWriter out(buffer + packetLinkNS::HEADER_SIZE, TO_SERVER_SIZE - packetLinkNS::HEADER_SIZE);
+    out.write(data.token, TOKEN_BITS);
+    out.write(data.playerN, PLAYER_BITS);
+    out.write(data.buttons, BUTTON_BITS);
+    out.write(data.ack, ACK_BITS);
+    out.write(data.delay, DELAY_BITS);
+}
+
+//=============================================================================
+// Read a ToServerStc written by writeToServer
+//=============================================================================
+bool readToServer(const char *buffer, int size, ToServerStc &data)
+{
+    if (size < TO_SERVER_SIZE)
+        return false;
+    PacketLink::readHeader(buffer, size, data.header);
+    BitReader in(buffer + packetLinkNS::HEADER_SIZE, TO_SERVER_SIZE - packetLinkNS::HEADER_SIZE);
+    data.token = in.read(TOKEN_BITS);
+    data.playerN = (UCHAR)in.read(PLAYER_BITS);
+    data.buttons = (UCHAR)in.read(BUTTON_BITS);
+    data.ack = (USHORT)in.read(ACK_BITS);
+    data.delay = (USHORT)in.read(DELAY_BITS);
+    return true;
+}
+
+//=============================================================================
+// Write data as CONNECT_RESPONSE_SIZE bytes
+// The response is padded with zeros after its terminator.
+//=============================================================================
+void writeConnectResponse(const ConnectResponse &data, char *buffer)
+{
+    BitWriter out(buffer, CONNECT_RESPONSE_SIZE);
+    bool ended = false;
+    for (int i=0; i<netNS::RESPONSE_SIZE; i++)
+    {
+        ended = ended || data.response[i] == '\0';
+        out.write(ended ? 0 : (UCHAR)data.response[i], 8);
+    }
+    out.write(data.number, PLAYER_BITS);
+    out.write(data.token, TOKEN_BITS);
+}
+
+//=============================================================================
+// Read a ConnectResponse written by writeConnectResponse
+//=============================================================================
+bool readConnectResponse(const char *buffer, int size, ConnectResponse &data)
+{
+    if (size < CONNECT_RESPONSE_SIZE)
+        return false;
+    BitReader in(buffer, CONNECT_RESPONSE_SIZE);
+    for (int i=0; i<netNS::RESPONSE_SIZE; i++)
+        data.response[i] = (char)in.read(8);
+    data.response[netNS::RESPONSE_SIZE-1] = '\0';   // a corrupt one still ends
+    data.number = (UCHAR)in.read(PLAYER_BITS);
+    data.token = in.read(TOKEN_BITS);
+    return true;
+}
@@ -0,0 +1,370 @@
+#ifndef _PROTOCOL_H             // Prevent multiple definitions if this 
+#define _PROTOCOL_H             // file is included in more than one place
+
+#include <vector>
+#include "net.h"
+#include "packetLink.h"
+#include "vector2.h"
+
+// The messages between the Spacewar clients and servers
+// One copy for every project, a client and a server built from this
+// tree always agree on the wire format.
+
+#ifndef _WIN32
+typedef unsigned int    UINT;
+typedef unsigned char   UCHAR;
+#endif
+
+namespace spacewarNS
+{
+    const int MAX_PLAYERS = 64;     // maximum number of players in a match
+    const int PLAYER_TORPEDOS = 8;  // most torpedos one player has in flight
+    const int MAX_TORPEDOS = MAX_PLAYERS*PLAYER_TORPEDOS;   // most in flight in a match
+    const int LEFT_BIT = 0x01;      // player buttons
+    const int FORWARD_BIT = 0x02;
+    const int RIGHT_BIT = 0x04;
+    const int FIRE_BIT = 0x08;
+    // ShipStc flags, not the same bits as the headless World's flags
+    const int SHIP_ACTIVE_BIT = 0x01;       // player is active
+    const int SHIP_ENGINE_BIT = 0x02;       // engine on
+    const int SHIP_SHIELD_BIT = 0x04;       // shield on
+    const int SHIP_CONNECTED_BIT = 0x08;    // a player has joined
+    // Game State bits
+    const int ROUND_START_BIT = 0x01;
+    // Gravity bits
+    const int GRAVITY_ON_BIT = 0x01;        // planet and wells pull, none do if off
+    const int MUTUAL_GRAVITY_BIT = 0x02;    // ships and torpedos pull each other
+    const int MAX_WELLS = 8;                // most gravity wells besides the planet
+    // Network, sounds for client to play
+    const int ENGINE1_BIT       = 0x01; // Bit 0 = engine1      1=on, 0=off
+    const int ENGINE2_BIT       = 0x02; // Bit 1 = engine2      1=on, 0=off
+    const int CHEER_BIT         = 0x04; // Bit 2 = cheer        state change
+    const int COLLIDE_BIT       = 0x08; // Bit 3 = collide      state change
+    const int EXPLODE_BIT       = 0x10; // Bit 4 = explode      state change
+    const int TORPEDO_CRASH_BIT = 0x20; // Bit 5 = torpedoCrash state change
+    const int TORPEDO_FIRE_BIT  = 0x40; // Bit 6 = torpedoFire  state change
+    const int TORPEDO_HIT_BIT   = 0x80; // Bit 7 = torpedoHit   state change
+}
+
+// ShipStc contains all of the information a network client needs for a ship.
+struct ShipStc 
+{
+    float X;
+    float Y;
+    float radians;
+    float health;
+    VECTOR2 velocity;
+    float rotation;             // rotation rate (radians/second)
+    short score;
+    UCHAR playerN;              // which player (255 is request to join)
+    UCHAR flags;                // SHIP_ACTIVE_BIT to SHIP_CONNECTED_BIT
+};
+
+// TorpedoStc contains all of the information a client needs for one torpedo.
+struct TorpedoStc 
+{
+    float X;
+    float Y;
+    VECTOR2 velocity;
+    bool  active;                       // true when active
+    USHORT id;                          // serial number the server gave it when fired
+    UCHAR owner;                        // player that fired it
+};
+
+//=============================================================================
+// network play structures
+//=============================================================================
+
+// Sent to client in response to connection request
+// Written by writeConnectResponse, see messageNS below.
+struct ConnectResponse
+{
+    char response[netNS::RESPONSE_SIZE];    // server response
+    UCHAR   number;                         // player number if connected
+    UINT    token;                          // session token if connected
+};
+
+// A gravity well, an invisible planet
+struct WellStc
+{
+    float x, y;                         // center
+    float mass;
+};
+
+// GravityStc is the gravity the server pulls the ships with, so a client
+// replays its own ship with the same pull.
+struct GravityStc
+{
+    UCHAR   flags;                      // GRAVITY_ON_BIT, MUTUAL_GRAVITY_BIT
+    UCHAR   wellCount;
+    WellStc well[spacewarNS::MAX_WELLS];
+};
+
+// Player describes the ship of one player, its torpedos are in ToClientStc.
+struct Player
+{
+    ShipStc     shipData;
+};
+
+// ToClientStc is the game state sent from the server to each client.
+// It is encoded by SnapshotHistory, see snapshotNS below; only the first
+// playerCount entries of player[] and torpedoCount of torpedo[] are sent.
+struct ToClientStc 
+{
+    // game state
+    // Bit 0 = roundStart
+    // Bits 1-7 reserved for future use
+    UCHAR   gameState;
+    // sound to play   
+    // Bit 0 = cheer        state change
+    // Bit 1 = collide      state change
+    // Bit 2 = explode      state change
+    // Bit 3 = engine1      1=on, 0=off
+    // Bit 4 = engine2      1=on, 0=off
+    // Bit 5 = torpedoCrash state change
+    // Bit 6 = torpedoFire  state change
+    // Bit 7 = torpedoHit   state change
+    UCHAR   sounds;
+    UCHAR   playerCount;        // number of players in the match
+    GravityStc gravity;
+    Player  player[spacewarNS::MAX_PLAYERS];
+    // torpedos in flight, any order, at most PLAYER_TORPEDOS per player
+    int     torpedoCount;
+    TorpedoStc torpedo[spacewarNS::MAX_TORPEDOS];
+};
+
+//=============================================================================
+// Wire format of ToClientStc
+// A change to the format needs new netNS::CLIENT_ID and SERVER_ID strings.
+// Each packet to a client is a PacketHeader, written by
+// PacketLink::writeHeader, the sequence of the newest input applied to the
+// client's ship when the snapshot was taken (16 bits, 0 for none), then
+// one snapshot. The client replays its later input on top of it.
+// Written with BitWriter, so it is little-endian and does not depend on the
+// layout of the structures. Every value is sent as a fixed point number,
+// see SnapshotPlayer and SnapshotTorpedo.
+//   sequence 16, playerCount 7, gameState 8, sounds 8,
+//   delta 1 and, for a delta, baseline offset 5 and elapsed ms 12,
+//   or for a full snapshot the server time in ms 32,
+//   for a delta gravity changed 1, and for a full snapshot or if changed
+//   gravity flags 2, well count 4 and each well's x, y and mass as 32 bit
+//   IEEE floats, so the client pulls its ship exactly as the server does
+// then for each player in a full snapshot
+//   ship flags 4 and, for an active or connected ship, the ship fields
+// or in a delta snapshot
+//   changed 1, and if changed
+//   flags 0 if unchanged or 1 and flags 4, then each ship field as a delta
+//   against the baseline.
+// Then the torpedos. A snapshot holds them in id order. For each torpedo of
+// the baseline, none for a full snapshot,
+//   kept 1, and if kept, changed 1 and if changed each torpedo field as a delta
+// then the count of torpedos not in the baseline 10 and for each, in id order,
+//   id 16 for the first or an Exp-Golomb code of the gap from the one
+//   before, owner 6 and the torpedo fields.
+// Velocity and rotation come first, then positions are predicted from the
+// baseline position moving at the average of the baseline and new
+// velocities over the elapsed time, and headings likewise from the
+// rotations, so a ship coasting or in orbit sends only how far it strayed.
+// A field delta is 0 for no change from the prediction, or 1 and a signed
+// Exp-Golomb code of the change; health and score are sent whole instead.
+// Sequence 0 is never used, a client that has no snapshot acks 0.
+// playerN is not sent, it is the player's index.
+//=============================================================================
+namespace snapshotNS
+{
+    // positions, ships and torpedos wrap at -32 and GAME_WIDTH or GAME_HEIGHT
+    const float POSITION_MIN = -64;
+    const float POSITION_STEP = 1.0f/8;     // pixels
+    const int   POSITION_BITS = 13;         // -64 to 960
+    const int   ANGLE_BITS = 10;            // 0 to 2 PI, about 0.35 degrees
+    const float HEALTH_STEP = 1;
+    const int   HEALTH_BITS = 7;            // 0 to 127
+    const float VELOCITY_MIN = -1024;       // ships are held under shipNS::MAX_SPEED
+    const float VELOCITY_STEP = 1.0f/4;     // pixels/second
+    const int   VELOCITY_BITS = 13;         // -1024 to 1024
+    const int   POSITION_PER_VELOCITY = 2;  // position steps moved in 1s at 1 velocity step
+    const float ROTATION_MIN = -16;
+    const float ROTATION_STEP = 1.0f/64;    // radians/second
+    const int   ROTATION_BITS = 11;         // -16 to 16
+    // heading steps turned in 1ms at 1 rotation step, times 10^9
+    const long long ANGLE_PER_ROTATION = 2546479;
+    const int   SCORE_BITS = 16;
+    const int   FLAG_BITS = 4;              // ShipStc flags bits 0-3
+    const int   SHIP_FIELDS = 8;            // velocity x, y, rotation, X, Y, angle, health, score
+    const int   TORPEDO_FIELDS = 4;         // velocity x, y, X, Y
+    const int   SHIP_FIELD_BITS = 2*POSITION_BITS + ANGLE_BITS + HEALTH_BITS +
+                                  2*VELOCITY_BITS + ROTATION_BITS + SCORE_BITS;
+    const int   TORPEDO_FIELD_BITS = 2*POSITION_BITS + 2*VELOCITY_BITS;
+    const int   TORPEDO_ID_BITS = 16;
+    const int   OWNER_BITS = 6;             // player 0 to MAX_PLAYERS-1
+    const int   TORPEDO_COUNT_BITS = 10;    // 0 to MAX_TORPEDOS
+    // deltas
+    const int   HISTORY = 32;               // snapshots kept as baselines
+    const int   OFFSET_BITS = 5;            // baseline is 0 to HISTORY-1 snapshots back
+    const int   ELAPSED_BITS = 12;          // ms from baseline, older baselines are not used
+    const int   SEQUENCE_BITS = 16;
+    const int   TIME_BITS = 32;             // ms, a delta's time is its baseline's plus elapsed
+    // gravity
+    const int   GRAVITY_FLAG_BITS = 2;      // GRAVITY_ON_BIT, MUTUAL_GRAVITY_BIT
+    const int   WELL_COUNT_BITS = 4;        // 0 to MAX_WELLS
+    const int   WELL_BITS = 3*32;           // x, y, mass
+    const int   GRAVITY_BITS = 1 + GRAVITY_FLAG_BITS + WELL_COUNT_BITS +
+                               spacewarNS::MAX_WELLS*WELL_BITS;
+    // the larger of a full snapshot's time and a delta's offset and elapsed,
+    // and the gravity
+    const int   HEADER_BITS = SEQUENCE_BITS + 7 + 8 + 8 + 1 + TIME_BITS + GRAVITY_BITS;
+    // bytes of the largest snapshot, a delta with every field changed as far
+    // as it can and a full baseline of other torpedos, an Exp-Golomb code of
+    // a change is at most 2*bits+3
+    const int   MAX_SIZE = (HEADER_BITS + spacewarNS::MAX_PLAYERS*(1 + 1 + FLAG_BITS +
+                            4*SHIP_FIELDS + 2*SHIP_FIELD_BITS) + TORPEDO_COUNT_BITS +
+                            spacewarNS::MAX_TORPEDOS*(1 + 1 + 4*TORPEDO_FIELDS +
+                            2*TORPEDO_FIELD_BITS + 1 + 2*TORPEDO_ID_BITS + 3 + OWNER_BITS +
+                            TORPEDO_FIELD_BITS) + 7) / 8;
+    // bytes before the snapshot in a packet to a client, header and input
+    const int   PREFIX_SIZE = packetLinkNS::HEADER_SIZE + 2;
+    // bytes of the largest packet to a client
+    const int   MAX_PACKET_SIZE = PREFIX_SIZE + MAX_SIZE;
+}
+
+// One player of a snapshot in fixed point, as it is sent
+// Fields a ship does not send are 0.
+struct SnapshotPlayer
+{
+    UCHAR   flags;
+    USHORT  ship[snapshotNS::SHIP_FIELDS];
+};
+
+// One torpedo of a snapshot in fixed point, as it is sent
+struct SnapshotTorpedo
+{
+    USHORT  id;
+    UCHAR   owner;
+    USHORT  field[snapshotNS::TORPEDO_FIELDS];
+};
+
+//=============================================================================
+// The last HISTORY snapshots of a match, the baselines for delta snapshots.
+// The server adds one snapshot per frame and writes it for each client
+// against the newest snapshot that client has acknowledged, in full when
+// that one is no longer held. The client reads every snapshot and keeps
+// it so later deltas can be applied to it. See snapshot.cpp.
+//=============================================================================
+class SnapshotHistory
+{
+private:
+    // Everything but the players and torpedos of one snapshot
+    struct Frame
+    {
+        USHORT  sequence;           // 0 if the slot is empty
+        UINT    time;               // server time in ms
+        UCHAR   gameState;
+        UCHAR   sounds;
+        int     torpedoCount;
+        GravityStc gravity;
+    };
+    std::vector<Frame> frames;              // snapshot s is at s % HISTORY
+    std::vector<SnapshotPlayer> players;    // playerCount per frame
+    std::vector<SnapshotTorpedo> torpedos;  // torpedoLimit per frame, in id order
+    std::vector<SnapshotPlayer> decoded;    // read() decodes here first
+    std::vector<SnapshotTorpedo> decodedTorpedos;
+    int     playerCount;
+    int     torpedoLimit;           // PLAYER_TORPEDOS per player
+    USHORT  newest;                 // sequence of the newest snapshot, 0 if none
+
+    SnapshotPlayer *getPlayers(USHORT sequence) {return &players[(sequence % snapshotNS::HISTORY) * playerCount];}
+    SnapshotTorpedo *getTorpedos(USHORT sequence) {return &torpedos[(sequence % snapshotNS::HISTORY) * torpedoLimit];}
+
+    // Return the frame of sequence, NULL if it is not held
+    Frame *find(USHORT sequence);
+
+public:
+    // Constructor
+    SnapshotHistory();
+
+    // Forget all snapshots, each will have count players
+    void initialize(int count);
+
+    // Server: add data as the newest snapshot
+    // Pre: data.playerCount is the count passed to initialize, torpedos past
+    //      PLAYER_TORPEDOS per player are not sent
+    //      time = server time in ms
+    void add(const ToClientStc &data, UINT time);
+
+    // Server: write the newest snapshot as a delta against snapshot ack,
+    // or in full if ack is 0, too old or not held
+    // Pre: *buffer holds size bytes, MAX_SIZE is always enough
+    // Post: returns bytes written, 0 if buffer is too small or there is
+    //       no snapshot
+    int  write(USHORT ack, char *buffer, int size);
+
+    // Client: decode a snapshot of size bytes into data and keep it
+    // Post: returns false if the snapshot is malformed or is a delta against
+    //       a snapshot not held, data is then undefined
+    bool read(const char *buffer, int size, ToClientStc &data);
+
+    // Return the sequence of the newest snapshot, the client's ack
+    USHORT getNewest() const    {return newest;}
+
+    // Return the server time of snapshot sequence in ms, 0 if it is not held
+    UINT getTime(USHORT sequence);
+
+    // Return the server time of the newest snapshot in ms, 0 if there is none
+    UINT getNewestTime()        {return getTime(newest);}
+};
+
+// ToServerStc is the structure that is sent from the client to the server.
+// Written by writeToServer, see messageNS below.
+struct ToServerStc 
+{
+    UINT  token;        // session token from ConnectResponse, 0 to join
+    // current key presses
+    UCHAR buttons;      // bit 0=Left, 1=Forward, 2=Right, 3=Fire
+    UCHAR playerN;      // player number, 255 to join
+    USHORT ack;         // newest snapshot sequence received, 0 for none
+    USHORT delay;       // ms the client shows the other ships behind the server
+    PacketHeader header;    // sequence of this input, acks of the server's packets
+};
+
+//=============================================================================
+// Wire format of ToServerStc and ConnectResponse
+// Written with BitWriter like the snapshots, so neither depends on the
+// layout or byte order of the structures. See protocol.cpp.
+// ToServerStc
+//   PacketHeader written by PacketLink::writeHeader, token 32, playerN 8,
+//   buttons 4, ack 16, delay 10
+// ConnectResponse
+//   response RESPONSE_SIZE bytes, number 8, token 32
+//=============================================================================
+namespace messageNS
+{
+    const int TOKEN_BITS = 32;
+    const int PLAYER_BITS = 8;              // 0 to MAX_PLAYERS-1, 255 to join
+    const int BUTTON_BITS = 4;              // LEFT_BIT to FIRE_BIT
+    const int ACK_BITS = 16;
+    const int DELAY_BITS = 10;              // 0 to 1023 ms
+    // bytes of a ToServerStc
+    const int TO_SERVER_SIZE = packetLinkNS::HEADER_SIZE + (TOKEN_BITS + PLAYER_BITS +
+                               BUTTON_BITS + ACK_BITS + DELAY_BITS + 7) / 8;
+    // bytes of a ConnectResponse
+    const int CONNECT_RESPONSE_SIZE = (netNS::RESPONSE_SIZE*8 + PLAYER_BITS + TOKEN_BITS + 7) / 8;
+}
+
+// Write data as TO_SERVER_SIZE bytes
+// Pre: *buffer holds TO_SERVER_SIZE bytes
+void writeToServer(const ToServerStc &data, char *buffer);
+
+// Read a ToServerStc written by writeToServer
+// Post: returns false if size is less than TO_SERVER_SIZE
+bool readToServer(const char *buffer, int size, ToServerStc &data);
+
+// Write data as CONNECT_RESPONSE_SIZE bytes
+// Pre: *buffer holds CONNECT_RESPONSE_SIZE bytes
+void writeConnectResponse(const ConnectResponse &data, char *buffer);
+
+// Read a ConnectResponse written by writeConnectResponse, response is
+// always null terminated
+// Post: returns false if size is less than CONNECT_RESPONSE_SIZE
+bool readConnectResponse(const char *buffer, int size, ConnectResponse &data);
+
+#endif
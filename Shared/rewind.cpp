@@ -0,0 +1,151 @@
+// Recent ship positions of a match, for lag compensated torpedo hits
+
+#include <math.h>
+#include "rewind.h"
+using namespace rewindNS;
+
+//=============================================================================
+// Return true if a circle moving from p by d, relative to a fixed circle
+// at 0,0, comes within r of it
+//=============================================================================
+static bool touches(float px, float py, float dx, float dy, float r)
+{
+    float c = px*px + py*py - r*r;
+    if (c <= 0)                 // touching at the start
+        return true;
+    float a = dx*dx + dy*dy;
+    float b = px*dx + py*dy;
+    if (a <= 0 || b >= 0)       // not moving closer
+        return false;
+    float disc = b*b - a*c;
+    if (disc < 0)               // closest approach is farther than r
+        return false;
+    return -b - sqrtf(disc) <= a;   // contact within the move
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+RewindHistory::RewindHistory()
+{
+    bodies = 0;
+    width = height = 0;
+    first = count = 0;
+    window = MAX_WINDOW;
+    sweeps = hits = 0;
+}
+
+//=============================================================================
+// Forget all ticks, each will hold n bodies
+//=============================================================================
+void RewindHistory::initialize(int n, float w, float h)
+{
+    bodies = n;
+    width = w;
+    height = h;
+    times.assign(TICKS, 0);
+    states.assign(TICKS * n, RewindState());
+    clear();
+}
+
+//=============================================================================
+// Start the tick at time, returns its bodies to be filled in
+//=============================================================================
+RewindState *RewindHistory::record(double time)
+{
+    if (count == TICKS)         // drop the oldest
+    {
+        first = (first + 1) % TICKS;
+        count--;
+    }
+    times[(first + count) % TICKS] = time;
+    count++;
+    return &states[((first + count - 1) % TICKS) * bodies];
+}
+
+//=============================================================================
+// Sweep a torpedo's move over the newest tick against the bodies lag earlier
+// The move is split at the ticks it spans, and in each piece the bodies
+// move in a straight line between the two ticks either side. A body that
+// wrapped around the screen edge between two ticks is only tested where it
+// ended up.
+//=============================================================================
+int RewindHistory::sweep(float lag, float x, float y, float mx, float my, float r, int ignore)
+{
+    if (!canSweep())
+        return -1;
+    if (lag > window)
+        lag = window;
+    double to = getTime(count-1) - lag;
+    double from = getTime(count-2) - lag;
+    if (from < getTime(0))      // older than the ticks held
+    {
+        to += getTime(0) - from;
+        from = getTime(0);
+    }
+    if (to <= from)
+        return -1;
+    sweeps++;
+
+    // the tick after from, the torpedo starts between ticks n-1 and n
+    int n = count-1;
+    while (n > 1 && getTime(n-1) > from)
+        n--;
+    double span = to - from;
+    for (; n < count && getTime(n-1) < to; n++)
+    {
+        double t0 = getTime(n-1), t1 = getTime(n);
+        if (t1 <= t0)
+            continue;
+        double s0 = (from > t0) ? from : t0;    // this piece of the move
+        double s1 = (to < t1) ? to : t1;
+        float f0 = (float)((s0 - t0) / (t1 - t0));
+        float f1 = (float)((s1 - t0) / (t1 - t0));
+        float g0 = (float)((s0 - from) / span);
+        float g1 = (float)((s1 - from) / span);
+        float tx = x + mx * g0, ty = y + my * g0;
+        float tdx = mx * (g1 - g0), tdy = my * (g1 - g0);
+        const RewindState *a = getStates(n-1);
+        const RewindState *b = getStates(n);
+        for (int i=0; i<bodies; i++)
+        {
+            if (i == ignore || !a[i].active || !b[i].active)
+                continue;
+            float bx = b[i].x - a[i].x, by = b[i].y - a[i].y;
+            float sx = a[i].x + bx * f0, sy = a[i].y + by * f0;
+            float dx = bx * (f1 - f0), dy = by * (f1 - f0);
+            if (fabs(bx) > width/2 || fabs(by) > height/2)
+            {
+                sx = b[i].x;    // wrapped
+                sy = b[i].y;
+                dx = dy = 0;
+            }
+            if (touches(tx - sx, ty - sy, tdx - dx, tdy - dy, r + b[i].radius))
+            {
+                hits++;
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+//=============================================================================
+// Set the longest rewind in seconds
+//=============================================================================
+void RewindHistory::setWindow(float seconds)
+{
+    if (seconds < 0)
+        seconds = 0;
+    if (seconds > MAX_WINDOW)
+        seconds = MAX_WINDOW;
+    window = seconds;
+}
+
+//=============================================================================
+// Return bytes held by the ring
+//=============================================================================
+size_t RewindHistory::getBytes() const
+{
+    return times.capacity() * sizeof(double) + states.capacity() * sizeof(RewindState);
+}
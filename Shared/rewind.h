@@ -0,0 +1,85 @@
+#ifndef _REWIND_H               // Prevent multiple definitions if this
+#define _REWIND_H               // file is included in more than one place
+
+#include <vector>
+
+// Lag compensation for torpedos
+// A player sees the other ships where they were a round trip and a playout
+// delay ago, so a torpedo aimed at a ship on screen misses the ship where
+// the server has it now. Every tick the match records where each ship is in
+// a ring of compact states. A torpedo fired by a lagging player is tested
+// each tick against the ships as they were that lag earlier, from the tick
+// it spawns until it is gone, so it hits what the shooter aimed at. No lag
+// is rewound farther than the window, so a player with a long round trip
+// can not hit ships that have long moved on.
+
+namespace rewindNS
+{
+    const int   TICKS = 64;             // ticks kept, 250 ms at up to 252 ticks/sec
+    const float MAX_WINDOW = 0.25f;     // longest rewind, seconds
+    const float VIEW_DELAY = 0.1f;      // playout delay until a player's input says, interpolationNS::DELAY
+}
+
+// Where one ship was at one tick, all a torpedo needs to hit it
+struct RewindState
+{
+    float   x, y;           // center
+    float   radius;         // collision radius
+    bool    active;         // false if it could not be hit
+};
+
+class RewindHistory
+{
+private:
+    std::vector<double> times;          // ring of tick times, seconds
+    std::vector<RewindState> states;    // bodies per tick
+    int     bodies;                     // states per tick
+    float   width, height;              // game size, bodies wrap at its edges
+    int     first;                      // oldest tick
+    int     count;                      // ticks held
+    float   window;                     // longest rewind, seconds
+    unsigned int sweeps, hits;
+
+    const RewindState *getStates(int n) const {return &states[((first + n) % rewindNS::TICKS) * bodies];}
+    double  getTime(int n) const    {return times[(first + n) % rewindNS::TICKS];}
+
+public:
+    // Constructor
+    RewindHistory();
+
+    // Forget all ticks, each will hold n bodies in a game w by h pixels
+    void initialize(int n, float w, float h);
+
+    // Forget all ticks, for a new round
+    void clear()                    {first = count = 0;}
+
+    // Start the tick at time seconds and return its bodies to be filled in,
+    // the oldest tick is dropped when the ring is full
+    RewindState *record(double time);
+
+    // Return true if sweep can be used this tick, there is a tick before
+    // the newest and time passed between them
+    bool canSweep() const           {return count >= 2 && getTime(count-1) > getTime(count-2);}
+
+    // Sweep a torpedo that moved from center x,y by mx,my over the newest
+    // tick against the bodies as they were lag seconds earlier
+    // lag is cut to the window and to the ticks held.
+    // ignore = body that fired the torpedo, -1 for none
+    // Post: returns the body hit first, -1 if none or canSweep is false
+    int  sweep(float lag, float x, float y, float mx, float my, float r, int ignore);
+
+    // Set the longest rewind in seconds, 0 to MAX_WINDOW, 0 turns it off
+    void setWindow(float seconds);
+
+    // Return the longest rewind in seconds
+    float getWindow() const         {return window;}
+
+    // Return bytes held by the ring
+    size_t getBytes() const;
+
+    // Return sweeps made, and of those the ones that hit
+    unsigned int getSweeps() const  {return sweeps;}
+    unsigned int getHits() const    {return hits;}
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _SIMD_H                 // Prevent multiple definitions if this 
+#define _SIMD_H                 // file is included in more than one place
+
+// Instruction set used by the batched collision and gravity kernels
+// SIMD_AVX2 is defined when compiled with -mavx2 (8 floats per register),
+// SIMD_SSE2 on any other x64 build (4 floats per register) and neither when
+// the scalar loops are used. Define SIMD_SCALAR to force the scalar loops.
+
+#if !defined(SIMD_SCALAR) && defined(__AVX2__)
+#define SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(SIMD_SCALAR) && \
+      (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace simdNS
+{
+#if defined(SIMD_AVX2)
+    const int LANES = 8;
+    const char KERNEL[] = "avx2";
+#elif defined(SIMD_SSE2)
+    const int LANES = 4;
+    const char KERNEL[] = "sse2";
+#else
+    const int LANES = 1;
+    const char KERNEL[] = "scalar";
+#endif
+}
+
+#endif
@@ -0,0 +1,806 @@
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "protocol.h"
+#include "bitStream.h"
+using namespace snapshotNS;
+
+namespace
+{
+    // Ship fields, velocity and rotation come first so the position and
+    // heading can be predicted from both the baseline and the new values
+    enum {SHIP_VX, SHIP_VY, SHIP_ROTATION, SHIP_X, SHIP_Y, SHIP_ANGLE, SHIP_HEALTH, SHIP_SCORE};
+    const int SHIP_BITS[SHIP_FIELDS] = {VELOCITY_BITS, VELOCITY_BITS, ROTATION_BITS, POSITION_BITS,
+                                        POSITION_BITS, ANGLE_BITS, HEALTH_BITS, SCORE_BITS};
+    // Exp-Golomb order of a changed field, -1 to send it whole
+    const int SHIP_ORDER[SHIP_FIELDS] = {3, 3, 2, 1, 1, 1, -1, -1};
+    // Torpedo fields
+    enum {TORPEDO_VX, TORPEDO_VY, TORPEDO_X, TORPEDO_Y};
+    const int TORPEDO_BITS[TORPEDO_FIELDS] = {VELOCITY_BITS, VELOCITY_BITS, POSITION_BITS, POSITION_BITS};
+    const int TORPEDO_ORDER[TORPEDO_FIELDS] = {3, 3, 1, 1};
+    const int ID_ORDER = 2;             // Exp-Golomb order of the gap between new torpedo ids
+    const int MAX_PREFIX = 16;          // longer Exp-Golomb prefixes are corrupt, fields are 16 bits at most
+    const int VELOCITY_ZERO = (int)(-VELOCITY_MIN / VELOCITY_STEP);    // fixed point 0 px/s
+    const int ROTATION_ZERO = (int)(-ROTATION_MIN / ROTATION_STEP);
+    const int ANGLE_MASK = (1 << ANGLE_BITS) - 1;
+    // active or connected ships send their fields
+    const UCHAR HAS_FIELDS = spacewarNS::SHIP_ACTIVE_BIT | spacewarNS::SHIP_CONNECTED_BIT;
+    const double PIx2 = 3.14159265358979*2.0;   // PIx2 of every project's constants.h
+}
+
+//=============================================================================
+// Return n/d rounded to nearest, halves away from 0
+//=============================================================================
+static int divRound(long long n, long long d)
+{
+    return (int)(n >= 0 ? (n + d/2) / d : -((-n + d/2) / d));
+}
+
+//=============================================================================
+// Return the position elapsed ms after position, moving at velocity0 then
+// and velocity1 now, all fixed point
+// The average of the two is exact for a steady pull such as an orbit's.
+// Kept in range so a change is never wider than the field.
+//=============================================================================
+static int predictPosition(int position, int velocity0, int velocity1, int elapsed)
+{
+    int p = position + divRound((long long)(velocity0 + velocity1 - 2*VELOCITY_ZERO) *
+                                POSITION_PER_VELOCITY * elapsed, 2000);
+    return p < 0 ? 0 : p >= (1 << POSITION_BITS) ? (1 << POSITION_BITS) - 1 : p;
+}
+
+//=============================================================================
+// Return the heading elapsed ms after angle, turning at rotation0 then and
+// rotation1 now, all fixed point
+//=============================================================================
+static int predictAngle(int angle, int rotation0, int rotation1, int elapsed)
+{
+    return (angle + divRound((rotation0 + rotation1 - 2*ROTATION_ZERO) * ANGLE_PER_ROTATION *
+                             elapsed, 2000000000)) & ANGLE_MASK;
+}
+
+//=============================================================================
+// Quantize one player of data
+//=============================================================================
+static void quantize(const Player &in, SnapshotPlayer &out)
+{
+    const ShipStc &ship = in.shipData;
+    out.flags = ship.flags & ((1 << FLAG_BITS) - 1);
+    for (int f=0; f<SHIP_FIELDS; f++)
+        out.ship[f] = 0;
+    if (out.flags & HAS_FIELDS)
+    {
+        out.ship[SHIP_X] = (USHORT)toFixed(ship.X, POSITION_MIN, POSITION_STEP, POSITION_BITS);
+        out.ship[SHIP_Y] = (USHORT)toFixed(ship.Y, POSITION_MIN, POSITION_STEP, POSITION_BITS);
+        // radians keep growing as the ship turns, send them modulo 2 PI
+        double turns = ship.radians / PIx2;
+        double fraction = turns - floor(turns);
+        out.ship[SHIP_ANGLE] = (USHORT)((int)floor(fraction * (1 << ANGLE_BITS) + 0.5) & ANGLE_MASK);
+        out.ship[SHIP_HEALTH] = (USHORT)toFixed(ship.health, 0, HEALTH_STEP, HEALTH_BITS);
+        out.ship[SHIP_VX] = (USHORT)toFixed(ship.velocity.x, VELOCITY_MIN, VELOCITY_STEP, VELOCITY_BITS);
+        out.ship[SHIP_VY] = (USHORT)toFixed(ship.velocity.y, VELOCITY_MIN, VELOCITY_STEP, VELOCITY_BITS);
+        out.ship[SHIP_ROTATION] = (USHORT)toFixed(ship.rotation, ROTATION_MIN, ROTATION_STEP, ROTATION_BITS);
+        out.ship[SHIP_SCORE] = (USHORT)ship.score;
+    }
+}
+
+//=============================================================================
+// Quantize one torpedo of data
+//=============================================================================
+static void quantize(const TorpedoStc &in, SnapshotTorpedo &out)
+{
+    out.id = in.id;
+    out.owner = in.owner;
+    out.field[TORPEDO_X] = (USHORT)toFixed(in.X, POSITION_MIN, POSITION_STEP, POSITION_BITS);
+    out.field[TORPEDO_Y] = (USHORT)toFixed(in.Y, POSITION_MIN, POSITION_STEP, POSITION_BITS);
+    out.field[TORPEDO_VX] = (USHORT)toFixed(in.velocity.x, VELOCITY_MIN, VELOCITY_STEP, VELOCITY_BITS);
+    out.field[TORPEDO_VY] = (USHORT)toFixed(in.velocity.y, VELOCITY_MIN, VELOCITY_STEP, VELOCITY_BITS);
+}
+
+//=============================================================================
+// Set player n of data from its fixed point state
+//=============================================================================
+static void dequantize(const SnapshotPlayer &in, Player &out, int n)
+{
+    ShipStc &ship = out.shipData;
+    ship.playerN = (UCHAR)n;
+    ship.flags = in.flags;
+    ship.X = fromFixed(in.ship[SHIP_X], POSITION_MIN, POSITION_STEP);
+    ship.Y = fromFixed(in.ship[SHIP_Y], POSITION_MIN, POSITION_STEP);
+    ship.radians = (float)(in.ship[SHIP_ANGLE] * PIx2 / (1 << ANGLE_BITS));
+    ship.health = fromFixed(in.ship[SHIP_HEALTH], 0, HEALTH_STEP);
+    ship.velocity.x = fromFixed(in.ship[SHIP_VX], VELOCITY_MIN, VELOCITY_STEP);
+    ship.velocity.y = fromFixed(in.ship[SHIP_VY], VELOCITY_MIN, VELOCITY_STEP);
+    ship.rotation = fromFixed(in.ship[SHIP_ROTATION], ROTATION_MIN, ROTATION_STEP);
+    ship.score = (short)in.ship[SHIP_SCORE];
+    if (!(in.flags & HAS_FIELDS))
+    {
+        ship.X = ship.Y = 0;
+        ship.velocity = VECTOR2(0, 0);
+        ship.rotation = 0;
+    }
+}
+
+//=============================================================================
+// Set a torpedo of data from its fixed point state
+//=============================================================================
+static void dequantize(const SnapshotTorpedo &in, TorpedoStc &out)
+{
+    out.active = true;
+    out.id = in.id;
+    out.owner = in.owner;
+    out.X = fromFixed(in.field[TORPEDO_X], POSITION_MIN, POSITION_STEP);
+    out.Y = fromFixed(in.field[TORPEDO_Y], POSITION_MIN, POSITION_STEP);
+    out.velocity.x = fromFixed(in.field[TORPEDO_VX], VELOCITY_MIN, VELOCITY_STEP);
+    out.velocity.y = fromFixed(in.field[TORPEDO_VY], VELOCITY_MIN, VELOCITY_STEP);
+}
+
+//=============================================================================
+// Return true if torpedo a has a lower id than b, the order a snapshot
+// holds its torpedos in
+//=============================================================================
+static bool byId(const SnapshotTorpedo &a, const SnapshotTorpedo &b)
+{
+    return a.id < b.id;
+}
+
+//=============================================================================
+// Return ship field f predicted from its baseline elapsed ms older
+// Pre: ship[] holds the fields before f
+//=============================================================================
+static int predictShip(const SnapshotPlayer &base, const int *ship, int f, int elapsed)
+{
+    switch (f)
+    {
+    case SHIP_X:
+        return predictPosition(base.ship[SHIP_X], base.ship[SHIP_VX], ship[SHIP_VX], elapsed);
+    case SHIP_Y:
+        return predictPosition(base.ship[SHIP_Y], base.ship[SHIP_VY], ship[SHIP_VY], elapsed);
+    case SHIP_ANGLE:
+        return predictAngle(base.ship[SHIP_ANGLE], base.ship[SHIP_ROTATION], ship[SHIP_ROTATION], elapsed);
+    default:
+        return base.ship[f];
+    }
+}
+
+//=============================================================================
+// Return torpedo field f predicted from its baseline elapsed ms older
+// Pre: torpedo[] holds the fields before f
+//=============================================================================
+static int predictTorpedo(const SnapshotTorpedo &base, const int *torpedo, int f, int elapsed)
+{
+    switch (f)
+    {
+    case TORPEDO_X:
+        return predictPosition(base.field[TORPEDO_X], base.field[TORPEDO_VX], torpedo[TORPEDO_VX], elapsed);
+    case TORPEDO_Y:
+        return predictPosition(base.field[TORPEDO_Y], base.field[TORPEDO_VY], torpedo[TORPEDO_VY], elapsed);
+    default:
+        return base.field[f];
+    }
+}
+
+//=============================================================================
+// Write u as an Exp-Golomb code of order k, 0 takes k+1 bits
+//=============================================================================
+static void writeCode(BitWriter &out, unsigned int u, int k)
+{
+    unsigned int v = u + (1u << k);
+    int n = 0;                          // bits in v
+    while ((v >> n) > 1)
+        n++;
+    int prefix = n - k;
+    out.write((1u << prefix) - 1, prefix + 1);  // prefix ones then a zero
+    if (n > 0)
+        out.write(v, n);                // v without its top bit
+}
+
+//=============================================================================
+// Read a value written by writeCode
+// Post: returns false if the code is longer than any field
+//=============================================================================
+static bool readCode(BitReader &in, int k, unsigned int &u)
+{
+    int prefix = 0;
+    while (in.readBool())
+        if (++prefix > MAX_PREFIX || in.overflow())
+            return false;
+    int n = prefix + k;
+    unsigned int v = (1u << n) | (n > 0 ? in.read(n) : 0);
+    u = v - (1u << k);
+    return true;
+}
+
+//=============================================================================
+// Write a nonzero change as a signed Exp-Golomb code of order k
+// Small changes take few bits, 1 or -1 take k+2.
+//=============================================================================
+static void writeGolomb(BitWriter &out, int change, int k)
+{
+    writeCode(out, change > 0 ? 2*(change - 1) : 2*(-change) - 1, k);
+}
+
+//=============================================================================
+// Read a change written by writeGolomb
+// Post: returns false if the code is longer than any change
+//=============================================================================
+static bool readGolomb(BitReader &in, int k, int &change)
+{
+    unsigned int u;
+    if (!readCode(in, k, u))
+        return false;
+    change = (u & 1) ? -(int)((u + 1) / 2) : (int)(u / 2) + 1;
+    return true;
+}
+
+//=============================================================================
+// Write value as a change from predicted
+// order = Exp-Golomb order, -1 to send the whole value on any change
+// angle = true for a heading, which wraps
+//=============================================================================
+static void writeDelta(BitWriter &out, int value, int predicted, int bits, int order, bool angle)
+{
+    int change = value - predicted;
+    if (angle)          // shortest way round
+        change = ((change + (1 << (bits-1))) & ((1 << bits) - 1)) - (1 << (bits-1));
+    out.writeBool(change != 0);
+    if (change == 0)
+        return;
+    if (order < 0)
+        out.write(value, bits);
+    else
+        writeGolomb(out, change, order);
+}
+
+//=============================================================================
+// Read a value written by writeDelta
+// Post: returns false if the value is out of range
+//=============================================================================
+static bool readDelta(BitReader &in, int predicted, int bits, int order, bool angle, int &value)
+{
+    if (!in.readBool())
+        value = predicted;
+    else if (order < 0)
+        value = (int)in.read(bits);
+    else
+    {
+        int change;
+        if (!readGolomb(in, order, change))
+            return false;
+        value = predicted + change;
+    }
+    if (angle)
+        value &= (1 << bits) - 1;
+    return value >= 0 && value < (1 << bits);
+}
+
+//=============================================================================
+// Write count fields whole
+//=============================================================================
+static void writeFields(BitWriter &out, const USHORT *field, const int *bits, int count)
+{
+    for (int f=0; f<count; f++)
+        out.write(field[f], bits[f]);
+}
+
+//=============================================================================
+// Read count fields written whole
+//=============================================================================
+static void readFields(BitReader &in, USHORT *field, const int *bits, int count)
+{
+    for (int f=0; f<count; f++)
+        field[f] = (USHORT)in.read(bits[f]);
+}
+
+//=============================================================================
+// Write a float as its 32 IEEE bits, read it back with readFloat
+//=============================================================================
+static void writeFloat(BitWriter &out, float value)
+{
+    UINT bits;
+    memcpy(&bits, &value, sizeof(bits));
+    out.write(bits, 32);
+}
+
+static float readFloat(BitReader &in)
+{
+    UINT bits = in.read(32);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//=============================================================================
+// Return true if gravity a and b pull the same
+//=============================================================================
+static bool sameGravity(const GravityStc &a, const GravityStc &b)
+{
+    if (a.flags != b.flags || a.wellCount != b.wellCount)
+        return false;
+    for (int n=0; n<a.wellCount; n++)
+    {
+        if (a.well[n].x != b.well[n].x || a.well[n].y != b.well[n].y ||
+            a.well[n].mass != b.well[n].mass)
+            return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// Write the gravity
+//=============================================================================
+static void writeGravity(BitWriter &out, const GravityStc &gravity)
+{
+    out.write(gravity.flags, GRAVITY_FLAG_BITS);
+    out.write(gravity.wellCount, WELL_COUNT_BITS);
+    for (int n=0; n<gravity.wellCount; n++)
+    {
+        writeFloat(out, gravity.well[n].x);
+        writeFloat(out, gravity.well[n].y);
+        writeFloat(out, gravity.well[n].mass);
+    }
+}
+
+//=============================================================================
+// Read gravity written by writeGravity, returns false if it has too many wells
+//=============================================================================
+static bool readGravity(BitReader &in, GravityStc &gravity)
+{
+    gravity.flags = (UCHAR)in.read(GRAVITY_FLAG_BITS);
+    gravity.wellCount = (UCHAR)in.read(WELL_COUNT_BITS);
+    if (gravity.wellCount > spacewarNS::MAX_WELLS)
+        return false;
+    for (int n=0; n<gravity.wellCount; n++)
+    {
+        gravity.well[n].x = readFloat(in);
+        gravity.well[n].y = readFloat(in);
+        gravity.well[n].mass = readFloat(in);
+    }
+    return true;
+}
+
+//=============================================================================
+// Write player p in full
+//=============================================================================
+static void writeFull(BitWriter &out, const SnapshotPlayer &p)
+{
+    out.write(p.flags, FLAG_BITS);
+    if (p.flags & HAS_FIELDS)
+        writeFields(out, p.ship, SHIP_BITS, SHIP_FIELDS);
+}
+
+//=============================================================================
+// Read a player written by writeFull
+//=============================================================================
+static void readFull(BitReader &in, SnapshotPlayer &p)
+{
+    p.flags = (UCHAR)in.read(FLAG_BITS);
+    for (int f=0; f<SHIP_FIELDS; f++)
+        p.ship[f] = 0;
+    if (p.flags & HAS_FIELDS)
+        readFields(in, p.ship, SHIP_BITS, SHIP_FIELDS);
+}
+
+//=============================================================================
+// Return true if p differs from its prediction from base, elapsed ms older
+//=============================================================================
+static bool changed(const SnapshotPlayer &p, const SnapshotPlayer &base, int elapsed)
+{
+    if (p.flags != base.flags)
+        return true;
+    if (p.flags & HAS_FIELDS)
+    {
+        int ship[SHIP_FIELDS];
+        for (int f=0; f<SHIP_FIELDS; f++)
+        {
+            ship[f] = p.ship[f];
+            if (ship[f] != predictShip(base, ship, f, elapsed))
+                return true;
+        }
+    }
+    return false;
+}
+
+//=============================================================================
+// Write player p as a change from base, elapsed ms older
+//=============================================================================
+static void writeChange(BitWriter &out, const SnapshotPlayer &p, const SnapshotPlayer &base, int elapsed)
+{
+    if (!changed(p, base, elapsed))
+    {
+        out.write(0, 1);
+        return;
+    }
+    out.write(1, 1);
+    out.writeBool(p.flags != base.flags);
+    if (p.flags != base.flags)
+        out.write(p.flags, FLAG_BITS);
+    if (p.flags & HAS_FIELDS)
+    {
+        if (base.flags & HAS_FIELDS)
+        {
+            int ship[SHIP_FIELDS];
+            for (int f=0; f<SHIP_FIELDS; f++)
+            {
+                ship[f] = p.ship[f];
+                writeDelta(out, ship[f], predictShip(base, ship, f, elapsed), SHIP_BITS[f],
+                           SHIP_ORDER[f], f == SHIP_ANGLE);
+            }
+        }
+        else            // ship just joined
+            writeFields(out, p.ship, SHIP_BITS, SHIP_FIELDS);
+    }
+}
+
+//=============================================================================
+// Read a player written by writeChange
+// Post: returns false if a field is out of range
+//=============================================================================
+static bool readChange(BitReader &in, SnapshotPlayer &p, const SnapshotPlayer &base, int elapsed)
+{
+    bool isChanged = in.readBool();
+    p.flags = base.flags;
+    if (isChanged && in.readBool())
+        p.flags = (UCHAR)in.read(FLAG_BITS);
+    int ship[SHIP_FIELDS];
+    for (int f=0; f<SHIP_FIELDS; f++)
+        p.ship[f] = 0;
+    if (p.flags & HAS_FIELDS)
+    {
+        if (!(base.flags & HAS_FIELDS))
+            readFields(in, p.ship, SHIP_BITS, SHIP_FIELDS);
+        else
+            for (int f=0; f<SHIP_FIELDS; f++)
+            {
+                ship[f] = predictShip(base, ship, f, elapsed);
+                if (isChanged && !readDelta(in, ship[f], SHIP_BITS[f], SHIP_ORDER[f],
+                                            f == SHIP_ANGLE, ship[f]))
+                    return false;
+                p.ship[f] = (USHORT)ship[f];
+            }
+    }
+    return true;
+}
+
+//=============================================================================
+// Write torpedo t as a change from base, elapsed ms older
+//=============================================================================
+static void writeChange(BitWriter &out, const SnapshotTorpedo &t, const SnapshotTorpedo &base, int elapsed)
+{
+    int torpedo[TORPEDO_FIELDS];
+    bool isChanged = false;
+    for (int f=0; f<TORPEDO_FIELDS; f++)
+    {
+        torpedo[f] = t.field[f];
+        if (torpedo[f] != predictTorpedo(base, torpedo, f, elapsed))
+            isChanged = true;
+    }
+    out.writeBool(isChanged);
+    if (!isChanged)
+        return;
+    for (int f=0; f<TORPEDO_FIELDS; f++)
+        writeDelta(out, torpedo[f], predictTorpedo(base, torpedo, f, elapsed),
+                   TORPEDO_BITS[f], TORPEDO_ORDER[f], false);
+}
+
+//=============================================================================
+// Read a torpedo written by writeChange
+// Post: returns false if a field is out of range
+//=============================================================================
+static bool readChange(BitReader &in, SnapshotTorpedo &t, const SnapshotTorpedo &base, int elapsed)
+{
+    bool isChanged = in.readBool();
+    t.id = base.id;
+    t.owner = base.owner;
+    int torpedo[TORPEDO_FIELDS];
+    for (int f=0; f<TORPEDO_FIELDS; f++)
+    {
+        torpedo[f] = predictTorpedo(base, torpedo, f, elapsed);
+        if (isChanged && !readDelta(in, torpedo[f], TORPEDO_BITS[f], TORPEDO_ORDER[f],
+                                    false, torpedo[f]))
+            return false;
+        t.field[f] = (USHORT)torpedo[f];
+    }
+    return true;
+}
+
+//=============================================================================
+// Write the count torpedos of t against the baseCount of base, elapsed ms
+// older, both in id order
+// The baseline's torpedos are each kept or gone, then the new ones follow.
+//=============================================================================
+static void writeTorpedos(BitWriter &out, const SnapshotTorpedo *t, int count,
+                          const SnapshotTorpedo *base, int baseCount, int elapsed)
+{
+    int kept = 0;
+    for (int b=0, n=0; b<baseCount; b++)
+    {
+        while (n < count && t[n].id < base[b].id)
+            n++;
+        bool isKept = n < count && t[n].id == base[b].id;
+        out.writeBool(isKept);
+        if (isKept)
+        {
+            writeChange(out, t[n], base[b], elapsed);
+            kept++;
+        }
+    }
+    out.write(count - kept, TORPEDO_COUNT_BITS);
+    int last = -1;
+    for (int n=0, b=0; n<count; n++)
+    {
+        while (b < baseCount && base[b].id < t[n].id)
+            b++;
+        if (b < baseCount && base[b].id == t[n].id)
+            continue;           // sent above
+        if (last < 0)
+            out.write(t[n].id, TORPEDO_ID_BITS);
+        else
+            writeCode(out, (unsigned int)(t[n].id - last - 1), ID_ORDER);
+        last = t[n].id;
+        out.write(t[n].owner, OWNER_BITS);
+        writeFields(out, t[n].field, TORPEDO_BITS, TORPEDO_FIELDS);
+    }
+}
+
+//=============================================================================
+// Read torpedos written by writeTorpedos into t, in id order
+// Pre: t holds limit torpedos, baseCount <= limit
+// Post: returns false if there are more than limit, an id is repeated, an
+//       owner is not one of players or a field is out of range
+//=============================================================================
+static bool readTorpedos(BitReader &in, SnapshotTorpedo *t, int limit, int &count, int players,
+                         const SnapshotTorpedo *base, int baseCount, int elapsed)
+{
+    count = 0;
+    for (int b=0; b<baseCount; b++)
+    {
+        if (!in.readBool())
+            continue;           // gone
+        if (!readChange(in, t[count], base[b], elapsed))
+            return false;
+        count++;
+    }
+    int kept = count;
+    int added = (int)in.read(TORPEDO_COUNT_BITS);
+    if (in.overflow() || kept + added > limit)
+        return false;
+    unsigned int id = 0;
+    for (int n=0; n<added; n++)
+    {
+        SnapshotTorpedo &torpedo = t[count++];
+        unsigned int gap = 0;
+        if (n == 0)
+            id = in.read(TORPEDO_ID_BITS);
+        else if (!readCode(in, ID_ORDER, gap))
+            return false;
+        else
+            id += gap + 1;
+        torpedo.id = (USHORT)id;
+        torpedo.owner = (UCHAR)in.read(OWNER_BITS);
+        if (id >= (1u << TORPEDO_ID_BITS) || torpedo.owner >= players)
+            return false;
+        readFields(in, torpedo.field, TORPEDO_BITS, TORPEDO_FIELDS);
+    }
+    std::inplace_merge(t, t + kept, t + count, byId);
+    for (int n=1; n<count; n++)
+        if (t[n].id == t[n-1].id)
+            return false;
+    return true;
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+SnapshotHistory::SnapshotHistory()
+{
+    playerCount = 0;
+    torpedoLimit = 0;
+    newest = 0;
+}
+
+//=============================================================================
+// Forget all snapshots, each will have count players
+//=============================================================================
+void SnapshotHistory::initialize(int count)
+{
+    playerCount = count;
+    torpedoLimit = count * spacewarNS::PLAYER_TORPEDOS;
+    newest = 0;
+    Frame empty = Frame();
+    frames.assign(HISTORY, empty);
+    players.assign(HISTORY * count, SnapshotPlayer());
+    torpedos.assign(HISTORY * torpedoLimit, SnapshotTorpedo());
+}
+
+//=============================================================================
+// Return the frame of sequence, NULL if it is not held
+//=============================================================================
+SnapshotHistory::Frame *SnapshotHistory::find(USHORT sequence)
+{
+    if (sequence == 0 || frames.empty())
+        return NULL;
+    Frame &frame = frames[sequence % HISTORY];
+    if (frame.sequence != sequence)
+        return NULL;
+    return &frame;
+}
+
+//=============================================================================
+// Return the server time of snapshot sequence in ms, 0 if it is not held
+//=============================================================================
+UINT SnapshotHistory::getTime(USHORT sequence)
+{
+    Frame *frame = find(sequence);
+    return frame ? frame->time : 0;
+}
+
+//=============================================================================
+// Server: add data as the newest snapshot
+//=============================================================================
+void SnapshotHistory::add(const ToClientStc &data, UINT time)
+{
+    if (frames.empty())
+        return;
+    newest++;
+    if (newest == 0)            // 0 is no snapshot
+        newest = 1;
+    Frame &frame = frames[newest % HISTORY];
+    frame.sequence = newest;
+    frame.time = time;
+    frame.gameState = data.gameState;
+    frame.sounds = data.sounds;
+    frame.gravity = data.gravity;
+    frame.gravity.flags &= (1 << GRAVITY_FLAG_BITS) - 1;
+    if (frame.gravity.wellCount > spacewarNS::MAX_WELLS)  // more than a snapshot holds
+        frame.gravity.wellCount = spacewarNS::MAX_WELLS;
+    SnapshotPlayer *p = getPlayers(newest);
+    for (int i=0; i<playerCount; i++)
+        quantize(data.player[i], p[i]);
+    SnapshotTorpedo *t = getTorpedos(newest);
+    frame.torpedoCount = data.torpedoCount;
+    if (frame.torpedoCount > torpedoLimit)     // more than a snapshot holds
+        frame.torpedoCount = torpedoLimit;
+    if (frame.torpedoCount < 0)
+        frame.torpedoCount = 0;
+    for (int n=0; n<frame.torpedoCount; n++)
+        quantize(data.torpedo[n], t[n]);
+    std::sort(t, t + frame.torpedoCount, byId);
+}
+
+//=============================================================================
+// Server: write the newest snapshot against ack, returns bytes written or 0
+//=============================================================================
+int SnapshotHistory::write(USHORT ack, char *buffer, int size)
+{
+    Frame *frame = find(newest);
+    if (frame == NULL)
+        return 0;
+    Frame *base = find(ack);
+    USHORT offset = (USHORT)(newest - ack);
+    UINT elapsed = base ? frame->time - base->time : 0;
+    if (offset >= HISTORY || elapsed >= (1u << ELAPSED_BITS))
+        base = NULL;            // client is too far behind, send it all
+
+    BitWriter out(buffer, size);
+    out.write(newest, SEQUENCE_BITS);
+    out.write(playerCount, 7);
+    out.write(frame->gameState, 8);
+    out.write(frame->sounds, 8);
+    out.writeBool(base != NULL);
+    const SnapshotPlayer *p = getPlayers(newest);
+    if (base)
+    {
+        out.write(offset, OFFSET_BITS);
+        out.write(elapsed, ELAPSED_BITS);
+        bool gravityChanged = !sameGravity(frame->gravity, base->gravity);
+        out.writeBool(gravityChanged);
+        if (gravityChanged)
+            writeGravity(out, frame->gravity);
+        const SnapshotPlayer *b = getPlayers(ack);
+        for (int i=0; i<playerCount; i++)
+            writeChange(out, p[i], b[i], (int)elapsed);
+        writeTorpedos(out, getTorpedos(newest), frame->torpedoCount,
+                      getTorpedos(ack), base->torpedoCount, (int)elapsed);
+    }
+    else
+    {
+        out.write(frame->time, TIME_BITS);
+        writeGravity(out, frame->gravity);
+        for (int i=0; i<playerCount; i++)
+            writeFull(out, p[i]);
+        writeTorpedos(out, getTorpedos(newest), frame->torpedoCount, NULL, 0, 0);
+    }
+    if (out.overflow())
+        return 0;
+    return out.getSize();
+}
+
+//=============================================================================
+// Client: decode a snapshot into data and keep it, returns false if it
+// can not be decoded
+//=============================================================================
+bool SnapshotHistory::read(const char *buffer, int size, ToClientStc &data)
+{
+    BitReader in(buffer, size);
+    USHORT sequence = (USHORT)in.read(SEQUENCE_BITS);
+    int count = (int)in.read(7);
+    data.gameState = (UCHAR)in.read(8);
+    data.sounds = (UCHAR)in.read(8);
+    bool delta = in.readBool();
+    if (in.overflow() || sequence == 0 || count > spacewarNS::MAX_PLAYERS)
+        return false;
+    data.playerCount = (UCHAR)count;
+
+    Frame *base = NULL;
+    int elapsed = 0;
+    USHORT baseSequence = 0;
+    UINT time;
+    GravityStc gravity;
+    if (delta)
+    {
+        baseSequence = (USHORT)(sequence - in.read(OFFSET_BITS));
+        elapsed = (int)in.read(ELAPSED_BITS);
+        base = find(baseSequence);
+        if (base == NULL || count != playerCount)
+            return false;       // baseline was lost, wait for a snapshot we can use
+        time = base->time + elapsed;
+        gravity = base->gravity;
+        if (in.readBool() && !readGravity(in, gravity))
+            return false;
+    }
+    else
+    {
+        time = in.read(TIME_BITS);
+        if (!readGravity(in, gravity))
+            return false;
+        if (count != playerCount)
+            initialize(count);  // new server or match size
+    }
+
+    // decode into scratch space so a bad snapshot leaves the history alone
+    decoded.resize(count);
+    const SnapshotPlayer *b = base ? getPlayers(baseSequence) : NULL;
+    for (int i=0; i<count; i++)
+    {
+        if (b)
+        {
+            if (!readChange(in, decoded[i], b[i], elapsed))
+                return false;
+        }
+        else
+            readFull(in, decoded[i]);
+    }
+    decodedTorpedos.resize(torpedoLimit);
+    int torpedoCount;
+    if (!readTorpedos(in, decodedTorpedos.data(), torpedoLimit, torpedoCount, count,
+                      base ? getTorpedos(baseSequence) : NULL, base ? base->torpedoCount : 0, elapsed))
+        return false;
+    if (in.overflow() || (in.getBits() + 7) / 8 != size)   // a snapshot ends in its last byte
+        return false;
+
+    Frame &frame = frames[sequence % HISTORY];
+    frame.sequence = sequence;
+    frame.time = time;
+    frame.gameState = data.gameState;
+    frame.sounds = data.sounds;
+    frame.gravity = gravity;
+    frame.torpedoCount = torpedoCount;
+    SnapshotPlayer *p = getPlayers(sequence);
+    for (int i=0; i<count; i++)
+    {
+        p[i] = decoded[i];
+        dequantize(p[i], data.player[i], i);
+    }
+    SnapshotTorpedo *t = getTorpedos(sequence);
+    for (int n=0; n<torpedoCount; n++)
+    {
+        t[n] = decodedTorpedos[n];
+        dequantize(t[n], data.torpedo[n]);
+    }
+    data.torpedoCount = torpedoCount;
+    data.gravity = gravity;
+    if (newest == 0 || (short)(sequence - newest) > 0)
+        newest = sequence;
+    return true;
+}
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "tickScheduler.h"
+#ifdef _WIN32
+#include <Mmsystem.h>
+#pragma comment(lib,"winmm.lib")
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <unistd.h>
+#include <errno.h>
+#include <sys/timerfd.h>
+#endif
+using namespace tickSchedulerNS;
+
+const long long NS_PER_SEC = 1000000000LL;
+
+//=============================================================================
+// Constructor
+//=============================================================================
+TickScheduler::TickScheduler()
+{
+    tickTime = 0;
+    tickNs = 0;
+    spinNs = DEFAULT_SPIN_NS;
+    deadline = 0;
+    lastDeadline = 0;
+    tickStart = 0;
+    frameTime = 0;
+    backend = SLEEP;
+    initialized = false;
+#ifdef _WIN32
+    timerFreq.QuadPart = 0;
+    timer = NULL;
+    timerPeriodSet = false;
+#else
+    timerFd = -1;
+#endif
+    resetStats();
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+TickScheduler::~TickScheduler()
+{
+#ifdef _WIN32
+    if (timer)
+        CloseHandle(timer);
+    if (timerPeriodSet)
+        timeEndPeriod(1);           // End 1mS timer resolution
+#else
+    if (timerFd != -1)
+        close(timerFd);
+#endif
+}
+
+//=============================================================================
+// Initialize the scheduler
+// Pre: rate = ticks per second
+//      spin = nanoseconds to busy wait before each deadline, 0 to never spin
+//      backend = SLEEP or TIMERFD
+// Post: returns true if successful, false if failed
+//=============================================================================
+bool TickScheduler::initialize(double rate, long spin, int b)
+{
+    if (rate <= 0)
+        return false;
+    spinNs = spin;
+    backend = b;
+#ifdef _WIN32
+    if (QueryPerformanceFrequency(&timerFreq) == false)
+        return false;
+    // high resolution timer is available from Windows 10 1803
+    if (timer == NULL)          // not made by an earlier initialize
+        timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                       TIMER_ALL_ACCESS);
+    if (timer == NULL)
+    {
+        // older Windows, the timer is only as fine as the system tick so
+        // request 1mS resolution for the whole run, ended by the destructor
+        timer = CreateWaitableTimer(NULL, TRUE, NULL);
+        if (timer == NULL)
+            return false;
+        if (!timerPeriodSet && timeBeginPeriod(1) == TIMERR_NOERROR)
+            timerPeriodSet = true;
+    }
+#else
+    if (backend == TIMERFD && timerFd == -1)
+    {
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (timerFd == -1)
+            backend = SLEEP;        // fall back to clock_nanosleep
+    }
+#endif
+    initialized = true;
+    setRate(rate);
+    return true;
+}
+
+//=============================================================================
+// Change the tick rate. The next deadline is one new tick from now.
+// May be called before initialize.
+//=============================================================================
+void TickScheduler::setRate(double rate)
+{
+    if (rate <= 0)
+        return;
+    tickNs = (long long)(NS_PER_SEC / rate + 0.5);
+    tickTime = (double)tickNs / NS_PER_SEC;
+    frameTime = tickTime;
+    if (!initialized)               // deadlines start at initialize
+        return;
+    lastDeadline = now();
+    deadline = lastDeadline + tickNs;
+    tickStart = lastDeadline;
+}
+
+//=============================================================================
+// Return current monotonic time in nanoseconds
+//=============================================================================
+long long TickScheduler::now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    // split to avoid overflow and keep nanosecond precision
+    long long sec = t.QuadPart / timerFreq.QuadPart;
+    long long rem = t.QuadPart % timerFreq.QuadPart;
+    return sec * NS_PER_SEC + rem * NS_PER_SEC / timerFreq.QuadPart;
+#else
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * NS_PER_SEC + t.tv_nsec;
+#endif
+}
+
+//=============================================================================
+// Sleep until shortly before time t (nanoseconds)
+// The OS timer is only as accurate as the scheduler allows, the caller
+// spins the remaining time.
+//=============================================================================
+void TickScheduler::sleepUntil(long long t)
+{
+#ifdef _WIN32
+    long long wait = t - now();
+    if (wait <= 0)
+        return;
+    LARGE_INTEGER due;
+    due.QuadPart = -(wait / 100);   // relative time in 100nS units
+    if (SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE))
+        WaitForSingleObject(timer, INFINITE);
+    else
+        Sleep((DWORD)(wait / 1000000));
+#else
+    timespec ts;
+    ts.tv_sec = (time_t)(t / NS_PER_SEC);
+    ts.tv_nsec = (long)(t % NS_PER_SEC);
+    if (backend == TIMERFD && timerFd != -1)
+    {
+        itimerspec its;
+        uint64_t expirations;
+        memset(&its, 0, sizeof(its));
+        its.it_value = ts;          // one shot, absolute
+        if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &its, NULL) == 0)
+        {
+            while (read(timerFd, &expirations, sizeof(expirations)) == -1 && errno == EINTR)
+                ;
+            return;
+        }
+    }
+    // restart after signals, the deadline is absolute
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+#endif
+}
+
+//=============================================================================
+// Wait for the next tick deadline and update the statistics.
+// Returns the number of tick periods since the previous tick,
+// 1 unless deadlines were missed.
+//=============================================================================
+int TickScheduler::waitForTick()
+{
+    int periods = 1;
+    long long t;
+
+    if (!initialized)
+        return 1;
+
+    t = now();
+    stats.lastWork = (double)(t - tickStart) / NS_PER_SEC;
+    if (stats.lastWork > stats.maxWork)
+        stats.maxWork = stats.lastWork;
+
+    if (t > deadline)               // work ran past the deadline
+    {
+        stats.overruns++;
+        // skip deadlines that have already been missed by a whole tick
+        long long behind = (t - deadline) / tickNs;
+        if (behind > 0)
+        {
+            deadline += behind * tickNs;
+            periods += (int)behind;
+            stats.missed += (unsigned long)behind;
+        }
+    }
+    else
+    {
+        if (deadline - t > spinNs)
+            sleepUntil(deadline - spinNs);
+        while ((t = now()) < deadline)  // spin the last few microseconds
+            ;
+    }
+
+    // lateness of this tick
+    double lateness = (double)(t - deadline) / NS_PER_SEC;
+    stats.ticks++;
+    stats.lastLateness = lateness;
+    stats.totalLateness += lateness;
+    if (lateness > stats.maxLateness)
+        stats.maxLateness = lateness;
+    long long us = (t - deadline) / 1000;
+    int bucket = 0;
+    while (bucket < LATENESS_BUCKETS-1 && us >= (1LL << bucket))
+        bucket++;
+    stats.histogram[bucket]++;
+
+    frameTime = (double)(deadline - lastDeadline) / NS_PER_SEC;
+    lastDeadline = deadline;
+    deadline += tickNs;
+    tickStart = t;
+    return periods;
+}
+
+//=============================================================================
+// Clear statistics
+//=============================================================================
+void TickScheduler::resetStats()
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+//=============================================================================
+// Return lateness in seconds that fraction p (0 to 1) of ticks were under.
+// Resolution is one power of two microsecond bucket.
+//=============================================================================
+double TickScheduler::getLatenessPercentile(double p)
+{
+    if (stats.ticks == 0)
+        return 0;
+    unsigned long target = (unsigned long)(p * stats.ticks);
+    unsigned long count = 0;
+    for (int i=0; i<LATENESS_BUCKETS; i++)
+    {
+        count += stats.histogram[i];
+        if (count >= target && count > 0)
+            return (double)(1LL << i) / 1.0e6;    // upper edge of bucket
+    }
+    return stats.maxLateness;
+}
+
+//=============================================================================
+// Return a one line summary of the statistics
+//=============================================================================
+std::string TickScheduler::getStatsString()
+{
+    char buffer[256];
+    double mean = 0;
+    if (stats.ticks > 0)
+        mean = stats.totalLateness / stats.ticks;
+    snprintf(buffer, sizeof(buffer),
+        "ticks %lu overruns %lu missed %lu late(us) mean %.1f p99<%.0f max %.1f work(us) last %.1f max %.1f",
+        stats.ticks, stats.overruns, stats.missed, mean*1e6,
+        getLatenessPercentile(0.99)*1e6, stats.maxLateness*1e6,
+        stats.lastWork*1e6, stats.maxWork*1e6);
+    return std::string(buffer);
+}
@@ -0,0 +1,120 @@
+#ifndef _TICKSCHEDULER_H        // Prevent multiple definitions if this 
+#define _TICKSCHEDULER_H        // file is included in more than one place
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <string>
+
+// Tick scheduler
+// Wakes the game loop at absolute deadlines spaced exactly one tick apart.
+// Deadlines do not drift with the time spent working between ticks.
+// The OS timer wakes the thread shortly before the deadline and the final
+// microseconds are optionally spun away for low jitter.
+
+namespace tickSchedulerNS
+{
+    // Wait backends
+    // SLEEP:   clock_nanosleep(TIMER_ABSTIME) on Linux,
+    //          high resolution waitable timer on Windows
+    // TIMERFD: one-shot absolute timerfd (Linux only, same as SLEEP elsewhere)
+    enum BACKEND {SLEEP, TIMERFD};
+    const long DEFAULT_SPIN_NS = 50000;     // spin the last 50 microseconds
+    const int  LATENESS_BUCKETS = 18;       // bucket n holds lateness < 2^n microseconds
+}
+
+// Lateness and overrun statistics.
+// Lateness is how long after its deadline a tick actually started.
+// An overrun is a deadline that had already passed when the previous tick
+// finished its work; the missed deadlines are skipped.
+struct TickStats
+{
+    unsigned long ticks;        // ticks waited for
+    unsigned long overruns;     // ticks that finished after the next deadline
+    unsigned long missed;       // deadlines skipped because of overruns
+    double lastLateness;        // lateness of the latest tick (seconds)
+    double maxLateness;         // worst lateness (seconds)
+    double totalLateness;       // sum of lateness, for the mean (seconds)
+    double lastWork;            // time spent working in the previous tick (seconds)
+    double maxWork;             // longest work time (seconds)
+    unsigned long histogram[tickSchedulerNS::LATENESS_BUCKETS]; // lateness in log2 microseconds
+};
+
+class TickScheduler
+{
+private:
+    double  tickTime;           // seconds per tick
+    long long tickNs;           // nanoseconds per tick
+    long long spinNs;           // nanoseconds to spin before each deadline
+    long long deadline;         // next deadline (nanoseconds)
+    long long lastDeadline;     // deadline of the current tick
+    long long tickStart;        // time the current tick started
+    double  frameTime;          // time between the current and previous deadlines
+    int     backend;
+    bool    initialized;
+    TickStats stats;
+#ifdef _WIN32
+    LARGE_INTEGER timerFreq;    // Performance Counter frequency
+    HANDLE  timer;              // waitable timer
+    bool    timerPeriodSet;     // true if timeBeginPeriod(1) is in effect
+#else
+    int     timerFd;            // timerfd for the TIMERFD backend
+#endif
+
+    // Sleep until shortly before time t (nanoseconds)
+    void sleepUntil(long long t);
+
+public:
+    // Constructor
+    TickScheduler();
+    // Destructor
+    virtual ~TickScheduler();
+
+    // Initialize the scheduler
+    // Pre: rate = ticks per second
+    //      spin = nanoseconds to busy wait before each deadline, 0 to never spin
+    //      backend = SLEEP or TIMERFD
+    // Post: returns true if successful, false if failed
+    bool initialize(double rate, long spin = tickSchedulerNS::DEFAULT_SPIN_NS,
+                    int backend = tickSchedulerNS::SLEEP);
+
+    // Change the tick rate. The next deadline is one new tick from now.
+    // May be called before initialize.
+    void setRate(double rate);
+
+    // Set nanoseconds to busy wait before each deadline
+    void setSpin(long spin)     {spinNs = spin;}
+
+    // Wait for the next tick deadline and update the statistics.
+    // Returns the number of tick periods since the previous tick,
+    // 1 unless deadlines were missed.
+    int waitForTick();
+
+    // Return time between this tick's deadline and the previous one, in seconds
+    double getFrameTime()       {return frameTime;}
+
+    // Return seconds per tick
+    double getTickTime()        {return tickTime;}
+
+    // Return statistics
+    const TickStats& getStats() {return stats;}
+
+    // Clear statistics
+    void resetStats();
+
+    // Return lateness in seconds that fraction p (0 to 1) of ticks were under.
+    // Resolution is one power of two microsecond bucket.
+    double getLatenessPercentile(double p);
+
+    // Return a one line summary of the statistics
+    std::string getStatsString();
+
+    // Return current monotonic time in nanoseconds
+    long long now();
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef _VECTOR2_H              // Prevent multiple definitions if this 
+#define _VECTOR2_H              // file is included in more than one place
+
+#include <math.h>
+
+// Two dimensional vector used by the simulation in place of D3DXVECTOR2.
+// Header only so every operation can be inlined, and with the same layout
+// as D3DXVECTOR2 (two floats) so ShipStc and TorpedoStc are the same in
+// every project. The batched SIMD kernels (simd.h) work on arrays of floats;
+// a single two float vector is faster in scalar registers.
+
+// constexpr where the compiler supports it (not Visual Studio 2013)
+#if (defined(_MSC_VER) && _MSC_VER >= 1900) || (!defined(_MSC_VER) && __cplusplus >= 201103L)
+#define VECTOR2_CONSTEXPR constexpr
+#else
+#define VECTOR2_CONSTEXPR
+#endif
+
+struct Vector2
+{
+    float x, y;
+
+    Vector2() {}
+    VECTOR2_CONSTEXPR Vector2(float vx, float vy) : x(vx), y(vy) {}
+
+    Vector2& operator += (const Vector2 &v) {x += v.x; y += v.y; return *this;}
+    Vector2& operator -= (const Vector2 &v) {x -= v.x; y -= v.y; return *this;}
+    Vector2& operator *= (float f)          {x *= f; y *= f; return *this;}
+    Vector2& operator /= (float f)          {x /= f; y /= f; return *this;}
+
+    VECTOR2_CONSTEXPR Vector2 operator + () const   {return *this;}
+    VECTOR2_CONSTEXPR Vector2 operator - () const   {return Vector2(-x, -y);}
+
+    VECTOR2_CONSTEXPR Vector2 operator + (const Vector2 &v) const {return Vector2(x + v.x, y + v.y);}
+    VECTOR2_CONSTEXPR Vector2 operator - (const Vector2 &v) const {return Vector2(x - v.x, y - v.y);}
+    VECTOR2_CONSTEXPR Vector2 operator * (float f) const  {return Vector2(x * f, y * f);}
+    VECTOR2_CONSTEXPR Vector2 operator / (float f) const  {return Vector2(x / f, y / f);}
+
+    friend VECTOR2_CONSTEXPR Vector2 operator * (float f, const Vector2 &v) {return Vector2(f * v.x, f * v.y);}
+
+    VECTOR2_CONSTEXPR bool operator == (const Vector2 &v) const {return x == v.x && y == v.y;}
+    VECTOR2_CONSTEXPR bool operator != (const Vector2 &v) const {return x != v.x || y != v.y;}
+};
+
+static_assert(sizeof(Vector2) == 2*sizeof(float), "Vector2 must match D3DXVECTOR2");
+
+// Name used by the game code
+typedef Vector2 VECTOR2;
+
+// Return Dot product of vectors v1 and v2.
+inline VECTOR2_CONSTEXPR float vector2Dot(const Vector2 &v1, const Vector2 &v2)
+{
+    return v1.x*v2.x + v1.y*v2.y;
+}
+
+// Return squared length of vector v.
+inline VECTOR2_CONSTEXPR float vector2LengthSq(const Vector2 &v)
+{
+    return v.x*v.x + v.y*v.y;
+}
+
+// Return length of vector v.
+inline float vector2Length(const Vector2 &v)
+{
+    return sqrtf(vector2LengthSq(v));
+}
+
+// Normalize vector v. A zero length vector is left unchanged.
+inline void vector2Normalize(Vector2 &v)
+{
+    float length = vector2Length(v);
+    if(length > 0.0f)
+        v /= length;
+}
+
+#endif
@@ -4,6 +4,7 @@
 #define WIN32_LEAN_AND_MEAN
 
 #include "image.h"
+#include "vector2.h"
 #include "input.h"
 #include "game.h"
 
@@ -26,7 +27,8 @@ class Entity : public Image
     // left and top are typically negative numbers
     RECT    edge;           // for BOX and ROTATED_BOX collision detection
     VECTOR2 corners[4];     // for ROTATED_BOX collision detection
-    VECTOR2 edge01,edge03;  // edges used for projection
+    VECTOR2 edge01,edge03;  // unit edges used for projection, rotated x and y axes
+    float   edgeAngle;      // angle edge01 and edge03 were computed for
     float   edge01Min, edge01Max, edge03Min, edge03Max; // min and max projections
     VECTOR2 velocity;       // velocity
     VECTOR2 deltaV;         // added to velocity during next call to update()
@@ -40,6 +42,7 @@ class Entity : public Image
     HRESULT hr;             // standard return type
     bool    active;         // only active entities may collide
     bool    rotatedBoxReady;    // true when rotated collision box is ready
+    bool    edgesReady;         // true when edge01 and edge03 match edgeAngle
 
     // --- The following functions are protected because they are not intended to be
     // --- called from outside the class.
@@ -183,6 +186,10 @@ class Entity : public Image
 
     // Adds the gravitational force to the velocity vector of this entity
     void gravityForce(Entity *other, float frameTime);
+
+    // Adds the gravitational force of a point mass at x,y, such as a
+    // gravity well, to the velocity vector of this entity
+    void gravityForce(float x, float y, float pointMass, float frameTime);
 };
 
 #endif
@@ -0,0 +1,217 @@
+#include "interpolation.h"
+#include "spacewar.h"
+using namespace interpolationNS;
+
+//=============================================================================
+// Return a + (b - a) * t
+//=============================================================================
+static float lerp(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+//=============================================================================
+// Return the heading t of the way from a to b, turning the short way round
+//=============================================================================
+static float lerpAngle(float a, float b, float t)
+{
+    float turn = b - a;
+    while (turn > PI)
+        turn -= (float)PIx2;
+    while (turn < -PI)
+        turn += (float)PIx2;
+    return a + turn * t;
+}
+
+//=============================================================================
+// Return true if moving from a to b crossed a screen edge, the ship or
+// torpedo wrapped around and must not be drawn across the screen
+//=============================================================================
+static bool wrapped(float ax, float ay, float bx, float by)
+{
+    return fabs(bx - ax) > GAME_WIDTH/2 || fabs(by - ay) > GAME_HEIGHT/2;
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Interpolation::Interpolation()
+{
+    times.resize(SNAPSHOTS);
+    torpedoCounts.resize(SNAPSHOTS);
+    playerCount = 0;
+    torpedoLimit = 0;
+    delay = DELAY;
+    reset();
+}
+
+//=============================================================================
+// Forget all snapshots
+//=============================================================================
+void Interpolation::reset()
+{
+    first = 0;
+    count = 0;
+    clock = 0;
+    older = newer = 0;
+    fraction = 0;
+    extrapolation = 0;
+}
+
+//=============================================================================
+// Keep data, the game state at server time in ms
+//=============================================================================
+void Interpolation::add(UINT time, const ToClientStc &data)
+{
+    double t = time / 1000.0;
+    if (data.playerCount != playerCount)    // new server or match size
+    {
+        playerCount = data.playerCount;
+        torpedoLimit = playerCount * spacewarNS::PLAYER_TORPEDOS;
+        ships.resize(SNAPSHOTS * playerCount);
+        torpedos.resize(SNAPSHOTS * torpedoLimit);
+        reset();
+    }
+    if (count > 0 && t <= getTime(count-1))
+    {
+        if (getTime(count-1) - t < RESYNC_TIME)
+            return;             // not newer than one held
+        reset();                // the server started over
+    }
+
+    // the snapshot arrived just now, pull the clock a little way towards it
+    if (count == 0 || fabs(t - clock) > RESYNC_TIME)
+        clock = t;
+    else
+        clock += (t - clock) * CLOCK_CORRECTION;
+
+    if (count == SNAPSHOTS)     // drop the oldest
+    {
+        first = (first + 1) % SNAPSHOTS;
+        count--;
+    }
+    times[(first + count) % SNAPSHOTS] = t;
+    count++;
+    int slot = getSlot(count-1);
+    for (int i=0; i<playerCount; i++)
+        ships[slot + i] = data.player[i].shipData;
+    // SnapshotHistory::read gives them in id order, no more than torpedoLimit
+    slot = getTorpedoSlot(count-1);
+    for (int n=0; n<data.torpedoCount; n++)
+        torpedos[slot + n] = data.torpedo[n];
+    torpedoCounts[(first + count-1) % SNAPSHOTS] = data.torpedoCount;
+}
+
+//=============================================================================
+// Advance the clock and find the snapshots either side of the time shown
+//=============================================================================
+void Interpolation::update(float frameTime)
+{
+    clock += frameTime;
+    if (count == 0)
+        return;
+    double shown = clock - delay;
+    fraction = 0;
+    extrapolation = 0;
+    if (shown >= getTime(count-1))              // past the newest
+    {
+        older = newer = count-1;
+        extrapolation = (float)(shown - getTime(count-1));
+        if (extrapolation > MAX_EXTRAPOLATION)
+            extrapolation = MAX_EXTRAPOLATION;
+        return;
+    }
+    if (shown <= getTime(0))                    // before the oldest
+    {
+        older = newer = 0;
+        return;
+    }
+    newer = count-1;
+    while (getTime(newer-1) > shown)
+        newer--;
+    older = newer-1;
+    fraction = (float)((shown - getTime(older)) / (getTime(newer) - getTime(older)));
+}
+
+//=============================================================================
+// Get player n's ship at the time shown
+//=============================================================================
+bool Interpolation::sample(int n, ShipStc &ship)
+{
+    if (count == 0 || n >= playerCount)
+        return false;
+    const ShipStc &a = ships[getSlot(older) + n];
+    const ShipStc &b = ships[getSlot(newer) + n];
+
+    // flags, health and score change when the older snapshot says so
+    ship = a;
+    if ((a.flags & b.flags & spacewarNS::SHIP_ACTIVE_BIT) && !wrapped(a.X, a.Y, b.X, b.Y))   // active in both
+    {
+        ship.X = lerp(a.X, b.X, fraction);
+        ship.Y = lerp(a.Y, b.Y, fraction);
+        ship.radians = lerpAngle(a.radians, b.radians, fraction);
+        ship.velocity.x = lerp(a.velocity.x, b.velocity.x, fraction);
+        ship.velocity.y = lerp(a.velocity.y, b.velocity.y, fraction);
+        ship.rotation = lerp(a.rotation, b.rotation, fraction);
+    }
+
+    if (extrapolation > 0 && (ship.flags & spacewarNS::SHIP_ACTIVE_BIT))   // no newer snapshot yet, carry on
+    {
+        ship.X += ship.velocity.x * extrapolation;
+        ship.Y += ship.velocity.y * extrapolation;
+        ship.radians += ship.rotation * extrapolation;
+    }
+    return true;
+}
+
+//=============================================================================
+// Get the torpedos in flight at the time shown, returns how many
+// Each torpedo of the older snapshot moves towards the same id in the newer
+// one. One that the newer snapshot no longer has is carried on along its
+// velocity, torpedos only the newer one has are not fired yet.
+//=============================================================================
+int Interpolation::sampleTorpedos(TorpedoStc *torpedo)
+{
+    if (count == 0)
+        return 0;
+    const TorpedoStc *a = &torpedos[getTorpedoSlot(older)];
+    const TorpedoStc *b = &torpedos[getTorpedoSlot(newer)];
+    int aCount = getTorpedoCount(older);
+    int bCount = getTorpedoCount(newer);
+    // seconds from the older snapshot to the time shown
+    float elapsed = fraction * (float)(getTime(newer) - getTime(older)) + extrapolation;
+    for (int i=0, j=0; i<aCount; i++)
+    {
+        while (j < bCount && b[j].id < a[i].id)
+            j++;
+        TorpedoStc &t = torpedo[i];
+        t = a[i];
+        if (j < bCount && b[j].id == a[i].id && !wrapped(a[i].X, a[i].Y, b[j].X, b[j].Y))
+        {
+            t.X = lerp(a[i].X, b[j].X, fraction);
+            t.Y = lerp(a[i].Y, b[j].Y, fraction);
+            t.velocity.x = lerp(a[i].velocity.x, b[j].velocity.x, fraction);
+            t.velocity.y = lerp(a[i].velocity.y, b[j].velocity.y, fraction);
+            t.X += t.velocity.x * extrapolation;
+            t.Y += t.velocity.y * extrapolation;
+        }
+        else
+        {
+            t.X += t.velocity.x * elapsed;
+            t.Y += t.velocity.y * elapsed;
+        }
+    }
+    return aCount;
+}
+
+//=============================================================================
+// Set the playout delay in seconds
+//=============================================================================
+void Interpolation::setDelay(float d)
+{
+    if (d < 0)
+        d = 0;
+    if (d > MAX_DELAY)
+        d = MAX_DELAY;
+    delay = d;
+}
@@ -0,0 +1,89 @@
+#ifndef _INTERPOLATION_H        // Prevent multiple definitions if this
+#define _INTERPOLATION_H        // file is included in more than one place
+#define WIN32_LEAN_AND_MEAN
+
+#include <vector>
+#include "ship.h"
+#include "torpedo.h"
+
+struct ToClientStc;
+
+// Snapshot interpolation of the ships and torpedos the client does not fly
+// Every game state from the server is kept with its server time. The client
+// shows the game as it was a playout delay behind its estimate of the
+// server's clock, between the two snapshots either side of that time, so
+// a late or lost packet is covered by the snapshots already held instead
+// of making everything jump. When no newer snapshot has arrived the last
+// one is carried on along its velocities, for MAX_EXTRAPOLATION at most.
+
+namespace interpolationNS
+{
+    const int   SNAPSHOTS = 32;             // snapshots kept, about 1s at 30 per second
+    const float DELAY = 0.1f;               // default playout delay, seconds
+    const float MAX_DELAY = 1.0f;           // longest playout delay, seconds
+    const float MAX_EXTRAPOLATION = 0.25f;  // seconds carried on past the newest snapshot
+    const float CLOCK_CORRECTION = 0.05f;   // part of the clock error removed per snapshot
+    const float RESYNC_TIME = 1.0f;         // clock errors beyond this start over, seconds
+}
+
+class Interpolation
+{
+private:
+    std::vector<double> times;      // ring of snapshot server times, seconds
+    std::vector<ShipStc> ships;     // playerCount per snapshot
+    std::vector<TorpedoStc> torpedos;   // torpedoLimit per snapshot, in id order
+    std::vector<int> torpedoCounts; // torpedos in flight in each snapshot
+    int     playerCount;
+    int     torpedoLimit;           // PLAYER_TORPEDOS per player
+    int     first;                  // oldest snapshot
+    int     count;                  // snapshots held
+    double  clock;                  // estimated server time now, seconds
+    float   delay;                  // playout delay, seconds
+    int     older, newer;           // snapshots either side of the time shown
+    float   fraction;               // 0 at older to 1 at newer
+    float   extrapolation;          // seconds past the newest snapshot
+
+    int     getSlot(int n) const    {return ((first + n) % interpolationNS::SNAPSHOTS) * playerCount;}
+    double  getTime(int n) const    {return times[(first + n) % interpolationNS::SNAPSHOTS];}
+    int     getTorpedoSlot(int n) const {return ((first + n) % interpolationNS::SNAPSHOTS) * torpedoLimit;}
+    int     getTorpedoCount(int n) const {return torpedoCounts[(first + n) % interpolationNS::SNAPSHOTS];}
+
+public:
+    // Constructor
+    Interpolation();
+
+    // Forget all snapshots, for a new connection
+    void reset();
+
+    // Keep data, the game state at server time in ms
+    void add(UINT time, const ToClientStc &data);
+
+    // Advance the clock by frameTime and find the snapshots to show
+    // Call once per frame before sample()
+    void update(float frameTime);
+
+    // Get player n's ship at the time shown
+    // Post: returns false if there is no snapshot of player n
+    bool sample(int n, ShipStc &ship);
+
+    // Get the torpedos in flight at the time shown, matched between
+    // snapshots by id
+    // Pre: torpedo holds spacewarNS::MAX_TORPEDOS
+    // Post: returns the number of torpedos
+    int  sampleTorpedos(TorpedoStc *torpedo);
+
+    // Set the playout delay in seconds, 0 to MAX_DELAY
+    void setDelay(float d);
+
+    // Return the playout delay in seconds
+    float getDelay() const          {return delay;}
+
+    // Return seconds the time shown is past the newest snapshot, 0 while
+    // it is between two
+    float getExtrapolation() const  {return extrapolation;}
+
+    // Return snapshots held
+    int  getCount() const           {return count;}
+};
+
+#endif
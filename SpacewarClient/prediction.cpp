@@ -0,0 +1,122 @@
+#include "prediction.h"
+#include "spacewar.h"
+using namespace predictionNS;
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Prediction::Prediction()
+{
+    frames.resize(FRAMES);
+    error = 0;
+    gravityFlags = spacewarNS::GRAVITY_ON_BIT;
+    reset();
+}
+
+//=============================================================================
+// Forget all frames
+//=============================================================================
+void Prediction::reset()
+{
+    first = 0;
+    count = 0;
+}
+
+//=============================================================================
+// Set ship's engine and rotation from buttons
+//=============================================================================
+void Prediction::applyButtons(Ship &ship, UCHAR buttons)
+{
+    ship.setEngineOn((buttons & spacewarNS::FORWARD_BIT) != 0);
+    ship.rotate(shipNS::NONE);
+    if (buttons & spacewarNS::LEFT_BIT)
+        ship.rotate(shipNS::LEFT);
+    if (buttons & spacewarNS::RIGHT_BIT)
+        ship.rotate(shipNS::RIGHT);
+}
+
+//=============================================================================
+// Record a frame, the oldest is dropped when the ring is full
+//=============================================================================
+void Prediction::add(USHORT input, UCHAR buttons, float frameTime)
+{
+    if (count == FRAMES)
+    {
+        first = (first + 1) % FRAMES;
+        count--;
+    }
+    Frame &frame = frames[(first + count) % FRAMES];
+    frame.input = input;
+    frame.buttons = buttons;
+    frame.frameTime = frameTime;
+    count++;
+}
+
+//=============================================================================
+// Pull with the gravity of game state
+//=============================================================================
+void Prediction::setGravity(const ToClientStc &state, int self)
+{
+    gravityFlags = state.gravity.flags;
+    sources.assign(state.gravity.well, state.gravity.well + state.gravity.wellCount);
+    if (!(gravityFlags & spacewarNS::MUTUAL_GRAVITY_BIT))
+        return;
+    // the other ships and torpedos where this game state has them
+    WellStc body;
+    for (int i=0; i<state.playerCount; i++)
+    {
+        const ShipStc &shipData = state.player[i].shipData;
+        if (i == self || !(shipData.flags & spacewarNS::SHIP_ACTIVE_BIT))     // if ours or not active
+            continue;
+        body.x = shipData.X + shipNS::WIDTH/2;
+        body.y = shipData.Y + shipNS::HEIGHT/2;
+        body.mass = shipNS::MASS;
+        sources.push_back(body);
+    }
+    for (int n=0; n<state.torpedoCount; n++)
+    {
+        body.x = state.torpedo[n].X + torpedoNS::WIDTH/2;
+        body.y = state.torpedo[n].Y + torpedoNS::HEIGHT/2;
+        body.mass = torpedoNS::MASS;
+        sources.push_back(body);
+    }
+}
+
+//=============================================================================
+// Add the pull of planet and the gravity sources to ship
+// Nothing pulls when gravity is off, as on the server.
+//=============================================================================
+void Prediction::applyGravity(Ship &ship, Entity &planet, float frameTime) const
+{
+    if (!(gravityFlags & spacewarNS::GRAVITY_ON_BIT))
+        return;
+    ship.gravityForce(&planet, frameTime);
+    for (size_t n=0; n<sources.size(); n++)
+        ship.gravityForce(sources[n].x, sources[n].y, sources[n].mass, frameTime);
+}
+
+//=============================================================================
+// Rewind ship to the server's state and replay the frames after lastInput
+//=============================================================================
+void Prediction::reconcile(Ship &ship, const ShipStc &state, Entity &planet, USHORT lastInput)
+{
+    float x = ship.getX(), y = ship.getY();     // predicted
+    ship.setNetData(state);
+
+    // frames sent with lastInput or before are in the server's state
+    while (count > 0 && (short)(frames[first].input - lastInput) <= 0)
+    {
+        first = (first + 1) % FRAMES;
+        count--;
+    }
+
+    for (int n=0; n<count; n++)
+    {
+        const Frame &frame = frames[(first + n) % FRAMES];
+        applyButtons(ship, frame.buttons);
+        applyGravity(ship, planet, frame.frameTime);
+        ship.move(frame.frameTime);
+    }
+    float dx = ship.getX() - x, dy = ship.getY() - y;
+    error = sqrtf(dx*dx + dy*dy);
+}
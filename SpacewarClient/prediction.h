@@ -0,0 +1,73 @@
+#ifndef _PREDICTION_H           // Prevent multiple definitions if this
+#define _PREDICTION_H           // file is included in more than one place
+#define WIN32_LEAN_AND_MEAN
+
+#include <vector>
+#include "ship.h"
+
+// Client side prediction of the player's own ship
+// Each frame the ship is moved at once by the buttons held, instead of a
+// round trip later when the server's game state comes back, and the frame
+// is recorded with the sequence of the input that will carry its buttons.
+// Every game state from the server says which input it had applied last.
+// The ship is put back where the server had it, and the frames after that
+// input are replayed with the same physics, so the prediction keeps up
+// with the player while the server stays in charge. The gravity each game
+// state carries, wells and mutual gravity included, is the pull used.
+
+namespace predictionNS
+{
+    const int FRAMES = 512;         // frames kept for replay, over 1s at 500 fps
+}
+
+class Prediction
+{
+private:
+    // One predicted frame
+    struct Frame
+    {
+        USHORT  input;          // sequence of the input that sends these buttons
+        UCHAR   buttons;
+        float   frameTime;
+    };
+    std::vector<Frame> frames;  // ring of the frames the server has not confirmed
+    int     first;              // oldest frame
+    int     count;              // frames held
+    float   error;              // distance moved by the last reconcile, pixels
+    UCHAR   gravityFlags;       // GravityStc flags of the newest game state
+    // wells, and with mutual gravity the other ships and torpedos
+    std::vector<WellStc> sources;
+
+public:
+    // Constructor
+    Prediction();
+
+    // Forget all frames, for a new connection or a ship that is not flying
+    void reset();
+
+    // Set ship's engine and rotation from buttons, as the server does
+    static void applyButtons(Ship &ship, UCHAR buttons);
+
+    // Record a frame of frameTime flown with buttons, to be sent by input
+    void add(USHORT input, UCHAR buttons, float frameTime);
+
+    // Pull with the gravity of game state, self = our player, not a
+    // source of mutual gravity on its own ship
+    void setGravity(const ToClientStc &state, int self);
+
+    // Add the pull of planet and the gravity sources to ship, as the server does
+    void applyGravity(Ship &ship, Entity &planet, float frameTime) const;
+
+    // Set ship to state, the server's with lastInput applied, and replay
+    // the frames after lastInput on it, the frames before are dropped
+    // planet = gravity source, with the sources of setGravity
+    void reconcile(Ship &ship, const ShipStc &state, Entity &planet, USHORT lastInput);
+
+    // Return how far the last reconcile moved the ship from its prediction, pixels
+    float getError() const      {return error;}
+
+    // Return frames waiting for the server
+    int  getCount() const       {return count;}
+};
+
+#endif
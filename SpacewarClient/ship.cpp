@@ -87,6 +87,17 @@ void Ship::draw()
 // frameTime is used to regulate the speed of movement and animation
 //=============================================================================
 void Ship::update(float frameTime)
+{
+    animate(frameTime);
+    move(frameTime);
+}
+
+//=============================================================================
+// animate
+// Run the ship, explosion, shield and engine animations, the part of update
+// that does not move the ship
+//=============================================================================
+void Ship::animate(float frameTime)
 {
     if(explosionOn)
     {
@@ -110,14 +121,33 @@ void Ship::update(float frameTime)
         }
     }
 
+    if(engineOn)
+        engine.update(frameTime);
+
+    Image::update(frameTime);
+    rotatedBoxReady = false;    // for rotatedBox collision detection
+}
+
+//=============================================================================
+// move
+// Thrust, turn and move the ship, the physics of update without animation,
+// so it can also replay predicted frames
+//=============================================================================
+void Ship::move(float frameTime)
+{
+    velocity += deltaV;                         // gravity, if update has not
+    deltaV.x = 0;
+    deltaV.y = 0;
     if(engineOn)
     {
         velocity.x += (float)cos(spriteData.angle) * shipNS::SPEED * frameTime;
         velocity.y += (float)sin(spriteData.angle) * shipNS::SPEED * frameTime;
-        engine.update(frameTime);
     }
+    // no faster than a snapshot can carry
+    float speed = (float)sqrt(velocity.x*velocity.x + velocity.y*velocity.y);
+    if (speed > shipNS::MAX_SPEED)
+        velocity *= shipNS::MAX_SPEED / speed;
 
-    Entity::update(frameTime);
     oldX = spriteData.x;                        // save current position
     oldY = spriteData.y;
     oldAngle = spriteData.angle;
@@ -215,11 +245,12 @@ void Ship::setNetData(ShipStc ss)
     setHealth(ss.health);
     setVelocity(ss.velocity);
     setRotation(ss.rotation);
-    setActive((ss.flags & 0x01) == 0x01);
+    setActive((ss.flags & spacewarNS::SHIP_ACTIVE_BIT) != 0);
     if(active)
         visible = true;
-    setEngineOn((ss.flags & 0x02) == 0x02);
-    setShieldOn((ss.flags & 0x04) == 0x04);
+    setEngineOn((ss.flags & spacewarNS::SHIP_ENGINE_BIT) != 0);
+    setShieldOn((ss.flags & spacewarNS::SHIP_SHIELD_BIT) != 0);
+    setConnected((ss.flags & spacewarNS::SHIP_CONNECTED_BIT) != 0);
     if(health <= 0 && explosionOn == false && visible) // if ship destroyed
         explode();
 }
@@ -238,16 +269,14 @@ ShipStc Ship::getNetData()
     data.rotation = getRotation();
     data.score = getScore();
     data.playerN = getPlayerN();
-    //-----flags-----
-    // bit0 active
-    // bit1 engineOn
-    // bit2 shieldOn
     data.flags = 0;
     if(getActive())
-        data.flags |= 0x01;
+        data.flags |= spacewarNS::SHIP_ACTIVE_BIT;
     if(getEngineOn())
-        data.flags |= 0x02;
+        data.flags |= spacewarNS::SHIP_ENGINE_BIT;
     if(getShieldOn())
-        data.flags |= 0x04;
+        data.flags |= spacewarNS::SHIP_SHIELD_BIT;
+    if(getConnected())
+        data.flags |= spacewarNS::SHIP_CONNECTED_BIT;
     return data;
 }
@@ -5,6 +5,8 @@
 
 #include "entity.h"
 #include "constants.h"
+#include "protocol.h"
+#include "packetLink.h"
 
 namespace shipNS
 {
@@ -14,6 +16,7 @@ namespace shipNS
     const int   Y = GAME_HEIGHT/6 - HEIGHT;
     const float ROTATION_RATE = (float)PI; // radians per second
     const float SPEED = 100;                // 100 pixels per second
+    const float MAX_SPEED = 1000;           // pixels per second, inside a snapshot's velocity range
     const float MASS = 300.0f;              // mass
     enum DIRECTION {NONE, LEFT, RIGHT};     // rotation direction
     const int   TEXTURE_COLS = 8;           // texture has 8 columns
@@ -35,24 +38,6 @@ namespace shipNS
     const float SHIP_DAMAGE = 10;           // damage caused by collision with another ship
 }
 
-// ShipStc contains all of the information a network client needs for a ship.
-struct ShipStc 
-{
-    float X;
-    float Y;
-    float radians;
-    float health;
-    VECTOR2 velocity;
-    float rotation;             // rotation rate (radians/second)
-    short score;
-    UCHAR playerN;              // which player (255 is request to join)
-    //-----flags-----
-    // bit0 active              // true when player is active
-    // bit1 engineOn
-    // bit2 shieldOn
-    UCHAR flags;                // boolean status flags
-};
-
 // inherits from Entity class
 class Ship : public Entity
 {
@@ -75,7 +60,7 @@ private:
     bool    connected;
     UCHAR   buttons;        // current key presses
                             // bit 0=Left, 1=Forward, 2=Right, 3=Fire
-    u_long  packetNumber;   // used to detect out of order packets
+    PacketLink link;        // sequence numbers and acks of this player's packets
     UCHAR   playerN;        // our player number
     int     commWarnings;   // count of communication warnings
     int     commErrors;     // count of communication errors
@@ -92,6 +77,12 @@ public:
     // update ship position and angle
     void update(float frameTime);
 
+    // run the ship's animations without moving it, for a ship placed by the server
+    void animate(float frameTime);
+
+    // thrust, turn and move the ship without animating it
+    void move(float frameTime);
+
     // damage ship with WEAPON
     void damage(WEAPON);
 
@@ -130,8 +121,8 @@ public:
     // Return buttons
     UCHAR getButtons()      {return buttons;}
 
-    // Return packetNumber
-    u_long getPacketNumber() {return packetNumber;}
+    // Return the sequence numbers, acks and statistics of this player's packets
+    PacketLink &getLink()   {return link;}
 
     // Return Ship Data
     ShipStc getNetData();
@@ -143,7 +134,7 @@ public:
     int getCommWarnings()   {return commWarnings;}
 
     // Return commErrors
-    int getCommErrors()     {return commWarnings;}
+    int getCommErrors()     {return commErrors;}
 
     // Return explosionOn
     bool getExplosionOn()   {return explosionOn;}
@@ -175,9 +166,6 @@ public:
     // Set buttons
     void setButtons(UCHAR b)        {buttons = b;}
 
-    // Set packetNumber
-    void setPacketNumber(u_long n)  {packetNumber = n;}
-
     // Set commWarnings
     void setCommWarnings(int w)     {commWarnings = w;}
 
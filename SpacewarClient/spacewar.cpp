@@ -1,6 +1,7 @@
 // This class is the core of the game
 
 #include "spaceWar.h"
+#include "bitStream.h"
 using namespace spacewarNS;
 
 //=============================================================================
@@ -15,6 +16,8 @@ Spacewar::Spacewar()
     remotePort = netNS::DEFAULT_PORT;
     netTime = 0;
     playerN = 0;                // assigned by server
+    sessionToken = 0;           // assigned by server
+    playerLimit = 2;            // updated by each game state from server
     error     = netNS::NET_OK; 
     lastError = netNS::NET_OK; 
     sizeXmit=0;                 // transmit size
@@ -27,6 +30,7 @@ Spacewar::Spacewar()
     buttonState = 0;
     soundState = 0;
     gameState = 0;
+    torpedoCount = 0;           // none until the server shows one
 }
 
 //=============================================================================
@@ -49,6 +53,7 @@ void Spacewar::initialize(HWND hwnd)
     fontBig.initialize(graphics, spacewarNS::FONT_BIG_SIZE, false, false, spacewarNS::FONT);
     fontBig.setFontColor(spacewarNS::FONT_COLOR);
     fontScore.initialize(graphics, spacewarNS::FONT_SCORE_SIZE, false, false, spacewarNS::FONT);
+    fontLabel.initialize(graphics, spacewarNS::FONT_LABEL_SIZE, false, false, spacewarNS::FONT);
 
     // menu texture
     if (!menuTexture.initialize(graphics,MENU_IMAGE))
@@ -74,39 +79,41 @@ void Spacewar::initialize(HWND hwnd)
     if (!planet.initialize(this, planetNS::WIDTH, planetNS::HEIGHT, 2, &gameTextures))
         throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing planet"));
 
-    // ship1
-    if (!ship[0].initialize(this, shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing ship1"));
-
-    ship[0].setFrames(shipNS::SHIP1_START_FRAME, shipNS::SHIP1_END_FRAME);
-    ship[0].setCurrentFrame(shipNS::SHIP1_START_FRAME);
-    ship[0].setColorFilter(SETCOLOR_ARGB(255,230,230,255));   // light blue, used for shield and torpedo
-    ship[0].setMass(shipNS::MASS);
-
-    // ship2
-    if (!ship[1].initialize(this, shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing ship2"));
-
-    ship[1].setFrames(shipNS::SHIP2_START_FRAME, shipNS::SHIP2_END_FRAME);
-    ship[1].setCurrentFrame(shipNS::SHIP2_START_FRAME);
-    ship[1].setColorFilter(SETCOLOR_ARGB(255,255,255,64));    // light yellow, used for shield
-    ship[1].setMass(shipNS::MASS);
-
-    // torpedo1
-    if (!torpedo[0].initialize(this, torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing torpedo1"));
-
-    torpedo[0].setFrames(torpedoNS::START_FRAME, torpedoNS::END_FRAME);
-    torpedo[0].setCurrentFrame(torpedoNS::START_FRAME);
+    // torpedos, one image for the even players' torpedos and one for the odd
+    for (int i=0; i<2; i++)
+    {
+        if (!torpedo[i].initialize(this, torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS, &gameTextures))
+            throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing torpedo"));
+        torpedo[i].setFrames(torpedoNS::START_FRAME, torpedoNS::END_FRAME);
+        torpedo[i].setCurrentFrame(torpedoNS::START_FRAME);
+    }
     torpedo[0].setColorFilter(SETCOLOR_ARGB(255,128,128,255));   // light blue
+    torpedo[1].setColorFilter(SETCOLOR_ARGB(255,255,255,64));    // light yellow
 
-    // torpedo2
-    if (!torpedo[1].initialize(this, torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing torpedo2"));
-
-    torpedo[1].setFrames(torpedoNS::START_FRAME, torpedoNS::END_FRAME);
-    torpedo[1].setCurrentFrame(torpedoNS::START_FRAME);
-    torpedo[1].setColorFilter(SETCOLOR_ARGB(255,255,255,64));     // light yellow
+    // ships, even players use the ship1 image and colors, odd players use ship2
+    for (int i=0; i<MAX_PLAYERS; i++)
+    {
+        if (!ship[i].initialize(this, shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS, &gameTextures))
+            throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing ship"));
+        ship[i].setMass(shipNS::MASS);
+        if (i % 2 == 0)
+        {
+            ship[i].setFrames(shipNS::SHIP1_START_FRAME, shipNS::SHIP1_END_FRAME);
+            ship[i].setCurrentFrame(shipNS::SHIP1_START_FRAME);
+            ship[i].setColorFilter(SETCOLOR_ARGB(255,230,230,255));   // light blue, used for shield and torpedo
+        }
+        else
+        {
+            ship[i].setFrames(shipNS::SHIP2_START_FRAME, shipNS::SHIP2_END_FRAME);
+            ship[i].setCurrentFrame(shipNS::SHIP2_START_FRAME);
+            ship[i].setColorFilter(SETCOLOR_ARGB(255,255,255,64));    // light yellow, used for shield
+        }
+        if (i >= 2)             // shown when the server sends a larger game
+        {
+            ship[i].setActive(false);
+            ship[i].setVisible(false);
+        }
+    }
 
     // health bar
     healthBar.initialize(graphics, &gameTextures, 0, spacewarNS::HEALTHBAR_Y, 2.0f, graphicsNS::WHITE);
@@ -144,6 +151,7 @@ void Spacewar::roundStart()
 void Spacewar::update()
 {
     buttonState = 0;        // clear network button state
+    interpolation.update(frameTime);
 
     if (menuOn)
     {
@@ -165,31 +173,44 @@ void Spacewar::update()
     } 
     else 
     {
-        for (int i=0; i<MAX_PLAYERS; i++)       // for all players
+        // if engine on
+        if (input->isKeyDown(SHIP_FORWARD_KEY)  || input->getGamepadDPadUp(1)) 
+            buttonState |= FORWARD_BIT;
+        // if turn ship left
+        if (input->isKeyDown(SHIP_LEFT_KEY) || input->getGamepadDPadLeft(1))
+            buttonState |= LEFT_BIT;
+        // if turn ship right
+        if (input->isKeyDown(SHIP_RIGHT_KEY) || input->getGamepadDPadRight(1))
+            buttonState |= RIGHT_BIT;
+        // if ship fire
+        if (input->isKeyDown(SHIP_FIRE_KEY) || input->getGamepadA(1))
+            buttonState |= FIRE_BIT;
+
+        for (int i=0; i<playerLimit; i++)       // for all players
+        {
+            if (playerN == i && ship[i].getActive())    // if we are flying ship i
+            {
+                // fly it now, the server's state will confirm it later
+                Prediction::applyButtons(ship[i], buttonState);
+                prediction.add(link.getNextSequence(), buttonState, frameTime);
+                prediction.applyGravity(ship[i], planet, frameTime);
+                ship[i].update(frameTime);
+            }
+            else                                // the server moves it
+                ship[i].animate(frameTime);
+        }
+        torpedo[0].animate(frameTime);
+        torpedo[1].animate(frameTime);
+
+        // show the other ships and all torpedos where the server had them,
+        // a playout delay ago
+        ShipStc shipData;
+        for (int i=0; i<playerLimit && interpolation.sample(i, shipData); i++)
         {
-            if (playerN == i)       // if we are player i
-                // if engine on
-                if (input->isKeyDown(SHIP_FORWARD_KEY)  || input->getGamepadDPadUp(1)) 
-                    buttonState |= FORWARD_BIT;
-
-            ship[i].rotate(shipNS::NONE);
-            // if turn ship left
-            if (input->isKeyDown(SHIP_LEFT_KEY) || input->getGamepadDPadLeft(1))
-                buttonState |= LEFT_BIT;
-            // if turn ship right
-            if (input->isKeyDown(SHIP_RIGHT_KEY) || input->getGamepadDPadRight(1))
-                buttonState |= RIGHT_BIT;
-
-            // if ship fire
-            if (input->isKeyDown(SHIP_FIRE_KEY) || input->getGamepadA(1))
-                buttonState |= FIRE_BIT;
-            ship[i].gravityForce(&planet, frameTime);
-            torpedo[i].gravityForce(&planet, frameTime);
-
-            // Update the entities
-            ship[i].update(frameTime);
-            torpedo[i].update(frameTime);
+            if (playerN != i)
+                ship[i].setNetData(shipData);
         }
+        torpedoCount = interpolation.sampleTorpedos(torpedoData);
     }
     planet.update(frameTime);
 }
@@ -232,11 +253,29 @@ void Spacewar::render()
     healthBar.set(ship[1].getHealth());
     healthBar.draw(spacewarNS::SHIP2_COLOR);
 
-    ship[0].draw();                           // draw the spaceships
-    ship[1].draw();
+    // ships after the first two show their score above the ship
+    for (int i=2; i<MAX_PLAYERS; i++)
+    {
+        if (!ship[i].getVisible())
+            continue;
+        if (i % 2 == 0)
+            fontLabel.setFontColor(spacewarNS::SHIP1_COLOR);
+        else
+            fontLabel.setFontColor(spacewarNS::SHIP2_COLOR);
+        _snprintf_s(buffer, spacewarNS::BUF_SIZE, "%d", ship[i].getScore());
+        fontLabel.print(buffer, (int)ship[i].getX(), (int)ship[i].getY() - spacewarNS::FONT_LABEL_SIZE);
+    }
 
-    torpedo[0].draw(graphicsNS::FILTER);      // draw the torpedos using colorFilter
-    torpedo[1].draw(graphicsNS::FILTER);
+    for (int i=0; i<MAX_PLAYERS; i++)
+        ship[i].draw();                         // draw the spaceships
+
+    // draw the torpedos using colorFilter, each through its owner's image
+    for (int n=0; n<torpedoCount; n++)
+    {
+        Torpedo &image = torpedo[torpedoData[n].owner % 2];
+        image.setNetData(torpedoData[n]);
+        image.draw(graphicsNS::FILTER);
+    }
 
     if(menuOn)
         menu.draw();
@@ -266,6 +305,8 @@ void Spacewar::consoleCommand()
         console->print("~ - show/hide console");
         console->print("fps - toggle display of frames per second");
         console->print("connect - connect to game server");
+        console->print("link - display packet loss, reordering, duplicates and prediction");
+        console->print("delay # - show other ships # ms behind the server, default 100");
         return;
     }
     else if (command == "fps")
@@ -278,6 +319,34 @@ void Spacewar::consoleCommand()
     }
     else if (command == "connect")
         tryToConnect = true;        // connect to game server
+    else if (command == "link")
+    {
+        console->print(link.getStatsString());
+        std::stringstream ss;
+        ss << "prediction " << prediction.getCount() << " frames, last correction "
+           << prediction.getError() << " px";
+        console->print(ss.str());
+        ss.str("");
+        ss << "interpolation " << interpolation.getCount() << " game states, delay "
+           << (int)(interpolation.getDelay()*1000) << " ms, extrapolating "
+           << (int)(interpolation.getExtrapolation()*1000) << " ms";
+        console->print(ss.str());
+    }
+    else if (command.substr(0,5) == "delay")
+    {
+        int ms = -1;
+        if(command.size() > 6)
+            ms = atoi(command.substr(6).c_str());
+        if(ms >= 0 && ms <= interpolationNS::MAX_DELAY*1000)
+        {
+            interpolation.setDelay(ms / 1000.0f);
+            std::stringstream ss;
+            ss << "Playout delay " << ms << " ms";
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid delay");
+    }
 }
 
 //=============================================================================
@@ -290,6 +359,7 @@ void Spacewar::releaseAll()
     nebulaTexture.onLostDevice();
     gameTextures.onLostDevice();
     fontScore.onLostDevice();
+    fontLabel.onLostDevice();
     fontBig.onLostDevice();
 
     Game::releaseAll();
@@ -304,6 +374,7 @@ void Spacewar::resetAll()
 {
     fontBig.onResetDevice();
     fontScore.onResetDevice();
+    fontLabel.onResetDevice();
     gameTextures.onResetDevice();
     nebulaTexture.onResetDevice();
     menuTexture.onResetDevice();
@@ -415,9 +486,18 @@ void Spacewar::connectToServer()
         // send request to join the server
         console->print("Attempting to connect with server."); // display message
         toServerData.playerN = 255;        // playerN=255 is request to join
-        size = sizeof(toServerData);
+        toServerData.token = 0;
+        toServerData.ack = 0;
+        toServerData.delay = 0;
+        snapshots.initialize(0);           // forget the last server's snapshots
+        link.reset();
+        prediction.reset();
+        interpolation.reset();
+        link.stamp(toServerData.header);
+        writeToServer(toServerData, message);
+        size = messageNS::TO_SERVER_SIZE;
         console->print("'Request to join' sent to server.");
-        error = net.sendData((char*) &toServerData, size, remoteIP, port);
+        error = net.sendData(message, size, remoteIP, port);
         console->print(net.getError(error));
         waitTime = 0;
         step = 4;
@@ -434,11 +514,11 @@ void Spacewar::connectToServer()
             return;
         }
         // read ConnectResponse from server
-        size = sizeof(connectResponse);
-        error = net.readData((char*)&connectResponse, size, remoteIP, remotePort);
+        size = messageNS::CONNECT_RESPONSE_SIZE;
+        error = net.readData(message, size, remoteIP, remotePort);
         if (error == netNS::NET_OK)     // if read was OK
         {
-            if(size == 0)   // if no data received
+            if(!readConnectResponse(message, size, connectResponse))   // if no response received
                 return;
             // if the server sent back the proper ID then we are connected
             if (strcmp(connectResponse.response, netNS::SERVER_ID) == 0) 
@@ -446,6 +526,7 @@ void Spacewar::connectToServer()
                 if (connectResponse.number < MAX_PLAYERS)   // if valid player number
                 {
                     playerN = connectResponse.number;       // set my player number
+                    sessionToken = connectResponse.token;   // proves the input is ours
                     ss << "Connected as player number: " << playerN;
                     console->print(ss.str());
                     clientConnected = true;
@@ -497,9 +578,15 @@ void Spacewar::sendInfoToServer()
     // prepare structure to be sent
     toServerData.buttons = buttonState;
     toServerData.playerN = playerN;
+    toServerData.token = sessionToken;
+    toServerData.ack = snapshots.getNewest();   // server sends changes from this one
+    // the server judges our torpedos against the ships as we show them
+    toServerData.delay = (USHORT)(interpolation.getDelay() * 1000 + 0.5f);
+    link.stamp(toServerData.header);
     // send data from client to server
-    size = sizeof(toServerData);
-    error = net.sendData((char*) &toServerData, size, remoteIP, remotePort);
+    writeToServer(toServerData, message);
+    size = messageNS::TO_SERVER_SIZE;
+    error = net.sendData(message, size, remoteIP, remotePort);
 }
 
 //=============================================================================
@@ -509,16 +596,60 @@ void Spacewar::sendInfoToServer()
 void Spacewar::getInfoFromServer()
 {
     int size;
-    size = sizeof(toClientData);
-    int readStatus = net.readData((char *)&toClientData, size, remoteIP, remotePort);
+    size = sizeof(packet);
+    int readStatus = net.readData(packet, size, remoteIP, remotePort);
     if( readStatus == netNS::NET_OK && size > 0) 
     {
-        for(int i=0; i<MAX_PLAYERS; i++)        // for all player positions
+        PacketHeader header;
+        if(!PacketLink::readHeader(packet, size, header))
+        {
+            commWarnings++;
+            return;
+        }
+        // ignore a duplicate or a game state older than the one shown
+        if(!link.receive(header))
+        {
+            if(++commWarnings <= netNS::MAX_COMM_WARNINGS)
+                return;
+            // so many in a row, the server must have started over
+            link.resync();
+            link.receive(header);
+        }
+        // ignore a short or malformed game state, or a delta from a lost one
+        if(size < snapshotNS::PREFIX_SIZE ||
+           !snapshots.read(packet + snapshotNS::PREFIX_SIZE,
+                           size - snapshotNS::PREFIX_SIZE, toClientData))
+        {
+            commWarnings++;
+            return;
+        }
+        // our newest input the server had applied to this game state
+        BitReader tag(packet + packetLinkNS::HEADER_SIZE, 2);
+        USHORT lastInput = (USHORT)tag.read(16);
+        playerLimit = toClientData.playerCount;
+        // other ships and the torpedos are shown from here by update()
+        interpolation.add(snapshots.getNewestTime(), toClientData);
+        prediction.setGravity(toClientData, playerN);
+        if(playerN < playerLimit)
         {
-            // load new data into each ship and torpedo
-            ship[i].setNetData(toClientData.player[i].shipData);
+            // load new data into our ship
+            if(lastInput != 0 &&
+               (toClientData.player[playerN].shipData.flags & SHIP_ACTIVE_BIT))   // if active
+                // replay what the server has not seen yet on top of its state
+                prediction.reconcile(ship[playerN], toClientData.player[playerN].shipData,
+                                     planet, lastInput);
+            else
+            {
+                prediction.reset();
+                ship[playerN].setNetData(toClientData.player[playerN].shipData);
+            }
+        }
+        for(int i=0; i<playerLimit; i++)        // for all player positions
             ship[i].setScore(toClientData.player[i].shipData.score);
-            torpedo[i].setNetData(toClientData.player[i].torpedoData);
+        for(int i=playerLimit; i<MAX_PLAYERS; i++)  // positions not in this game
+        {
+            ship[i].setActive(false);
+            ship[i].setVisible(false);
         }
 
         // Game state
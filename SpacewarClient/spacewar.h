@@ -5,6 +5,7 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
 #include "game.h"
 #include "textureManager.h"
 #include "image.h"
@@ -13,12 +14,17 @@
 #include "ship.h"
 #include "torpedo.h"
 #include "net.h"
+#include "packetLink.h"
+#include "protocol.h"
+#include "prediction.h"
+#include "interpolation.h"
 
 namespace spacewarNS
 {
     const char FONT[] = "Arial Bold";  // font
     const int FONT_BIG_SIZE = 256;     // font height
     const int FONT_SCORE_SIZE = 48;
+    const int FONT_LABEL_SIZE = 16;    // score shown above ships 3 and up
     const COLOR_ARGB FONT_COLOR = graphicsNS::YELLOW;
     const COLOR_ARGB SHIP1_COLOR = graphicsNS::BLUE;
     const COLOR_ARGB SHIP2_COLOR = graphicsNS::YELLOW;
@@ -42,74 +48,12 @@ namespace spacewarNS
     const int LOCAL = 0;            // two players on same computer
     const int CLIENT = 1;           // client in network game
     const int SERVER = 2;           // server in network game
-    const int MAX_PLAYERS = 2;      // maximum number of network players
     // Network
     const int BUFSIZE = 256;
-    const int LEFT_BIT = 0x01;      // player buttons
-    const int FORWARD_BIT = 0x02;
-    const int RIGHT_BIT = 0x04;
-    const int FIRE_BIT = 0x08;
     const int CONNECT_TIMEOUT = 10; // seconds to wait when connecting
     const int JOIN_TIME = 5;        // seconds between join attempts
-    // Game State bits
-    const int ROUND_START_BIT = 0x01;
-    // Network, sounds for client to play
-    const int ENGINE1_BIT       = 0x01; // Bit 0 = engine1      1=on, 0=off
-    const int ENGINE2_BIT       = 0x02; // Bit 1 = engine2      1=on, 0=off
-    const int CHEER_BIT         = 0x04; // Bit 2 = cheer        state change
-    const int COLLIDE_BIT       = 0x08; // Bit 3 = collide      state change
-    const int EXPLODE_BIT       = 0x10; // Bit 4 = explode      state change
-    const int TORPEDO_CRASH_BIT = 0x20; // Bit 5 = torpedoCrash state change
-    const int TORPEDO_FIRE_BIT  = 0x40; // Bit 6 = torpedoFire  state change
-    const int TORPEDO_HIT_BIT   = 0x80; // Bit 7 = torpedoHit   state change
 }
 
-//=============================================================================
-// network play structures
-//=============================================================================
-
-// Sent to client in response to connection request
-struct ConnectResponse
-{
-    char response[netNS::RESPONSE_SIZE];    // server response
-    UCHAR   number;                         // player number if connected
-};
-
-// Player describes the ship and torpedo for one player.
-struct Player
-{
-    ShipStc     shipData;
-    TorpedoStc  torpedoData;
-};
-
-// ToClientStc is the structure that is sent from the server to each client. 
-struct ToClientStc 
-{
-    Player  player[spacewarNS::MAX_PLAYERS];
-    // game state
-    // Bit 0 = roundStart
-    // Bits 1-7 reserved for future use
-    UCHAR   gameState;
-    // sound to play   
-    // Bit 0 = cheer        state change
-    // Bit 1 = collide      state change
-    // Bit 2 = explode      state change
-    // Bit 3 = engine1      1=on, 0=off
-    // Bit 4 = engine2      1=on, 0=off
-    // Bit 5 = torpedoCrash state change
-    // Bit 6 = torpedoFire  state change
-    // Bit 7 = torpedoHit   state change
-    UCHAR   sounds;
-};
-
-// ToServerStc is the structure that is sent from the client to the server.
-struct ToServerStc 
-{
-    // current key presses
-    UCHAR buttons;      // bit 0=Left, 1=Forward, 2=Right, 3=Fire
-    UCHAR playerN;      // player number
-};
-
 //=============================================================================
 // Spacewar is the class we create, it inherits from the Game class
 //=============================================================================
@@ -119,7 +63,9 @@ private:
     // game items
     TextureManager menuTexture, nebulaTexture, gameTextures;   // textures
     Ship    ship[spacewarNS::MAX_PLAYERS];      // spaceships
-    Torpedo torpedo[spacewarNS::MAX_PLAYERS];   // torpedos
+    Torpedo torpedo[2];         // draws the torpedos, [0] for even players, [1] for odd
+    TorpedoStc torpedoData[spacewarNS::MAX_TORPEDOS];   // torpedos where the server had them
+    int     torpedoCount;       // torpedos in torpedoData
     Planet  planet;             // the planet
     Image   nebula;             // backdrop image
     Image   menu;               // menu image
@@ -129,11 +75,13 @@ private:
     float   countDownTimer;
     TextDX  fontBig;            // DirectX font for game banners
     TextDX  fontScore;
+    TextDX  fontLabel;          // small font for scores above ships
     char    buffer[spacewarNS::BUF_SIZE];
     bool    roundOver;          // true when round is over
     float   roundTimer;         // time until new round starts
-    int     ship1Score, ship2Score; // scores
     int     playerN;            // our player number
+    UINT    sessionToken;       // sent with every input, assigned by server
+    int     playerLimit;        // players in a full game, sent by server
 
     // Network variables
     Net  net;                   // network object
@@ -150,8 +98,16 @@ private:
     int sizeRecv;               // receive size
     int size;
     ToClientStc toClientData;   // data struct sent to client from server
+    char packet[snapshotNS::MAX_PACKET_SIZE];   // header and snapshot as received
+    SnapshotHistory snapshots;  // snapshots received, baselines for deltas
+    PacketLink link;            // sequence numbers and acks of packets with the server
+    Prediction prediction;      // our ship's frames the server has not confirmed
+    Interpolation interpolation;    // game states received, shown a playout delay behind
     ToServerStc toServerData;   // data struct sent to server from client
     ConnectResponse connectResponse;
+    // toServerData or connectResponse as sent
+    char message[messageNS::TO_SERVER_SIZE > messageNS::CONNECT_RESPONSE_SIZE ?
+                 messageNS::TO_SERVER_SIZE : messageNS::CONNECT_RESPONSE_SIZE];
     UINT commErrors;
     UINT commWarnings;
     bool tryToConnect;
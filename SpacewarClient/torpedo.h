@@ -5,6 +5,7 @@
 
 #include "entity.h"
 #include "constants.h"
+#include "protocol.h"
 
 namespace torpedoNS
 {
@@ -21,15 +22,6 @@ namespace torpedoNS
     const float ANIMATION_DELAY = 0.1f; // time between frames
 }
 
-// TorpedoStc contains all of the information a client needs for one torpedo.
-struct TorpedoStc 
-{
-    float X;
-    float Y;
-    VECTOR2 velocity;
-    bool  active;                       // true when active
-};
-
 // inherits from Entity class
 class Torpedo : public Entity
 {
@@ -50,6 +42,9 @@ public:
     // Return torpedo data
     TorpedoStc getNetData();
 
+    // run the torpedo animation without moving it, for a torpedo placed by the server
+    void animate(float frameTime)   {Image::update(frameTime);}
+
     // Set fired bool
     void setFired(bool f)   {fired = f;}
 
@@ -0,0 +1,37 @@
+#ifndef _BENCHTIME_H            // Prevent multiple definitions if this
+#define _BENCHTIME_H            // file is included in more than one place
+
+#include <time.h>
+
+// Timing shared by the benchmarks
+
+//=============================================================================
+// Return the time of clock in seconds, monotonic time by default
+//=============================================================================
+static inline double now(clockid_t clock = CLOCK_MONOTONIC)
+{
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//=============================================================================
+// Call pass until at least repeatTime seconds have passed.
+// Returns seconds per call.
+//=============================================================================
+template <class Pass>
+static double timePass(Pass pass, double repeatTime)
+{
+    int runs = 0;
+    double start = now();
+    double elapsed;
+    do
+    {
+        pass();
+        runs++;
+        elapsed = now() - start;
+    } while (elapsed < repeatTime);
+    return elapsed / runs;
+}
+
+#endif
@@ -0,0 +1,128 @@
+// Collision cost vs. entity count
+// Usage: collision-bench [-n max_entities] [-d density] [-r repeat_ms]
+//
+// Places ships at random in a world that grows with the entity count so the
+// number of neighbours stays the same, then times one collision pass:
+//   brute  every pair tested with Entity::collidesWith, as Spacewar did
+//   sweep  Broadphase SWEEP candidates tested with collidesWith
+//   grid   Broadphase GRID candidates tested with collidesWith
+// Each method must find the same collisions as brute.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "ship.h"
+#include "broadphase.h"
+#include "benchTime.h"
+
+//=============================================================================
+// Test every pair, returns number of collisions
+//=============================================================================
+static int brutePass(std::vector<Ship> &ships)
+{
+    VECTOR2 collisionVector;
+    int hits = 0;
+    int count = (int)ships.size();
+    for (int i=0; i<count; i++)
+        for (int j=i+1; j<count; j++)
+            if (ships[i].collidesWith(ships[j], collisionVector))
+                hits++;
+    return hits;
+}
+
+//=============================================================================
+// Broadphase then exact test, returns number of collisions
+// candidates = number of pairs returned by the broadphase
+//=============================================================================
+static int broadphasePass(std::vector<Ship> &ships, Broadphase &broadphase, int &candidates)
+{
+    VECTOR2 collisionVector;
+    int hits = 0;
+    broadphase.clear();
+    for (size_t i=0; i<ships.size(); i++)
+    {
+        Ship &s = ships[i];
+        float radius = (float)(s.getWidth() > s.getHeight() ? s.getWidth() : s.getHeight())
+                       * s.getScale() * 0.7072f;
+        broadphase.add(s.getCenterX(), s.getCenterY(), radius);
+    }
+    const std::vector<BroadphasePair> &pairs = broadphase.findPairs();
+    for (size_t n=0; n<pairs.size(); n++)
+        if (ships[pairs[n].a].collidesWith(ships[pairs[n].b], collisionVector))
+            hits++;
+    candidates = (int)pairs.size();
+    return hits;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxCount = 10000;
+    float density = 1.0f / (64*64);     // entities per square pixel
+    double repeatTime = 0.2;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            maxCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+            density = 1.0f / (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+            repeatTime = atof(argv[++i]) / 1000.0;
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n max_entities] [-d pixels_per_entity] [-r repeat_ms]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%8s %7s %12s %12s %12s %10s %8s\n",
+           "entities", "world", "brute(us)", "sweep(us)", "grid(us)", "pairs", "hits");
+
+    const int counts[] = {2, 10, 64, 100, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+    for (size_t c=0; c<sizeof(counts)/sizeof(counts[0]) && counts[c] <= maxCount; c++)
+    {
+        int count = counts[c];
+        float side = sqrtf(count / density);
+        if (side < GAME_WIDTH)
+            side = (float)GAME_WIDTH;
+        std::vector<Ship> ships(count);
+        srand(1);
+        for (int i=0; i<count; i++)
+        {
+            ships[i].initialize(shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS);
+            ships[i].setX(side * rand() / RAND_MAX);
+            ships[i].setY(side * rand() / RAND_MAX);
+            ships[i].setRadians(6.28f * rand() / RAND_MAX);
+        }
+
+        Broadphase sweep, grid;
+        sweep.initialize(side, side, broadphaseNS::SWEEP);
+        grid.initialize(side, side, broadphaseNS::GRID);
+        int bruteHits = 0, sweepHits = 0, gridHits = 0, candidates = 0;
+
+        // brute force is skipped where one pass would take seconds
+        double bruteUs = -1;
+        if (count <= 10000)
+            bruteUs = timePass([&]{bruteHits = brutePass(ships);}, repeatTime) * 1e6;
+        double sweepUs = timePass([&]{sweepHits = broadphasePass(ships, sweep, candidates);},
+                                  repeatTime) * 1e6;
+        double gridUs = timePass([&]{gridHits = broadphasePass(ships, grid, candidates);},
+                                 repeatTime) * 1e6;
+
+        if (bruteUs >= 0 && (sweepHits != bruteHits || gridHits != bruteHits))
+        {
+            printf("MISMATCH at %d entities: brute %d sweep %d grid %d\n",
+                   count, bruteHits, sweepHits, gridHits);
+            return 1;
+        }
+        if (bruteUs >= 0)
+            printf("%8d %7d %12.1f %12.1f %12.1f %10d %8d\n",
+                   count, (int)side, bruteUs, sweepUs, gridUs, candidates, gridHits);
+        else
+            printf("%8d %7d %12s %12.1f %12.1f %10d %8d\n",
+                   count, (int)side, "-", sweepUs, gridUs, candidates, gridHits);
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+// Gravity throughput and accuracy
+// Usage: gravity-bench [-n max_bodies] [-r repeat_ms] [-s orbit_seconds]
+//
+// Throughput: bodies per second pulled by one planet using
+//   entity  Entity::gravityForce on each body, as Spacewar did
+//   batch   GravityBatch::step on bodies already packed
+// Accuracy: ships on orbits around the planet are flown with each method
+// and the largest distance between the two trajectories is reported.
+// N-body: mutual gravity between all bodies, summed directly and with the
+// Barnes-Hut tree, with the tree's error relative to the direct sum.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "ship.h"
+#include "planet.h"
+#include "gravityBatch.h"
+#include "benchTime.h"
+
+//=============================================================================
+// Put ship on an orbit around planet at radius r, speed = circular * factor
+//=============================================================================
+static void startOrbit(Ship &ship, Planet &planet, float r, float factor)
+{
+    ship.initialize(shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS);
+    ship.setX(planet.getCenterX() + r - ship.getWidth()/2.0f);
+    ship.setY(planet.getCenterY() - ship.getHeight()/2.0f);
+    float speed = sqrtf(entityNS::GRAVITY * planet.getMass() * ship.getMass() / r) * factor;
+    ship.setVelocity(VECTOR2(0, -speed));
+}
+
+//=============================================================================
+// Add resting ships at bx,by to batch with mutual gravity
+//=============================================================================
+static void addCloud(GravityBatch &batch, const std::vector<float> &bx,
+                     const std::vector<float> &by, float theta, int threshold)
+{
+    batch.setMutual(true);
+    batch.setTheta(theta);
+    batch.setTreeThreshold(threshold);
+    for (size_t i=0; i<bx.size(); i++)
+        batch.add(bx[i], by[i], 0, 0, entityNS::GRAVITY, shipNS::MASS);
+}
+
+int main(int argc, char *argv[])
+{
+    int maxCount = 100000;
+    double repeatTime = 0.2;
+    float orbitTime = 60;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            maxCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+            repeatTime = atof(argv[++i]) / 1000.0;
+        else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+            orbitTime = (float)atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n max_bodies] [-r repeat_ms] [-s orbit_seconds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Planet planet;
+    planet.initialize(planetNS::WIDTH, planetNS::HEIGHT, planetNS::TEXTURE_COLS);
+    const float frameTime = 1.0f / 120;
+
+    printf("kernel %s\n", simdNS::KERNEL);
+    printf("%8s %16s %16s %8s\n", "bodies", "entity(Mbody/s)", "batch(Mbody/s)", "speedup");
+    const int counts[] = {64, 1000, 10000, 100000, 1000000};
+    for (size_t c=0; c<sizeof(counts)/sizeof(counts[0]) && counts[c] <= maxCount; c++)
+    {
+        int count = counts[c];
+        std::vector<Ship> ships(count);
+        GravityBatch batch;
+        batch.addPlanet(planet.getCenterX(), planet.getCenterY(), planet.getMass());
+        srand(1);
+        for (int i=0; i<count; i++)
+        {
+            ships[i].initialize(shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS);
+            ships[i].setX((float)GAME_WIDTH * rand() / RAND_MAX);
+            ships[i].setY((float)GAME_HEIGHT * rand() / RAND_MAX);
+            batch.add(ships[i].getCenterX(), ships[i].getCenterY(), 0, 0,
+                      ships[i].getGravity(), ships[i].getMass());
+        }
+        double entityTime = timePass([&]{
+            for (int i=0; i<count; i++)
+                ships[i].gravityForce(&planet, frameTime);
+        }, repeatTime);
+        double batchTime = timePass([&]{batch.step(frameTime);}, repeatTime);
+        printf("%8d %16.1f %16.1f %7.1fx\n", count,
+               count / entityTime * 1e-6, count / batchTime * 1e-6, entityTime / batchTime);
+    }
+
+    // Fly the same orbits with both methods
+    printf("\n%8s %8s %10s %14s\n", "radius", "speed", "seconds", "max error(px)");
+    const float radius[] = {GAME_WIDTH/4.0f, GAME_WIDTH/4.0f + 60, GAME_WIDTH/4.0f - 60, GAME_WIDTH/4.0f};
+    const float factor[] = {1.0f, 1.0f, 1.0f, 0.8f};
+    for (int n=0; n<4; n++)
+    {
+        Ship a, b;
+        startOrbit(a, planet, radius[n], factor[n]);
+        startOrbit(b, planet, radius[n], factor[n]);
+        GravityBatch batch;
+        batch.addPlanet(planet.getCenterX(), planet.getCenterY(), planet.getMass());
+        float maxError = 0;
+        int ticks = (int)(orbitTime / frameTime);
+        for (int t=0; t<ticks; t++)
+        {
+            a.gravityForce(&planet, frameTime);
+            a.update(frameTime);
+
+            batch.clear();
+            VECTOR2 v = b.getVelocity();
+            batch.add(b.getCenterX(), b.getCenterY(), v.x, v.y, b.getGravity(), b.getMass());
+            batch.step(frameTime);
+            b.setVelocity(VECTOR2(batch.getVelocityX(0), batch.getVelocityY(0)));
+            b.update(frameTime);
+
+            float dx = a.getCenterX() - b.getCenterX();
+            float dy = a.getCenterY() - b.getCenterY();
+            float error = sqrtf(dx*dx + dy*dy);
+            if (error > maxError)
+                maxError = error;
+        }
+        printf("%8.0f %7.0f%% %10.0f %14.4f\n", radius[n], factor[n]*100, orbitTime, maxError);
+    }
+
+    // Mutual gravity, direct sum vs. Barnes-Hut
+    printf("\n%8s %6s %12s %12s %8s %12s\n", "bodies", "theta", "direct(us)", "tree(us)", "speedup", "rms error");
+    const int nbody[] = {100, 300, 1000, 3000, 10000, 30000};
+    const float thetas[] = {0.3f, 0.5f, 0.8f};
+    for (size_t c=0; c<sizeof(nbody)/sizeof(nbody[0]) && nbody[c] <= maxCount; c++)
+    {
+        int count = nbody[c];
+        std::vector<float> bx(count), by(count);
+        srand(2);
+        for (int i=0; i<count; i++)
+        {
+            bx[i] = (float)GAME_WIDTH * rand() / RAND_MAX;
+            by[i] = (float)GAME_HEIGHT * rand() / RAND_MAX;
+        }
+        GravityBatch direct;
+        addCloud(direct, bx, by, 0, count + 1);
+        double directTime = timePass([&]{direct.step(frameTime);}, repeatTime);
+        // bodies start at rest so the velocity after one step is the pull
+        GravityBatch directOnce;
+        addCloud(directOnce, bx, by, 0, count + 1);
+        directOnce.step(frameTime);
+
+        for (size_t t=0; t<sizeof(thetas)/sizeof(thetas[0]); t++)
+        {
+            GravityBatch tree;
+            addCloud(tree, bx, by, thetas[t], 0);
+            double treeTime = timePass([&]{tree.step(frameTime);}, repeatTime);
+            GravityBatch treeOnce;
+            addCloud(treeOnce, bx, by, thetas[t], 0);
+            treeOnce.step(frameTime);
+
+            double err = 0, ref = 0;
+            for (int i=0; i<count; i++)
+            {
+                double ex = treeOnce.getVelocityX(i) - directOnce.getVelocityX(i);
+                double ey = treeOnce.getVelocityY(i) - directOnce.getVelocityY(i);
+                err += ex*ex + ey*ey;
+                ref += (double)directOnce.getVelocityX(i) * directOnce.getVelocityX(i)
+                     + (double)directOnce.getVelocityY(i) * directOnce.getVelocityY(i);
+            }
+            printf("%8d %6.1f %12.1f %12.1f %7.1fx %11.4f%%\n", count, thetas[t],
+                   directTime * 1e6, treeTime * 1e6, directTime / treeTime,
+                   100 * sqrt(err / ref));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+// Server network load with thousands of clients over loopback
+// Usage: load-bench [-c clients] [-t ticks] [-s snapshot_size] [-p port]
+//
+// Each tick every client sends one input datagram to the server, a wave at
+// a time with the server reading after each wave, then the server answers
+// every client with a snapshot, the way Spacewar::communicate does. Only
+// the server side is timed, in thread CPU time and wall time, using
+//   recvfrom  Net::readData and Net::sendData, one system call per datagram
+//   sockets   Net::readBatch and Net::sendBatch, recvmmsg and sendmmsg
+//   epoll     the EPOLL engine, snapshots sent by Net::flush
+//   uring     the URING engine, multishot receive and one submit per flush
+// Snapshots an engine could not send are counted as dropped.
+// The clients read their snapshots after each tick, untimed. Left unread,
+// thousands of full receive buffers use up the kernel's UDP memory and it
+// starts dropping the inputs as well.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <sys/resource.h>
+#include "net.h"
+#include "benchTime.h"
+
+namespace loadBenchNS
+{
+    const int WAVE = 64;            // inputs sent between server reads, fits the socket buffer
+}
+
+// Server time spent and datagrams moved by one method
+struct Result
+{
+    double cpu, wall;
+    long received, sent, dropped, delivered;
+};
+
+//=============================================================================
+// Run ticks ticks of clients sending to server and the server answering
+//=============================================================================
+static Result run(Net &server, int method, std::vector<Net> &clients, USHORT serverPort,
+                  int ticks, int snapshotSize)
+{
+    int count = (int)clients.size();
+    const char input[16] = "input";
+    std::vector<char> snapshot(snapshotSize, 's');
+    std::vector<char> in(count * 64);
+    std::vector<NetPacket> inPacket(count), outPacket(count);
+    std::vector<char> ip(count * netNS::ADDRESS_SIZE);     // recvfrom senders as text
+    std::vector<USHORT> port(count);
+    std::vector<char> clientIn(netNS::MAX_BATCH * snapshotSize);
+    NetPacket clientPacket[netNS::MAX_BATCH];
+    Result r = {0, 0, 0, 0, 0, 0};
+    long dropped = server.getDropped();
+
+    for (int tick=0; tick<ticks; tick++)
+    {
+        // inputs arrive in waves through the tick, the server reads each wave
+        double cpu = 0, wall = 0;
+        int received = 0;
+        for (int first=0; first<count; first+=loadBenchNS::WAVE)
+        {
+            int last = first + loadBenchNS::WAVE < count ? first + loadBenchNS::WAVE : count;
+            for (int c=first; c<last; c++)
+            {
+                int size = sizeof(input);
+                clients[c].sendData(input, size, "127.0.0.1", serverPort);
+            }
+
+            double cpuStart = now(CLOCK_THREAD_CPUTIME_ID);
+            double wallStart = now(CLOCK_MONOTONIC);
+            int idle = 0;
+            while (received < last && idle < 100)   // uring completions may trail the sends
+            {
+                int got = 0;
+                if (method < 0)
+                {
+                    int size = 64;
+                    server.readData(&in[received * 64], size,
+                                    &ip[received * netNS::ADDRESS_SIZE], port[received]);
+                    got = size > 0;
+                }
+                else
+                {
+                    got = count - received;
+                    for (int n=0; n<got; n++)
+                    {
+                        inPacket[received + n].data = &in[(received + n) * 64];
+                        inPacket[received + n].size = 64;
+                    }
+                    server.readBatch(&inPacket[received], got);
+                }
+                received += got;
+                idle = got ? 0 : idle + 1;
+            }
+            cpu += now(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+            wall += now(CLOCK_MONOTONIC) - wallStart;
+        }
+
+        // then answers every client at the end of the tick
+        double cpuStart = now(CLOCK_THREAD_CPUTIME_ID);
+        double wallStart = now(CLOCK_MONOTONIC);
+        int sent = 0;
+        if (method < 0)
+        {
+            for (int n=0; n<received; n++)
+            {
+                int size = snapshotSize;
+                server.sendData(&snapshot[0], size, &ip[n * netNS::ADDRESS_SIZE], port[n]);
+                if (size > 0)
+                    sent++;
+            }
+        }
+        else
+        {
+            for (int n=0; n<received; n++)
+            {
+                outPacket[n].data = &snapshot[0];
+                outPacket[n].size = snapshotSize;
+                outPacket[n].address = inPacket[n].address;
+            }
+            sent = received;
+            server.sendBatch(&outPacket[0], sent);
+            server.flush();
+            sent -= (int)(server.getDropped() - dropped);
+            r.dropped += server.getDropped() - dropped;
+            dropped = server.getDropped();
+        }
+        r.cpu += cpu + now(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+        r.wall += wall + now(CLOCK_MONOTONIC) - wallStart;
+        r.received += received;
+        r.sent += sent;
+
+        for (int c=0; c<count; c++)
+        {
+            int got;
+            do
+            {
+                got = netNS::MAX_BATCH;
+                for (int n=0; n<got; n++)
+                {
+                    clientPacket[n].data = &clientIn[n * snapshotSize];
+                    clientPacket[n].size = snapshotSize;
+                }
+                clients[c].readBatch(clientPacket, got);
+                r.delivered += got;
+            } while (got == netNS::MAX_BATCH);
+        }
+    }
+    return r;
+}
+
+int main(int argc, char *argv[])
+{
+    int clientCount = 4000;
+    int ticks = 200;
+    int snapshotSize = 200;
+    int port = 48500;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i+1 < argc)
+            clientCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+            ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+            snapshotSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && i+1 < argc)
+            port = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-c clients] [-t ticks] [-s snapshot_size] [-p port]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // one descriptor per client
+    rlimit files;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < files.rlim_max)
+    {
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
+    }
+
+    std::vector<Net> clients(clientCount);
+    for (int c=0; c<clientCount; c++)
+    {
+        int status = clients[c].createServer(port + 1 + c, netNS::UDP);
+        if (status != netNS::NET_OK)
+        {
+            fprintf(stderr, "client %d: %s\n", c, clients[c].getError(status).c_str());
+            return 1;
+        }
+    }
+    USHORT serverPort = htons((USHORT)port);
+
+    printf("%d clients, %d ticks, %d byte snapshots over loopback\n",
+           clientCount, ticks, snapshotSize);
+    printf("%9s %12s %13s %11s %9s %9s %9s %10s\n", "method", "cpu us/tick", "wall us/tick",
+           "pkts/s cpu", "received", "sent", "dropped", "delivered");
+    for (int method=-1; method<netNS::ENGINES; method++)
+    {
+        Net server;
+        int status = server.createServer(port, netNS::UDP);
+        if (status != netNS::NET_OK)
+        {
+            fprintf(stderr, "%s\n", server.getError(status).c_str());
+            return 1;
+        }
+        const char *name = "recvfrom";
+        if (method >= 0)
+        {
+            int engine = server.setEngine(method);
+            if (engine != method)
+            {
+                printf("%9s not available\n", netNS::ENGINE_NAMES[method]);
+                continue;
+            }
+            name = netNS::ENGINE_NAMES[method];
+        }
+        run(server, method, clients, serverPort, 5, snapshotSize);    // warm up
+        Result r = run(server, method, clients, serverPort, ticks, snapshotSize);
+        printf("%9s %12.1f %13.1f %11.0f %9ld %9ld %9ld %10ld\n", name, r.cpu / ticks * 1e6,
+               r.wall / ticks * 1e6, (r.received + r.sent) / r.cpu, r.received, r.sent,
+               r.dropped, r.delivered);
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Loopback UDP throughput
+// Usage: net-bench [-n packets] [-s size] [-p port]
+//
+// Packets per second sent and received between two sockets on 127.0.0.1,
+// a burst at a time, using
+//   single  Net::sendData and Net::readData, one system call per packet
+//   batch   Net::sendBatch and Net::readBatch, up to MAX_BATCH packets per
+//           system call on Linux
+// The burst sizes match a server answering that many players in one frame.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "net.h"
+#include "benchTime.h"
+
+// Time spent and packets moved by one method
+struct Result
+{
+    double sendTime, readTime;
+    int sent, received;
+};
+
+//=============================================================================
+// Send packets in bursts of burst from one socket to the other, reading
+// each burst back before the next
+//=============================================================================
+static Result run(Net &from, Net &to, USHORT toPort, int packets, int size,
+                  int burst, bool batch)
+{
+    std::vector<char> out(size, 'x');
+    std::vector<char> in(burst * size);
+    std::vector<NetPacket> outPacket(burst), inPacket(burst);
+    Result r = {0, 0, 0, 0};
+
+    for (int n=0; n<burst; n++)
+    {
+        outPacket[n].data = &out[0];
+        outPacket[n].size = size;
+        from.makeAddress("127.0.0.1", toPort, outPacket[n].address);
+    }
+
+    while (r.sent < packets)
+    {
+        double start = now();
+        int sent = 0;
+        if (batch)
+        {
+            sent = burst;
+            from.sendBatch(&outPacket[0], sent);
+        }
+        else
+        {
+            for (int n=0; n<burst; n++)
+            {
+                int s = size;
+                from.sendData(&out[0], s, "127.0.0.1", toPort);
+                if (s > 0)
+                    sent++;
+            }
+        }
+        double middle = now();
+
+        int received = 0;
+        if (batch)
+        {
+            while (received < sent)
+            {
+                int count = sent - received;
+                for (int n=0; n<count; n++)
+                {
+                    inPacket[n].data = &in[n * size];
+                    inPacket[n].size = size;
+                }
+                to.readBatch(&inPacket[0], count);
+                if (count == 0)
+                    break;
+                received += count;
+            }
+        }
+        else
+        {
+            while (received < sent)
+            {
+                int s = size;
+                USHORT port;
+                char ip[netNS::IP_SIZE];
+                to.readData(&in[received * size], s, ip, port);
+                if (s == 0)
+                    break;
+                received++;
+            }
+        }
+        double end = now();
+
+        r.sendTime += middle - start;
+        r.readTime += end - middle;
+        r.sent += sent;
+        r.received += received;
+        if (sent == 0)          // socket will not take more
+            break;
+    }
+    return r;
+}
+
+int main(int argc, char *argv[])
+{
+    int packets = 1000000;
+    int size = 64;
+    int port = 48300;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            packets = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+            size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && i+1 < argc)
+            port = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n packets] [-s size] [-p port]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Net sender, receiver;
+    int status = sender.createServer(port, netNS::UDP);
+    if (status == netNS::NET_OK)
+        status = receiver.createServer(port + 1, netNS::UDP);
+    if (status != netNS::NET_OK)
+    {
+        fprintf(stderr, "%s\n", sender.getError(status).c_str());
+        return 1;
+    }
+    USHORT toPort = htons((USHORT)(port + 1));
+
+    printf("%d packets of %d bytes over loopback\n", packets, size);
+    printf("%6s %14s %14s %14s %14s %8s %8s\n", "burst", "single send/s", "batch send/s",
+           "single read/s", "batch read/s", "send x", "read x");
+    const int bursts[] = {1, 8, 64, 256};
+    for (size_t b=0; b<sizeof(bursts)/sizeof(bursts[0]); b++)
+    {
+        Result single = run(sender, receiver, toPort, packets, size, bursts[b], false);
+        Result batch = run(sender, receiver, toPort, packets, size, bursts[b], true);
+        if (single.received < single.sent || batch.received < batch.sent)
+            printf("lost %d single, %d batch\n", single.sent - single.received,
+                   batch.sent - batch.received);
+        double singleSend = single.sent / single.sendTime;
+        double batchSend = batch.sent / batch.sendTime;
+        double singleRead = single.received / single.readTime;
+        double batchRead = batch.received / batch.readTime;
+        printf("%6d %14.0f %14.0f %14.0f %14.0f %7.1fx %7.1fx\n", bursts[b],
+               singleSend, batchSend, singleRead, batchRead,
+               batchSend / singleSend, batchRead / singleRead);
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+// Rotated box (SAT) collision throughput
+// Usage: obb-bench [-n max_pairs] [-r repeat_ms] [-t turning_percent]
+//
+// Each pass moves every box, turns some of them and tests every pair, using
+//   legacy  Entity::collidesWith with the rotated box code as it was before
+//           the axes were cached: sin and cos twice each, two normalizes and
+//           four corners projected one at a time, copied here for comparison
+//   entity  Entity::collidesWith with ROTATED_BOX collision
+//   batch   ObbBatch::set for every box, then ObbBatch::collide on all pairs
+// The three are also checked to agree on which pairs collide.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "entity.h"
+#include "obbBatch.h"
+#include "benchTime.h"
+
+//=============================================================================
+// Random float from 0 to max
+//=============================================================================
+static float randomf(float max)
+{
+    return max * rand() / RAND_MAX;
+}
+
+//=============================================================================
+// Entity with the rotated box code as it was before the axes were cached
+//=============================================================================
+class LegacyEntity : public Entity
+{
+protected:
+    void legacyComputeRotatedBox()
+    {
+        if(rotatedBoxReady)
+            return;
+        float projection;
+
+        VECTOR2 rotatedX((float)cos(spriteData.angle), (float)sin(spriteData.angle));
+        VECTOR2 rotatedY((float)-sin(spriteData.angle), (float)cos(spriteData.angle));
+
+        const VECTOR2 *center = getCenter();
+        corners[0] = *center + rotatedX * ((float)edge.left*getScale())  +
+                               rotatedY * ((float)edge.top*getScale());
+        corners[1] = *center + rotatedX * ((float)edge.right*getScale()) +
+                               rotatedY * ((float)edge.top*getScale());
+        corners[2] = *center + rotatedX * ((float)edge.right*getScale()) +
+                               rotatedY * ((float)edge.bottom*getScale());
+        corners[3] = *center + rotatedX * ((float)edge.left*getScale())  +
+                               rotatedY * ((float)edge.bottom*getScale());
+
+        edge01 = VECTOR2(corners[1].x - corners[0].x, corners[1].y - corners[0].y);
+        vector2Normalize(edge01);
+        edge03 = VECTOR2(corners[3].x - corners[0].x, corners[3].y - corners[0].y);
+        vector2Normalize(edge03);
+
+        projection = vector2Dot(edge01, corners[0]);
+        edge01Min = projection;
+        edge01Max = projection;
+        projection = vector2Dot(edge01, corners[1]);
+        if (projection < edge01Min)
+            edge01Min = projection;
+        else if (projection > edge01Max)
+            edge01Max = projection;
+        projection = vector2Dot(edge03, corners[0]);
+        edge03Min = projection;
+        edge03Max = projection;
+        projection = vector2Dot(edge03, corners[3]);
+        if (projection < edge03Min)
+            edge03Min = projection;
+        else if (projection > edge03Max)
+            edge03Max = projection;
+
+        rotatedBoxReady = true;
+    }
+
+    bool legacyProjectionsOverlap(Entity &ent)
+    {
+        float projection, min01, max01, min03, max03;
+
+        projection = vector2Dot(edge01, *ent.getCorner(0));
+        min01 = projection;
+        max01 = projection;
+        for(int c=1; c<4; c++)
+        {
+            projection = vector2Dot(edge01, *ent.getCorner(c));
+            if (projection < min01)
+                min01 = projection;
+            else if (projection > max01)
+                max01 = projection;
+        }
+        if (min01 > edge01Max || max01 < edge01Min)
+            return false;
+
+        projection = vector2Dot(edge03, *ent.getCorner(0));
+        min03 = projection;
+        max03 = projection;
+        for(int c=1; c<4; c++)
+        {
+            projection = vector2Dot(edge03, *ent.getCorner(c));
+            if (projection < min03)
+                min03 = projection;
+            else if (projection > max03)
+                max03 = projection;
+        }
+        if (min03 > edge03Max || max03 < edge03Min)
+            return false;
+        return true;
+    }
+
+    // Pre: ent is also a LegacyEntity
+    virtual bool collideRotatedBox(Entity &ent, VECTOR2 &collisionVector)
+    {
+        LegacyEntity &other = static_cast<LegacyEntity&>(ent);
+        legacyComputeRotatedBox();
+        other.legacyComputeRotatedBox();
+        if (legacyProjectionsOverlap(other) && other.legacyProjectionsOverlap(*this))
+        {
+            collisionVector = *other.getCenter() - *getCenter();
+            return true;
+        }
+        return false;
+    }
+};
+
+//=============================================================================
+// Set up ent as a rotated box centered on x,y
+//=============================================================================
+static void initBox(Entity &ent, const RECT &edge, float x, float y, float angle)
+{
+    ent.initialize(edge.right - edge.left, edge.bottom - edge.top, 1);
+    ent.setCollisionType(entityNS::ROTATED_BOX);
+    ent.setEdge(edge);
+    ent.setX(x - edge.right);
+    ent.setY(y - edge.bottom);
+    ent.setRadians(angle);
+}
+
+//=============================================================================
+// Move every entity d pixels, turn one in turnEvery and test every pair
+//=============================================================================
+template <class Ent>
+static void entityPass(std::vector<Ent> &ent, const std::vector<int> &pairA,
+                       const std::vector<int> &pairB, float d, int turnEvery)
+{
+    for (size_t i=0; i<ent.size(); i++)
+    {
+        ent[i].setX(ent[i].getX() + d);
+        if (i % turnEvery == 0)
+            ent[i].setRadians(ent[i].getRadians() + d * 0.01f);
+        ent[i].update(0);           // clears the rotated box
+    }
+    VECTOR2 cv;
+    for (size_t n=0; n<pairA.size(); n++)
+        ent[pairA[n]].collidesWith(ent[pairB[n]], cv);
+}
+
+int main(int argc, char *argv[])
+{
+    int maxPairs = 100000;
+    double repeatTime = 0.2;
+    int turning = 25;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            maxPairs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+            repeatTime = atof(argv[++i]) / 1000.0;
+        else if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+            turning = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n max_pairs] [-r repeat_ms] [-t turning_percent]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    RECT edge;                      // 48x24 box centered on the entity
+    edge.left = -24;
+    edge.right = 24;
+    edge.top = -12;
+    edge.bottom = 12;
+
+    printf("kernel %s, %d%% of boxes turn each pass\n", simdNS::KERNEL, turning);
+    printf("%8s %6s %12s %12s %12s %9s %9s %10s\n", "pairs", "hits", "legacy(ns)", "entity(ns)",
+           "batch(ns)", "entity x", "batch x", "disagree");
+    const int counts[] = {100, 1000, 10000, 100000};
+    for (size_t c=0; c<sizeof(counts)/sizeof(counts[0]) && counts[c] <= maxPairs; c++)
+    {
+        int pairs = counts[c];
+        int boxes = pairs * 2;
+        std::vector<float> bx(boxes), by(boxes), ba(boxes);
+        std::vector<int> pairA(pairs), pairB(pairs);
+        std::vector<int> order(boxes);
+
+        // pairs of boxes close enough that about half of them touch,
+        // in shuffled order so the batch gathers from all over its arrays
+        srand(1);
+        for (int i=0; i<boxes; i++)
+            order[i] = i;
+        for (int i=boxes-1; i>0; i--)
+        {
+            int j = rand() % (i + 1);
+            int t = order[i]; order[i] = order[j]; order[j] = t;
+        }
+        for (int n=0; n<pairs; n++)
+        {
+            int i = order[2*n], j = order[2*n+1];
+            pairA[n] = i;
+            pairB[n] = j;
+            bx[i] = randomf((float)GAME_WIDTH);
+            by[i] = randomf((float)GAME_HEIGHT);
+            bx[j] = bx[i] + randomf(80) - 40;
+            by[j] = by[i] + randomf(80) - 40;
+            ba[i] = randomf(2*(float)PI);
+            ba[j] = randomf(2*(float)PI);
+        }
+
+        std::vector<LegacyEntity> legacy(boxes);
+        std::vector<Entity> entity(boxes);
+        ObbBatch batch;
+        for (int i=0; i<boxes; i++)
+        {
+            initBox(legacy[i], edge, bx[i], by[i], ba[i]);
+            initBox(entity[i], edge, bx[i], by[i], ba[i]);
+            batch.add(bx[i], by[i], ba[i], (float)edge.right, (float)edge.bottom);
+        }
+
+        // all three must find the same hits
+        std::vector<unsigned int> hitMask(ObbBatch::getMaskWords(pairs));
+        int hits = batch.collide(&pairA[0], &pairB[0], pairs, &hitMask[0]);
+        int disagree = 0;
+        for (int n=0; n<pairs; n++)
+        {
+            VECTOR2 cv;
+            bool l = legacy[pairA[n]].collidesWith(legacy[pairB[n]], cv);
+            bool e = entity[pairA[n]].collidesWith(entity[pairB[n]], cv);
+            bool b = (hitMask[n / obbBatchNS::MASK_BITS] >> (n % obbBatchNS::MASK_BITS)) & 1;
+            if (l != e || l != b)
+                disagree++;
+        }
+
+        // each pass moves every box by a pixel and turns some of them
+        int pass = 0;
+        int turnEvery = turning > 0 ? 100 / turning : boxes + 1;
+        double legacyTime = timePass([&]{
+            entityPass(legacy, pairA, pairB, (pass++ & 1) ? 1.0f : -1.0f, turnEvery);
+        }, repeatTime);
+        double entityTime = timePass([&]{
+            entityPass(entity, pairA, pairB, (pass++ & 1) ? 1.0f : -1.0f, turnEvery);
+        }, repeatTime);
+        double batchTime = timePass([&]{
+            float d = (pass++ & 1) ? 1.0f : -1.0f;
+            for (int i=0; i<boxes; i++)
+            {
+                bx[i] += d;
+                if (i % turnEvery == 0)
+                    ba[i] += d * 0.01f;
+                batch.set(i, bx[i], by[i], ba[i]);
+            }
+            batch.collide(&pairA[0], &pairB[0], pairs, &hitMask[0]);
+        }, repeatTime);
+
+        printf("%8d %6d %12.1f %12.1f %12.1f %8.1fx %8.1fx %10d\n", pairs, hits,
+               legacyTime / pairs * 1e9, entityTime / pairs * 1e9, batchTime / pairs * 1e9,
+               legacyTime / entityTime, legacyTime / batchTime, disagree);
+    }
+    return 0;
+}
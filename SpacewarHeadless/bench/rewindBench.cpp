@@ -0,0 +1,193 @@
+// Lag compensation budget and accuracy
+// Usage: rewind-bench [-t tickrate] [-m matches]
+//
+// For matches of 2 to 64 players reports what RewindHistory costs:
+//   bytes    memory held per match
+//   record   time to record every ship once per tick
+//   sweep    time to sweep one tick of a torpedo's move the whole window back
+//   cpu      share of one core per match, recording every tick with every
+//            ship's torpedo in flight and fired with a lag, and for all
+//            matches together
+// Then fires torpedos at ships flying straight past, aimed where the
+// shooter saw them a round trip and a playout delay ago, and counts the
+// hits when they are tested against the ship now and against the ship as
+// the shooter saw it.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "constants.h"
+#include "ship.h"
+#include "torpedo.h"
+#include "world.h"
+#include "rewind.h"
+#include "benchTime.h"
+
+// Return a random float from a to b
+static float random(float a, float b)
+{
+    return a + (b - a) * (rand() / (float)RAND_MAX);
+}
+
+//=============================================================================
+// Fill the history with ships flying around the screen for a whole ring
+//=============================================================================
+static void fill(RewindHistory &rewind, int players, float tickRate)
+{
+    for (int k=0; k<rewindNS::TICKS; k++)
+    {
+        RewindState *state = rewind.record(k / tickRate);
+        for (int i=0; i<players; i++)
+        {
+            state[i].x = fmodf(i * 37.0f + k * 2, (float)GAME_WIDTH);
+            state[i].y = fmodf(i * 53.0f + k, (float)GAME_HEIGHT);
+            state[i].radius = worldNS::SHIP_RADIUS;
+            state[i].active = true;
+        }
+    }
+}
+
+//=============================================================================
+// Fire trials torpedos at one ship flying past with a round trip of rtt
+// seconds, each tested tick by tick as Match::collisions does.
+// Returns hits, with the rewind if compensate.
+//=============================================================================
+static int shoot(float rtt, bool compensate, float tickRate, int trials)
+{
+    const float frameTime = 1.0f / tickRate;
+    const int   ticks = (int)(1.5f * tickRate);     // torpedo followed 1.5s
+    int hits = 0;
+    srand(7);
+    for (int n=0; n<trials; n++)
+    {
+        // target 0 flies straight at 50 to 200 px/s, the shooter is body 1 at 0,0
+        float speed = random(50, 200), heading = random(0, 2*(float)PI);
+        float vx = cosf(heading) * speed, vy = sinf(heading) * speed;
+        float distance = random(80, 250), bearing = random(0, 2*(float)PI);
+        float x0 = cosf(bearing) * distance;    // target when the torpedo spawns
+        float y0 = sinf(bearing) * distance;
+
+        // the shooter sees the target lag seconds back and leads it from there
+        float lag = rtt + rewindNS::VIEW_DELAY;
+        float px = x0 - vx * lag, py = y0 - vy * lag;
+        float a = vx*vx + vy*vy - torpedoNS::SPEED*torpedoNS::SPEED;
+        float b = 2 * (px*vx + py*vy);
+        float c = px*px + py*py;
+        float t = (-b - sqrtf(b*b - 4*a*c)) / (2*a);    // a < 0, one positive root
+        float aimX = px + vx * t, aimY = py + vy * t;
+        float aim = sqrtf(aimX*aimX + aimY*aimY);
+        float tvx = aimX / aim * torpedoNS::SPEED, tvy = aimY / aim * torpedoNS::SPEED;
+
+        RewindHistory rewind;
+        rewind.initialize(2, (float)GAME_WIDTH, (float)GAME_HEIGHT);
+        for (int k=-rewindNS::TICKS; k<=ticks; k++)
+        {
+            RewindState *state = rewind.record(k * frameTime);
+            state[0].x = x0 + vx * k * frameTime;
+            state[0].y = y0 + vy * k * frameTime;
+            state[0].radius = worldNS::SHIP_RADIUS;
+            state[0].active = true;
+            state[1].active = false;
+            if (k < 1)
+                continue;
+            // the torpedo's move over tick k, the first from where it spawned
+            float tx = tvx * (k-1) * frameTime, ty = tvy * (k-1) * frameTime;
+            if (rewind.sweep(compensate ? lag : 0, tx, ty, tvx * frameTime, tvy * frameTime,
+                             worldNS::TORPEDO_RADIUS, 1) == 0)
+            {
+                hits++;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+int main(int argc, char *argv[])
+{
+    float tickRate = SIM_RATE;
+    int matches = 100;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+            tickRate = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i+1 < argc)
+            matches = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-t tickrate] [-m matches]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tickRate <= 0 || matches < 1)
+    {
+        fprintf(stderr, "tickrate and matches must be positive\n");
+        return 1;
+    }
+
+    float window = rewindNS::MAX_WINDOW;
+    if (window > (rewindNS::TICKS - 1) / tickRate)
+        window = (rewindNS::TICKS - 1) / tickRate;
+    printf("%.0f ticks/sec, %d ticks kept, %.0f ms window, %d matches\n",
+           tickRate, rewindNS::TICKS, window * 1000, matches);
+    printf("%8s %9s %11s %10s %10s %12s %10s\n", "players", "bytes", "record(ns)",
+           "sweep(ns)", "cpu/match", "all matches", "memory");
+
+    const int sizes[] = {2, 4, 8, 16, 64};
+    for (int s=0; s<(int)(sizeof(sizes)/sizeof(sizes[0])); s++)
+    {
+        int players = sizes[s];
+        RewindHistory rewind;
+        rewind.initialize(players, (float)GAME_WIDTH, (float)GAME_HEIGHT);
+        fill(rewind, players, tickRate);
+
+        // record, as Match::collisions does every tick
+        const int records = 200000;
+        double start = now();
+        for (int k=0; k<records; k++)
+        {
+            RewindState *state = rewind.record(k / tickRate);
+            for (int i=0; i<players; i++)
+            {
+                state[i].x = (float)(i + k);
+                state[i].y = (float)i;
+                state[i].radius = worldNS::SHIP_RADIUS;
+                state[i].active = true;
+            }
+        }
+        double recordTime = (now() - start) / records;
+
+        // one tick of a torpedo's move, the whole window back, missing everything
+        fill(rewind, players, tickRate);
+        const int sweeps = 200000;
+        int hit = 0;
+        start = now();
+        for (int k=0; k<sweeps; k++)
+            hit += rewind.sweep(window, -100, -100 - (float)(k % 7), -1, 0,
+                                worldNS::TORPEDO_RADIUS, -1) >= 0;
+        double sweepTime = (now() - start) / sweeps;
+
+        // every ship has a torpedo in flight, fired with a lag
+        double cpu = (recordTime + sweepTime * players) * tickRate;
+        printf("%8d %9zu %11.1f %10.1f %9.4f%% %11.3f%% %7.2f MB%s\n", players,
+               rewind.getBytes(), recordTime * 1e9, sweepTime * 1e9, cpu * 100,
+               cpu * 100 * matches, rewind.getBytes() * matches / 1e6, hit ? " (hit)" : "");
+    }
+
+    const int trials = 2000;
+    printf("\nhits of %d torpedos aimed at ships where the shooter saw them, "
+           "%.0f ms playout delay\n", trials, rewindNS::VIEW_DELAY * 1000);
+    printf("%8s %10s %10s\n", "rtt(ms)", "now", "rewound");
+    const float rtts[] = {0, 0.05f, 0.1f, 0.15f, 0.3f};
+    for (int r=0; r<(int)(sizeof(rtts)/sizeof(rtts[0])); r++)
+    {
+        int plain = shoot(rtts[r], false, tickRate, trials);
+        int rewound = shoot(rtts[r], true, tickRate, trials);
+        printf("%8.0f %9.1f%% %9.1f%%\n", rtts[r] * 1000,
+               100.0 * plain / trials, 100.0 * rewound / trials);
+    }
+    return 0;
+}
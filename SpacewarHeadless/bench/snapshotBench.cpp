@@ -0,0 +1,222 @@
+// Snapshot size and encoding cost
+// Usage: snapshot-bench [-s seconds] [-t turning_percent]
+//
+// Plays a match of ships in orbit around the planet, turning, thrusting and
+// firing at random, and takes a snapshot 30 times a second, as a server
+// answering every input does. For matches of 2 to 64 players it compares
+// the bytes per snapshot of
+//   legacy  the structures copied to the wire, 3 bytes + a ShipStc and a TorpedoStc each
+//   full    SnapshotHistory::write with no baseline
+//   delta   SnapshotHistory::write against the snapshot a client acked 1, 3
+//           or 9 snapshots before, 33, 100 and 300 ms round trips
+// Every delta is decoded by a client history and checked against the full
+// snapshot. Also times the encoding and reports the largest error the
+// quantization puts on each field.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "spacewar.h"
+#include "gravityBatch.h"
+#include "world.h"
+#include "benchTime.h"
+
+namespace snapshotBenchNS
+{
+    const float FRAME_TIME = 1.0f/60;       // simulation tick
+    const int   FRAMES_PER_SNAPSHOT = 2;    // 30 snapshots a second
+    const int   LAGS = 3;
+    const int   LAG[LAGS] = {1, 3, 9};      // snapshots between a baseline and the next
+}
+using namespace snapshotBenchNS;
+
+// Return true if body i is inside the planet
+static bool crashed(const World &world, int i)
+{
+    float dx = world.getCenterX(i) - GAME_WIDTH/2.0f;
+    float dy = world.getCenterY(i) - GAME_HEIGHT/2.0f;
+    float r = (float)(planetNS::COLLISION_RADIUS + torpedoNS::COLLISION_RADIUS);
+    return dx*dx + dy*dy < r*r;
+}
+
+//=============================================================================
+// Put ship p of players on its starting orbit, as Match::roundStart does
+//=============================================================================
+static void placeShip(World &world, int p, int players)
+{
+    float radius = spacewarNS::ORBIT_RADIUS[p % spacewarNS::ORBITS];
+    float angle = (float)PI + 2*(float)PI*p/players;
+    float speed = sqrt(entityNS::GRAVITY * planetNS::MASS * shipNS::MASS / radius);
+    world.setX(p, GAME_WIDTH/2 + radius*cos(angle) - shipNS::WIDTH/2);
+    world.setY(p, GAME_HEIGHT/2 + radius*sin(angle) - shipNS::HEIGHT/2);
+    world.setVelocity(p, VECTOR2(-speed*sin(angle), speed*cos(angle)));
+    world.setRadians(p, angle - (float)PI);
+    world.repair(p);
+}
+
+//=============================================================================
+// Fill data from the world, every torpedo in flight, as Match::communicate
+//=============================================================================
+static void fill(const World &world, int players, ToClientStc &data)
+{
+    data.gameState = 0;
+    data.sounds = 0;
+    data.playerCount = (UCHAR)players;
+    for (int i=0; i<players; i++)
+    {
+        data.player[i].shipData = world.getShipNetData(i);
+        data.player[i].shipData.flags |= spacewarNS::SHIP_CONNECTED_BIT;
+        data.player[i].shipData.score = (short)(i * 3);
+    }
+    data.torpedoCount = world.getTorpedoCount();
+    for (int n=0; n<data.torpedoCount; n++)
+        data.torpedo[n] = world.getTorpedoNetData(world.getTorpedo(n));
+}
+
+// Return the difference between two angles, modulo 2 PI
+static float angleError(float a, float b)
+{
+    double d = fmod(fabs((double)a - b), PIx2);
+    return (float)(d > PI ? PIx2 - d : d);
+}
+
+// Return true if two decoded snapshots are the same
+static bool same(const ToClientStc &a, const ToClientStc &b)
+{
+    if (a.playerCount != b.playerCount || a.gameState != b.gameState || a.sounds != b.sounds ||
+        a.torpedoCount != b.torpedoCount)
+        return false;
+    for (int i=0; i<a.playerCount; i++)
+    {
+        const ShipStc &s = a.player[i].shipData, &t = b.player[i].shipData;
+        if (s.X != t.X || s.Y != t.Y || s.radians != t.radians || s.health != t.health ||
+            s.velocity.x != t.velocity.x || s.velocity.y != t.velocity.y ||
+            s.rotation != t.rotation || s.score != t.score || s.flags != t.flags)
+            return false;
+    }
+    for (int n=0; n<a.torpedoCount; n++)
+    {
+        const TorpedoStc &u = a.torpedo[n], &v = b.torpedo[n];
+        if (u.id != v.id || u.owner != v.owner || u.X != v.X || u.Y != v.Y ||
+            u.velocity.x != v.velocity.x || u.velocity.y != v.velocity.y)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    float seconds = 60;
+    int turning = 30;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+            seconds = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+            turning = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-s seconds] [-t turning_percent]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static ToClientStc data, full, decoded;
+    std::vector<char> buffer(snapshotNS::MAX_SIZE);
+    int snapshots = (int)(seconds / (FRAME_TIME * FRAMES_PER_SNAPSHOT));
+    printf("%d snapshots per match size, %d%% of ships turning at a time\n", snapshots, turning);
+    printf("%8s %9s %8s %8s %8s %8s %9s %10s\n", "players", "legacy(B)", "full(B)",
+           "lag 1", "lag 3", "lag 9", "lag 3 vs", "write(ns)");
+
+    float position = 0, angle = 0, velocity = 0;
+    const int sizes[] = {2, 4, 8, 16, 64};
+    for (int s=0; s<(int)(sizeof(sizes)/sizeof(sizes[0])); s++)
+    {
+        int players = sizes[s];
+        srand(1);
+        World world;
+        world.initialize(players);
+        GravityBatch gravity;
+        gravity.addPlanet(GAME_WIDTH/2.0f, GAME_HEIGHT/2.0f, planetNS::MASS);
+        for (int p=0; p<players; p++)
+            placeShip(world, p, players);
+
+        SnapshotHistory server;
+        server.initialize(players);
+        SnapshotHistory client[LAGS];
+        double fullBytes = 0, deltaBytes[LAGS] = {0}, writeTime = 0;
+        double clock = 0;          // seconds played
+        for (int n=0; n<snapshots; n++)
+        {
+            for (int f=0; f<FRAMES_PER_SNAPSHOT; f++)
+            {
+                for (int p=0; p<players; p++)
+                {
+                    if (rand() % 60 == 0)   // about once a second, change controls
+                    {
+                        int r = rand() % 100;
+                        world.rotate(p, r < turning/2 ? shipNS::LEFT :
+                                        r < turning ? shipNS::RIGHT : shipNS::NONE);
+                        world.setEngineOn(p, rand() % 4 == 0);
+                    }
+                    if (rand() % 120 == 0)
+                        world.fire(p);
+                    if (crashed(world, p))  // start over instead of exploding
+                        placeShip(world, p, players);
+                }
+                for (int n=world.getTorpedoCount()-1; n>=0; n--)
+                    if (crashed(world, world.getTorpedo(n)))
+                        world.removeTorpedo(world.getTorpedo(n));
+                world.applyGravity(gravity, FRAME_TIME);
+                world.update(FRAME_TIME);
+                clock += FRAME_TIME;
+            }
+            fill(world, players, data);
+            server.add(data, (UINT)(clock * 1000));
+            USHORT newest = server.getNewest();
+
+            int size = server.write(0, &buffer[0], (int)buffer.size());
+            fullBytes += size;
+            SnapshotHistory reference;
+            if (!reference.read(&buffer[0], size, full))
+            {
+                fprintf(stderr, "full snapshot of %d players did not decode\n", players);
+                return 1;
+            }
+            for (int i=0; i<players; i++)
+            {
+                const ShipStc &a = data.player[i].shipData, &b = full.player[i].shipData;
+                position = fmaxf(position, fmaxf(fabsf(a.X - b.X), fabsf(a.Y - b.Y)));
+                angle = fmaxf(angle, angleError(a.radians, b.radians));
+                velocity = fmaxf(velocity, fmaxf(fabsf(a.velocity.x - b.velocity.x),
+                                                 fabsf(a.velocity.y - b.velocity.y)));
+            }
+
+            // each client has every snapshot up to the one it acked
+            for (int l=0; l<LAGS; l++)
+            {
+                USHORT ack = n >= LAG[l] ? (USHORT)(newest - LAG[l]) : 0;
+                double start = now();
+                size = server.write(ack, &buffer[0], (int)buffer.size());
+                writeTime += now() - start;
+                deltaBytes[l] += size;
+                if (!client[l].read(&buffer[0], size, decoded) || !same(decoded, full))
+                {
+                    fprintf(stderr, "delta of %d players, lag %d, did not decode\n", players, LAG[l]);
+                    return 1;
+                }
+            }
+        }
+        int legacy = (int)(3 + players * (sizeof(ShipStc) + sizeof(TorpedoStc)));
+        printf("%8d %9d %8.1f %8.1f %8.1f %8.1f %8.1fx %10.1f\n", players, legacy,
+               fullBytes / snapshots, deltaBytes[0] / snapshots, deltaBytes[1] / snapshots,
+               deltaBytes[2] / snapshots, legacy / (deltaBytes[1] / snapshots),
+               writeTime / (snapshots * LAGS) * 1e9);
+    }
+    printf("largest error: position %.4f px, angle %.5f rad, velocity %.4f px/s\n",
+           position, angle, velocity);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Simulation tick throughput
+// Usage: world-bench [-n max_entities] [-r repeat_ms]
+//
+// Ticks per second for half ships and half torpedos, pulled by the planet
+// and moved one frame, using
+//   objects  Ship and Torpedo objects packed into a GravityBatch and
+//            updated one by one, as Match did
+//   world    the World arrays, pulled and updated in place
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "ship.h"
+#include "torpedo.h"
+#include "planet.h"
+#include "gravityBatch.h"
+#include "world.h"
+#include "benchTime.h"
+
+//=============================================================================
+// Random float from 0 to max
+//=============================================================================
+static float randomf(float max)
+{
+    return max * rand() / RAND_MAX;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxCount = 100000;
+    double repeatTime = 0.5;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            maxCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+            repeatTime = atof(argv[++i]) / 1000.0;
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n max_entities] [-r repeat_ms]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Planet planet;
+    planet.initialize(planetNS::WIDTH, planetNS::HEIGHT, planetNS::TEXTURE_COLS);
+    const float frameTime = 1.0f / 120;
+
+    printf("kernel %s\n", simdNS::KERNEL);
+    printf("%9s %16s %16s %8s\n", "entities", "objects(tick/s)", "world(tick/s)", "speedup");
+    const int counts[] = {1000, 10000, 100000};
+    for (size_t c=0; c<sizeof(counts)/sizeof(counts[0]) && counts[c] <= maxCount; c++)
+    {
+        int ships = counts[c] / 2;
+        std::vector<Ship> ship(ships);
+        std::vector<Torpedo> torpedo(ships);
+        World world;
+        world.initialize(ships);
+        GravityBatch batch;
+        batch.addPlanet(planet.getCenterX(), planet.getCenterY(), planet.getMass());
+
+        // the same random start for both, every torpedo in flight
+        srand(1);
+        for (int p=0; p<ships; p++)
+        {
+            float x = randomf((float)GAME_WIDTH);
+            float y = randomf((float)GAME_HEIGHT);
+            VECTOR2 v(randomf(200) - 100, randomf(200) - 100);
+            float angle = randomf(2*(float)PI);
+            bool engine = (p % 2 == 0);
+
+            ship[p].initialize(shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS);
+            torpedo[p].initialize(torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS);
+            ship[p].setX(x);
+            ship[p].setY(y);
+            ship[p].setVelocity(v);
+            ship[p].setRadians(angle);
+            ship[p].repair();
+            ship[p].setEngineOn(engine);
+            torpedo[p].fire(&ship[p]);
+
+            world.setX(p, x);
+            world.setY(p, y);
+            world.setVelocity(p, v);
+            world.setRadians(p, angle);
+            world.repair(p);
+            world.setEngineOn(p, engine);
+            world.fire(p);
+        }
+
+        std::vector<Entity*> gravityEntity;
+        double objectTime = timePass([&]{
+            batch.clear();
+            gravityEntity.clear();
+            for (int p=0; p<ships; p++)
+            {
+                Entity *ent[2] = {&ship[p], &torpedo[p]};
+                for (int n=0; n<2; n++)
+                {
+                    if (!ent[n]->getActive())
+                        continue;
+                    VECTOR2 v = ent[n]->getVelocity();
+                    batch.add(ent[n]->getCenterX(), ent[n]->getCenterY(), v.x, v.y,
+                              ent[n]->getGravity(), ent[n]->getMass());
+                    gravityEntity.push_back(ent[n]);
+                }
+            }
+            batch.step(frameTime);
+            for (size_t n=0; n<gravityEntity.size(); n++)
+                gravityEntity[n]->setVelocity(VECTOR2(batch.getVelocityX((int)n),
+                                                      batch.getVelocityY((int)n)));
+            for (int p=0; p<ships; p++)
+            {
+                ship[p].update(frameTime);
+                torpedo[p].update(frameTime);
+            }
+        }, repeatTime);
+
+        batch.clear();
+        double worldTime = timePass([&]{
+            world.applyGravity(batch, frameTime);
+            world.update(frameTime);
+        }, repeatTime);
+
+        printf("%9d %16.0f %16.0f %7.1fx\n", 2*ships,
+               1 / objectTime, 1 / worldTime, objectTime / worldTime);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include "console.h"
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Console::Console()
+{
+    initialized = false;                // set true when successfully initialized
+    logFile = NULL;
+    stdinFlags = -1;
+    stdinOpen = true;
+    commandStr = "";
+    inputStr = "";
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+Console::~Console()
+{
+    if(stdinFlags != -1)
+        fcntl(STDIN_FILENO, F_SETFL, stdinFlags);   // restore blocking stdin
+    if(logFile)
+        fclose(logFile);
+}
+
+//=============================================================================
+// Initialize the console
+// Puts stdin in non-blocking mode so the game loop never waits for input.
+// Post: returns true if successful, false if failed
+//=============================================================================
+bool Console::initialize(const char *logName)
+{
+    stdinFlags = fcntl(STDIN_FILENO, F_GETFL, 0);
+    if(stdinFlags == -1 || fcntl(STDIN_FILENO, F_SETFL, stdinFlags | O_NONBLOCK) == -1)
+    {
+        stdinFlags = -1;
+        stdinOpen = false;              // no usable stdin, log only
+    }
+
+    if(logName != NULL && *logName != '\0')
+    {
+        logFile = fopen(logName, "a");
+        if(logFile == NULL)
+            return false;
+    }
+    initialized = true;
+    return true;
+}
+
+//=============================================================================
+// Add text str to console output
+//=============================================================================
+void Console::print(const std::string &str)
+{
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm local;
+
+    localtime_r(&now, &local);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+
+    std::lock_guard<std::mutex> lock(printLock);
+    text.push_front(str);                   // add str to deque of text
+    if(text.size() > consoleNS::MAX_LINES)
+        text.pop_back();                    // delete oldest line
+
+    fprintf(stdout, "[%s] %s\n", stamp, str.c_str());
+    fflush(stdout);
+    if(logFile)
+    {
+        fprintf(logFile, "[%s] %s\n", stamp, str.c_str());
+        fflush(logFile);
+    }
+}
+
+//=============================================================================
+// Return console command
+// Reads whatever is waiting on stdin. When a complete line has been
+// entered it is returned as the command, otherwise "" is returned.
+//=============================================================================
+std::string Console::getCommand()
+{
+    char buffer[consoleNS::MAX_INPUT];
+    ssize_t n;
+
+    while(stdinOpen)
+    {
+        n = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if(n > 0)
+            inputStr.append(buffer, n);
+        else
+        {
+            if(n == 0)                      // end of file, stop reading stdin
+                stdinOpen = false;
+            break;                          // EAGAIN, nothing more to read
+        }
+    }
+
+    size_t eol = inputStr.find('\n');
+    if(eol == std::string::npos)
+    {
+        if(inputStr.size() > consoleNS::MAX_INPUT)  // discard runaway input
+            inputStr = "";
+        return "";
+    }
+
+    commandStr = inputStr.substr(0, eol);
+    inputStr.erase(0, eol+1);
+    if(!commandStr.empty() && commandStr[commandStr.size()-1] == '\r')
+        commandStr.erase(commandStr.size()-1);
+    return commandStr;
+}
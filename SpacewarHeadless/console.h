@@ -0,0 +1,59 @@
+#ifndef _CONSOLE_H              // Prevent multiple definitions if this 
+#define _CONSOLE_H              // file is included in more than one place
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include "constants.h"
+
+namespace consoleNS
+{
+    const int MAX_LINES = 256;          // maximun number of lines in text buffer
+    const int MAX_INPUT = 256;          // longest command accepted from stdin
+}
+
+// Admin console for the headless server.
+// Commands are read from stdin without blocking the game loop and all
+// output is written to stdout and, optionally, a log file.
+class Console
+{
+private:
+    std::string commandStr;             // console command
+    std::string inputStr;               // console text input
+    std::deque<std::string> text;       // console text
+    std::mutex  printLock;              // print may be called by match workers
+    FILE        *logFile;               // optional log file
+    int         stdinFlags;             // stdin flags restored on exit
+    bool        stdinOpen;              // false once stdin reaches end of file
+    bool        initialized;            // true when initialized successfully
+
+public:
+    // Constructor
+    Console();
+
+    // Destructor
+    virtual ~Console();
+
+    // Initialize the Console
+    // Pre: *logName = name of log file to append to, NULL for stdout only
+    bool initialize(const char *logName = NULL);
+
+    // Add text str to Console output.
+    // Each line is written with a time stamp. Safe to call from any thread.
+    void print(const std::string &str);
+
+    // Return Console command, "" if no complete command line has been entered
+    std::string getCommand();
+
+    // Return Console Input text
+    std::string getInput() {return inputStr;}
+
+    // Clear Input text
+    void clearInput()   {inputStr = "";}
+
+    // Return the most recent lines of output
+    const std::deque<std::string>& getText() {return text;}
+};
+
+#endif
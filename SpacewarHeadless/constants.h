@@ -0,0 +1,52 @@
+#ifndef _CONSTANTS_H            // Prevent multiple definitions if this 
+#define _CONSTANTS_H            // file is included in more than one place
+
+#include <cstddef>
+
+//-----------------------------------------------
+// Windows types used by the shared game code
+//-----------------------------------------------
+typedef unsigned int    UINT;
+typedef unsigned char   UCHAR;
+typedef unsigned short  USHORT;
+typedef unsigned long   u_long;
+
+// Stand-in for the Win32 RECT used by collision boxes
+struct RECT
+{
+    long left;
+    long top;
+    long right;
+    long bottom;
+};
+
+//-----------------------------------------------
+// Useful macros
+//-----------------------------------------------
+// Safely delete pointer referenced item
+#define SAFE_DELETE(ptr)       { if (ptr) { delete (ptr); (ptr)=NULL; } }
+// Safely delete pointer referenced array
+#define SAFE_DELETE_ARRAY(ptr) { if(ptr) { delete [](ptr); (ptr)=NULL; } }
+
+//-----------------------------------------------
+//                  Constants
+//-----------------------------------------------
+const char GAME_TITLE[] = "Spacewar Headless Server v2.1";
+const UINT GAME_WIDTH =  640;               // width of game in pixels
+const UINT GAME_HEIGHT = 480;               // height of game in pixels
+ 
+// game
+const double PI = 3.14159265358979;
+const double PIx2 = PI*2.0;
+const float FRAME_RATE = 200.0f;            // the target frame rate (frames/sec)
+const float MIN_FRAME_RATE = 10.0f;             // the minimum frame rate
+const float MIN_FRAME_TIME = 1.0f/FRAME_RATE;   // minimum desired time for 1 frame
+const float MAX_FRAME_TIME = 1.0f/MIN_FRAME_RATE; // maximum time used in calculations
+const float SIM_RATE = 120.0f;              // fixed simulation ticks/sec, 0 uses variable frameTime
+const int   MAX_SIM_STEPS = 5;              // most ticks run in one frame when catching up
+const float FULL_HEALTH = 100;
+
+// weapon types
+enum WEAPON {TORPEDO, SHIP, PLANET};
+
+#endif
@@ -0,0 +1,166 @@
+#include <cmath>
+#include <sstream>
+#include "game.h"
+
+// The primary class should inherit from Game class
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Game::Game()
+{
+    paused = false;             // game is not paused
+    console = NULL;
+    fps = 100;
+    simAccumulator = 0;
+    simSteps = 0;
+    simTicks = 0;
+    setSimRate(SIM_RATE);
+    frameTime = 0;
+    initialized = false;
+    running = true;
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+Game::~Game()
+{
+    deleteAll();                // free all reserved memory
+}
+
+//=============================================================================
+// Initializes the game
+// throws GameError on error
+//=============================================================================
+void Game::initialize(const char *logName, long spin, int backend)
+{
+    // initialize console
+    console = new Console();
+    if(console->initialize(logName) == false)
+        throw(GameError(gameErrorNS::FATAL_ERROR, "Failed to open console log file."));
+    console->print("---Console---");
+
+    // set up tick scheduler, the loop runs at the simulation rate when
+    // the simulation uses a fixed tick
+    if(scheduler.initialize((simTime > 0) ? 1.0/simTime : FRAME_RATE, spin, backend) == false)
+        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing tick scheduler"));
+
+    initialized = true;
+}
+
+//=============================================================================
+// Call repeatedly by main
+//=============================================================================
+void Game::run()
+{
+    if(console == NULL)             // if not initialized
+        return;
+
+    // sleep until the next tick deadline
+    int periods = scheduler.waitForTick();
+
+    // elapsed time of last frame, measured between deadlines
+    if (simTime > 0)                // scheduler runs at the simulation rate
+        frameTime = periods * simTime;
+    else
+        frameTime = (float)scheduler.getFrameTime();
+
+    if (frameTime > 0.0)
+        fps = (fps*0.99f) + (0.01f/frameTime);  // average fps
+    if (frameTime > MAX_FRAME_TIME) // if frame rate is very slow
+        frameTime = MAX_FRAME_TIME; // limit maximum frameTime
+
+    // update(), ai(), and collisions() are pure virtual functions.
+    // These functions must be provided in the class that inherits from Game.
+    if (!paused)                    // if not paused
+    {
+        if (simTime > 0)            // if fixed simulation tick
+        {
+            // Simulate the elapsed time in fixed steps so the results do not
+            // depend on frame rate. Leftover time carries into the next frame.
+            float elapsed = frameTime;
+            simAccumulator += elapsed;
+            frameTime = simTime;    // update() uses frameTime
+            simSteps = 0;
+            while (simAccumulator >= simTime && simSteps < MAX_SIM_STEPS)
+            {
+                update();           // update all game items
+                ai();               // artificial intelligence
+                collisions();       // handle collisions
+                simAccumulator -= simTime;
+                simSteps++;
+                simTicks++;
+            }
+            // if too far behind drop the backlog instead of trying to catch up
+            if (simAccumulator >= simTime)
+                simAccumulator = fmod(simAccumulator, simTime);
+            frameTime = elapsed;    // render and network use real time
+        }
+        else
+        {
+            update();               // update all game items
+            ai();                   // artificial intelligence
+            collisions();           // handle collisions
+            simTicks++;
+        }
+    }
+
+    communicate(frameTime);         // do network communication
+
+    consoleCommand();               // process user entered console command
+}
+
+//=============================================================================
+// Set fixed simulation rate in ticks per second, 0 for variable frameTime
+//=============================================================================
+void Game::setSimRate(float rate)
+{
+    if (rate > 0)
+        simTime = 1.0f/rate;
+    else
+        simTime = 0;
+    simAccumulator = 0;
+    // the loop runs once per simulation tick, or at FRAME_RATE when variable
+    scheduler.setRate((rate > 0) ? rate : FRAME_RATE);
+}
+
+//=============================================================================
+// Process console commands
+// Override this function in the derived class if new console commands are added.
+//=============================================================================
+void Game::consoleCommand()
+{
+    command = console->getCommand();    // get command from console
+    if(command == "")                   // if no command
+        return;
+
+    if (command == "help")              // if "help" command
+    {
+        console->print("Console Commands:");
+        console->print("fps - display frames per second");
+        console->print("sched - display tick scheduler statistics");
+        console->print("quit - shut down the server");
+        return;
+    }
+
+    if (command == "fps")
+    {
+        std::stringstream ss;
+        ss << "fps " << (int)fps;
+        console->print(ss.str());
+    }
+    else if (command == "sched")
+        console->print(scheduler.getStatsString());
+    else if (command == "quit")
+        exitGame();
+}
+
+//=============================================================================
+// Delete all reserved memory
+//=============================================================================
+void Game::deleteAll()
+{
+    SAFE_DELETE(console);
+    initialized = false;
+}
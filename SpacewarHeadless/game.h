@@ -0,0 +1,96 @@
+#ifndef _GAME_H                 // Prevent multiple definitions if this 
+#define _GAME_H                 // file is included in more than one place
+
+#include <string>
+#include "constants.h"
+#include "console.h"
+#include "tickScheduler.h"
+#include "gameError.h"
+#include "net.h"
+
+// Headless version of the engine Game class.
+// There is no window, graphics, input or audio. The game loop is driven
+// by main() calling run() until exitGame() is called.
+class Game
+{
+protected:
+    // common game properties
+    Console *console;               // pointer to Console
+    TickScheduler scheduler;        // wakes the game loop at each tick deadline
+    float   frameTime;              // time required for last frame
+    float   simTime;                // fixed simulation time step, 0 for variable frameTime
+    float   simAccumulator;         // elapsed time not yet simulated
+    int     simSteps;               // simulation ticks run during the last frame
+    UINT    simTicks;               // simulation ticks since start
+    float   fps;                    // frames per second
+    bool    paused;                 // true if game is paused
+    bool    initialized;
+    bool    running;                // false when the server should exit
+    std::string  command;           // command from console
+
+public:
+    // Constructor
+    Game();
+    // Destructor
+    virtual ~Game();
+
+    // Member functions
+
+    // Initialize the game
+    // Pre: *logName = log file name for console output, NULL for stdout only
+    //      spin = nanoseconds the scheduler busy waits before each tick
+    //      backend = tickSchedulerNS::SLEEP or TIMERFD
+    virtual void initialize(const char *logName = NULL,
+                            long spin = tickSchedulerNS::DEFAULT_SPIN_NS,
+                            int backend = tickSchedulerNS::SLEEP);
+
+    // Call run repeatedly from main until getRunning() returns false
+    virtual void run();
+
+    // Delete all reserved memory.
+    virtual void deleteAll();
+
+    // Process console commands.
+    virtual void consoleCommand();
+
+    // Do network communications.
+    virtual void communicate(float frameTime) {(void)frameTime;}
+
+    // Set fixed simulation rate in ticks per second.
+    // update(), ai() and collisions() are then called with frameTime equal to
+    // 1/rate, as many times as needed to keep up with real time (up to
+    // MAX_SIM_STEPS per frame). A rate of 0 uses the variable frameTime.
+    void setSimRate(float rate);
+
+    // Return fixed simulation rate in ticks per second, 0 if variable.
+    float getSimRate()      {return (simTime > 0) ? 1.0f/simTime : 0.0f;}
+
+    // Return number of simulation ticks since start
+    UINT getSimTicks()      {return simTicks;}
+
+    // Return the tick scheduler
+    TickScheduler& getScheduler()   {return scheduler;}
+
+    // Return true until exitGame is called
+    bool getRunning()       {return running;}
+
+    // Exit the game
+    void exitGame()         {running = false;}
+
+    // Return pointer to Console.
+    Console* getConsole()   {return console;}
+
+    // Pure virtual function declarations
+    // These functions MUST be written in any class that inherits from Game
+
+    // Update game items.
+    virtual void update() = 0;
+
+    // Perform AI calculations.
+    virtual void ai() = 0;
+
+    // Check for collisions.
+    virtual void collisions() = 0;
+};
+
+#endif
@@ -0,0 +1,42 @@
+// Headless stand-in for the DirectX Graphics class.
+// Provides only the sprite data and vector helpers the simulation needs;
+// there is no rendering device in the dedicated server.
+
+#ifndef _GRAPHICS_H             // Prevent multiple definitions if this 
+#define _GRAPHICS_H             // file is included in more than one place
+
+#include <cmath>
+#include "constants.h"
+#include "gameError.h"
+#include "vector2.h"
+
+// SpriteData: The position, size and orientation of an Image.
+// The texture pointer is omitted because nothing is drawn.
+struct SpriteData
+{
+    int         width;      // width of sprite in pixels
+    int         height;     // height of sprite in pixels
+    float       x;          // screen location (top left corner of sprite)
+    float       y;
+    float       scale;      // <1 smaller, >1 bigger
+    float       angle;      // rotation angle in radians
+    RECT        rect;       // used to select an image from a larger texture
+    bool        flipHorizontal; // true to flip sprite horizontally (mirror)
+    bool        flipVertical;   // true to flip sprite vertically
+};
+
+class Graphics
+{
+public:
+    // Vector functions kept for older code, the simulation uses vector2.h
+    // Return length of vector v.
+    static float    Vector2Length(const VECTOR2 *v) {return vector2Length(*v);}
+
+    // Return Dot product of vectors v1 and v2.
+    static float    Vector2Dot(const VECTOR2 *v1, const VECTOR2 *v2) {return vector2Dot(*v1, *v2);}
+
+    // Normalize vector v. A zero length vector is left unchanged.
+    static void     Vector2Normalize(VECTOR2 *v) {vector2Normalize(*v);}
+};
+
+#endif
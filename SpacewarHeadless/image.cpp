@@ -0,0 +1,96 @@
+#include "image.h"
+
+//=============================================================================
+// default constructor
+//=============================================================================
+Image::Image()
+{
+    initialized = false;            // set true when successfully initialized
+    spriteData.width = 2;
+    spriteData.height = 2;
+    spriteData.x = 0.0;
+    spriteData.y = 0.0;
+    spriteData.scale = 1.0;
+    spriteData.angle = 0.0;
+    spriteData.rect.left = 0;       // used to select one frame from multi-frame image
+    spriteData.rect.top = 0;
+    spriteData.rect.right = spriteData.width;
+    spriteData.rect.bottom = spriteData.height;
+    spriteData.flipHorizontal = false;
+    spriteData.flipVertical = false;
+    cols = 1;
+    startFrame = 0;
+    endFrame = 0;
+    currentFrame = 0;
+    frameDelay = 1.0;               // default to 1 second per frame of animation
+    animTimer = 0.0;
+    visible = true;                 // the image is visible
+    loop = true;                    // loop frames
+    animComplete = false;
+}
+
+//=============================================================================
+// destructor
+//=============================================================================
+Image::~Image()
+{}
+
+//=============================================================================
+// Initialize the Image.
+// Post: returns true if successful, false if failed
+// width of Image in pixels
+// height of Image in pixels
+// number of columns in texture (1 to n) (0 same as 1)
+//=============================================================================
+bool Image::initialize(int width, int height, int ncols)
+{
+    if(width <= 0 || height <= 0)
+        return false;
+    spriteData.width = width;
+    spriteData.height = height;
+    cols = ncols;
+    if (cols == 0)
+        cols = 1;                               // if 0 cols use 1
+    initialized = true;                         // successfully initialized
+    return true;
+}
+
+//=============================================================================
+// update
+// typically called once per frame
+// frameTime is used to regulate the speed of movement and animation
+//=============================================================================
+void Image::update(float frameTime)
+{
+    if (endFrame - startFrame > 0)          // if animated sprite
+    {
+        animTimer += frameTime;             // total elapsed time
+        if (animTimer > frameDelay)
+        {
+            animTimer -= frameDelay;
+            currentFrame++;
+            if (currentFrame < startFrame || currentFrame > endFrame)
+            {
+                if(loop == true)            // if looping animation
+                    currentFrame = startFrame;
+                else                        // not looping animation
+                {
+                    currentFrame = endFrame;
+                    animComplete = true;    // animation complete
+                }
+            }
+        }
+    }
+}
+
+//=============================================================================
+// Set the current frame of the image
+//=============================================================================
+void Image::setCurrentFrame(int c) 
+{
+    if(c >= 0)
+    {
+        currentFrame = c;
+        animComplete = false;
+    }
+}
@@ -0,0 +1,155 @@
+// Starting point for the headless Spacewar dedicated server.
+// Usage: spacewar-server [-p port] [-m matches] [-n players] [-w threads] [-t tickrate] [-s spin] [-T] [-e engine] [-l logfile]
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "spacewar.h"
+
+// Game pointer
+Spacewar *game = NULL;
+
+//=============================================================================
+// SIGINT/SIGTERM handler, lets the game loop finish the current frame
+//=============================================================================
+static void onSignal(int sig)
+{
+    (void)sig;
+    if (game)
+        game->exitGame();
+}
+
+//=============================================================================
+// Display command line usage
+//=============================================================================
+static void usage(const char *name)
+{
+    fprintf(stderr, "%s\n", GAME_TITLE);
+    fprintf(stderr, "Usage: %s [-p port] [-m matches] [-n players] [-w threads] [-t tickrate] [-s spin] [-T] [-e engine] [-l logfile]\n", name);
+    fprintf(stderr, "  -p port     UDP port to listen on (default %d)\n", netNS::DEFAULT_PORT);
+    fprintf(stderr, "  -m matches  independent matches to host (default 1, max %d)\n",
+            spacewarNS::MAX_MATCHES);
+    fprintf(stderr, "  -n players  players per match (default %d, max %d)\n",
+            spacewarNS::DEFAULT_PLAYERS, spacewarNS::MAX_PLAYERS);
+    fprintf(stderr, "  -w threads  worker threads that run the matches (default 1, max %d)\n",
+            workerPoolNS::MAX_THREADS);
+    fprintf(stderr, "  -t tickrate simulation ticks/sec, 0 uses frame time (default %d)\n", (int)SIM_RATE);
+    fprintf(stderr, "  -s spin     microseconds to busy wait before each tick (default %ld)\n",
+            tickSchedulerNS::DEFAULT_SPIN_NS/1000);
+    fprintf(stderr, "  -T          wait for ticks with timerfd instead of clock_nanosleep\n");
+    fprintf(stderr, "  -e engine   network engine: sockets, epoll or uring (default sockets)\n");
+    fprintf(stderr, "  -l logfile  append console output to logfile\n");
+}
+
+//=============================================================================
+// Starting point for the server
+//=============================================================================
+int main(int argc, char *argv[])
+{
+    int port = netNS::DEFAULT_PORT;
+    int matchCount = 1;
+    int players = spacewarNS::DEFAULT_PLAYERS;
+    int threads = 1;
+    float tickRate = SIM_RATE;
+    long spin = tickSchedulerNS::DEFAULT_SPIN_NS;
+    int backend = tickSchedulerNS::SLEEP;
+    int engine = -1;
+    const char *logName = NULL;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "-p") == 0 && i+1 < argc)
+            port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i+1 < argc)
+            matchCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            players = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i+1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+            tickRate = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+            spin = atol(argv[++i]) * 1000;
+        else if (strcmp(argv[i], "-T") == 0)
+            backend = tickSchedulerNS::TIMERFD;
+        else if (strcmp(argv[i], "-e") == 0 && i+1 < argc)
+        {
+            const char *name = argv[++i];
+            for (int e=0; e<netNS::ENGINES; e++)
+                if (strcmp(name, netNS::ENGINE_NAMES[e]) == 0)
+                    engine = e;
+            if (engine < 0)
+            {
+                fprintf(stderr, "Unknown network engine %s\n", name);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-l") == 0 && i+1 < argc)
+            logName = argv[++i];
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (port <= netNS::MIN_PORT || port > 65535)
+    {
+        fprintf(stderr, "Invalid port number %d\n", port);
+        return 1;
+    }
+    if (matchCount < 1 || matchCount > spacewarNS::MAX_MATCHES)
+    {
+        fprintf(stderr, "Invalid number of matches %d\n", matchCount);
+        return 1;
+    }
+    if (players < 2 || players > spacewarNS::MAX_PLAYERS)
+    {
+        fprintf(stderr, "Invalid number of players %d\n", players);
+        return 1;
+    }
+    if (threads < 1 || threads > workerPoolNS::MAX_THREADS)
+    {
+        fprintf(stderr, "Invalid number of threads %d\n", threads);
+        return 1;
+    }
+
+    // Create the game
+    game = new Spacewar;
+    game->setPort(port);
+    game->setMatches(matchCount);
+    game->setPlayers(players);
+    game->setThreads(threads);
+    game->setSimRate(tickRate);
+    if (engine >= 0)
+        game->setNetEngine(engine);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    try{
+        game->initialize(logName, spin, backend);   // throws GameError
+
+        // main loop
+        while (game->getRunning())
+            game->run();            // run the game loop
+
+        SAFE_DELETE (game);     // free memory before exit
+        return 0;
+    }
+    catch(const GameError &err)
+    {
+        fprintf(stderr, "Error: %s\n", err.getMessage());
+    }
+    catch(...)
+    {
+        fprintf(stderr, "Unknown error occured in game.\n");
+    }
+
+    SAFE_DELETE (game);     // free memory before exit
+    return 1;
+}
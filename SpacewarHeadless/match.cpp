@@ -0,0 +1,765 @@
+// One independent game hosted by the Spacewar server
+
+#include <time.h>
+#include "match.h"
+#include "bitStream.h"
+using namespace spacewarNS;
+
+//=============================================================================
+// Return monotonic time in seconds
+//=============================================================================
+static double now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Match::Match()
+{
+    net = NULL;
+    console = NULL;
+    number = 0;
+    playerLimit = 0;
+    countDownOn = false;
+    countDownTimer = 0;
+    startTimerRun = false;
+    startTimer = 0;
+    playerCount = 0;
+    clock = 0;
+    netTime = 0;
+    roundOver = true;
+    gravityOn = true;
+    burst = 1;
+    compensated = 0;
+    lagTotal = 0;
+    rewindTime = 0;
+    rewindTicks = 0;
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+Match::~Match()
+{}
+
+//=============================================================================
+// Initializes the match
+// Throws GameError on error
+//=============================================================================
+void Match::initialize(int n, int players, Net *net, Console *console)
+{
+    number = n;
+    this->net = net;
+    this->console = console;
+    if (players < 2 || players > MAX_PLAYERS)
+        throw(GameError(gameErrorNS::FATAL_ERROR, "Invalid number of players"));
+    playerLimit = players;
+    world.initialize(playerLimit);
+    player.resize(playerLimit);
+    proxyBody.reserve(world.getBodyCount());
+    circleBody.reserve(world.getBodyCount());
+    broadphase.initialize((float)GAME_WIDTH, (float)GAME_HEIGHT);
+
+    // planet, where the Planet sprite is drawn
+    planet.x = planetNS::X + planetNS::WIDTH/2.0f;
+    planet.y = planetNS::Y + planetNS::HEIGHT/2.0f;
+    planet.mass = planetNS::MASS;
+
+    toClientData.gameState = 0;
+    toClientData.sounds = 0;
+    toClientData.playerCount = (UCHAR)playerLimit;
+    history.initialize(playerLimit);
+    rewind.initialize(playerLimit, (float)GAME_WIDTH, (float)GAME_HEIGHT);
+    torpedoLag.assign(world.getBodyCount(), 0);
+    inbox.reserve(playerLimit * READS_PER_PLAYER);
+    outbox.reserve(playerLimit * READS_PER_PLAYER);
+    reset();
+}
+
+//=============================================================================
+// Disconnect all players and clear scores
+//=============================================================================
+void Match::reset()
+{
+    for (int i=0; i<playerLimit; i++)       // for all players
+    {
+        world.setActive(i, false);
+        world.setVisible(i, false);
+        player[i].connected = false;
+        player[i].score = 0;
+        player[i].address.clear();
+    }
+    world.clearTorpedos();
+    inbox.clear();
+    countDownOn = false;
+    startTimerRun = false;
+    playerCount = 0;
+    netTime = 0;
+    roundOver = true;
+}
+
+//=============================================================================
+// Print str prefixed with the match number
+//=============================================================================
+void Match::print(const std::string &str)
+{
+    std::stringstream ss;
+    ss << "Match " << number << ": " << str;
+    console->print(ss.str());
+}
+
+//=============================================================================
+// Start a new round of play
+// Connected players start spread around the planet in stable clockwise
+// orbits, filling the ORBIT_RADIUS rings in order. Open positions sit out.
+//=============================================================================
+void Match::roundStart()
+{
+    int players = getPlayerCount();
+    int placed = 0;             // players already placed
+    int ring = 0;               // orbit being filled
+    int ringStart = 0;          // first player on this orbit
+    int ringCount;              // players on this orbit
+
+    ringCount = (int)(2*PI*ORBIT_RADIUS[0] / ORBIT_SPACING);
+    if (ringCount > players)
+        ringCount = players;
+
+    world.clearTorpedos();
+    rewind.clear();             // the ships were somewhere else last round
+    for (int i=0; i<playerLimit; i++)
+    {
+        if (!player[i].connected)
+        {
+            world.setActive(i, false);
+            world.setVisible(i, false);
+            continue;
+        }
+        if (placed - ringStart >= ringCount && ring < ORBITS-1)  // orbit full
+        {
+            ring++;
+            ringStart = placed;
+            ringCount = (int)(2*PI*ORBIT_RADIUS[ring] / ORBIT_SPACING);
+            if (ringCount > players - placed)
+                ringCount = players - placed;
+        }
+        // first player on each orbit starts on the left side of the planet
+        float radius = ORBIT_RADIUS[ring];
+        float angle = (float)PI + 2*(float)PI*(placed - ringStart)/ringCount;
+        // speed of a circular orbit so ships on different rings never cross
+        float speed = sqrt(entityNS::GRAVITY * planetNS::MASS * shipNS::MASS / radius);
+        world.setX(i, GAME_WIDTH/2 + radius*cos(angle) - shipNS::WIDTH/2);
+        world.setY(i, GAME_HEIGHT/2 + radius*sin(angle) - shipNS::HEIGHT/2);
+        world.setVelocity(i, VECTOR2(-speed*sin(angle), speed*cos(angle)));
+        world.setRadians(i, angle - (float)PI);  // nose along the orbit
+        world.repair(i);
+        placed++;
+    }
+    countDownTimer = spacewarNS::COUNT_DOWN;
+    countDownOn = true;
+    roundOver = false;
+    // set the state to indicate new round
+    toClientData.gameState |= ROUND_START_BIT;
+    print("New round started.");
+}
+
+//=============================================================================
+// Update all game items
+//=============================================================================
+void Match::update(float frameTime)
+{
+    int shipCount = 0;      // visible ships
+    playerCount = 0;
+    clock += frameTime;     // time of the state this tick makes
+
+    if(startTimerRun)
+    {
+        startTimer += frameTime;
+        if(startTimer >= START_TIME)
+        {
+            startTimer = 0;
+            startTimerRun = false;
+            roundStart();
+        }
+    }
+
+    if(countDownOn)
+    {
+        countDownTimer -= frameTime;
+        if(countDownTimer <= 0)
+        {
+            countDownOn = false;
+            // round start bit off
+            toClientData.gameState &= (0xFF ^ ROUND_START_BIT);
+        }
+    } 
+    else
+    {
+        toClientData.sounds &= (0xFF ^ ENGINE1_BIT);    // sound off
+        toClientData.sounds &= (0xFF ^ ENGINE2_BIT);    // sound off
+
+        for (int i=0; i<playerLimit; i++)       // for all players
+        {
+            if(player[i].connected)
+                playerCount++;  // count connected players
+
+            if(world.getVisible(i))
+                shipCount++;        // count visible ships
+
+            if (world.getActive(i))
+            {
+                UCHAR buttons = player[i].buttons;
+                if (buttons & FORWARD_BIT)          // if move forward button
+                {
+                    world.setEngineOn(i, true);
+                    if(i % 2 == 0)  // if ship1 image
+                        toClientData.sounds |= ENGINE1_BIT; // sound on
+                    else            // if ship2 image
+                        toClientData.sounds |= ENGINE2_BIT; // sound on
+                }
+                else
+                    world.setEngineOn(i, false);    // engine off
+
+                world.rotate(i, shipNS::NONE);
+                if (buttons & LEFT_BIT)             // if turn left button
+                    world.rotate(i, shipNS::LEFT);
+                if (buttons & RIGHT_BIT)            // if turn right button
+                    world.rotate(i, shipNS::RIGHT);
+
+                if (buttons & FIRE_BIT)             // if fire button
+                {
+                    int fired = world.fire(i, burst);
+                    if (fired > 0)                  // if it fired
+                    {
+                        // change the state of the sound bit to play the sound
+                        toClientData.sounds ^= TORPEDO_FIRE_BIT;
+                        compensate(i, fired);
+                    }
+                }
+            }
+        }
+
+        applyGravity(frameTime);
+        world.update(frameTime);        // update ships and torpedos
+    }
+
+    // if 2 or more players connected AND (only 1 visible OR round over)
+    if( playerCount >= 2 && (shipCount <= 1 || roundOver))
+        startTimerRun = true;
+}
+
+//=============================================================================
+// Add the pull of the planet and gravity wells to every active ship and
+// torpedo, and of the ships and torpedos on each other if mutual gravity is on.
+// Same result as calling gravityForce for each of them, in one batch.
+//=============================================================================
+void Match::applyGravity(float frameTime)
+{
+    if (!gravityOn)
+        return;
+    gravityBatch.clearPlanets();
+    gravityBatch.addPlanet(planet.x, planet.y, planet.mass);
+    for (size_t n=0; n<wells.size(); n++)
+        gravityBatch.addPlanet(wells[n].x, wells[n].y, wells[n].mass);
+    world.applyGravity(gravityBatch, frameTime);
+}
+
+// Broadphase bound of ships and torpedos, half the diagonal of the 32x32
+// sprite covers the body at any rotation
+static const float BOUND_RADIUS = shipNS::WIDTH * 0.7072f;
+
+// Collision radius of the planet
+static const float PLANET_RADIUS = (float)planetNS::COLLISION_RADIUS;
+
+//=============================================================================
+// Return body n of the active ships followed by the torpedos in flight,
+// n = 0 to playerLimit + world.getTorpedoCount() - 1
+//=============================================================================
+int Match::body(int n)
+{
+    return (n < playerLimit) ? n : world.getTorpedo(n - playerLimit);
+}
+
+//=============================================================================
+// Handle collisions
+// Ships are tested against the planet as one batch. Torpedos are swept along
+// their last move against the planet and ships, so a torpedo moving farther
+// than its radius in one tick still hits.
+// The broadphase returns only the ships and torpedos that are close enough
+// to collide, so the cost grows with the number of nearby entities instead
+// of the square of the player count.
+//=============================================================================
+void Match::collisions()
+{
+    UCHAR sounds = toClientData.sounds; // get current sound states
+
+    // keep where every ship is this tick, at the time it is sent as
+    RewindState *state = rewind.record(clock);
+    // lagging torpedos are tested against the ships now until there is a
+    // tick to sweep them back over
+    bool rewound = rewind.canSweep();
+    for (int i=0; i<playerLimit; i++)
+    {
+        state[i].x = world.getCenterX(i);
+        state[i].y = world.getCenterY(i);
+        state[i].radius = world.getRadius(i);
+        state[i].active = world.getActive(i);
+    }
+
+    // test every ship against the planet at once
+    circles.clear();
+    circleBody.clear();
+    for (int i=0; i<playerLimit; i++)
+    {
+        if (!world.getActive(i))
+            continue;
+        circles.add(world.getCenterX(i), world.getCenterY(i), world.getRadius(i));
+        circleBody.push_back(i);
+    }
+    if (circles.getCount() > 0)
+    {
+        hitMask.resize(circles.getMaskWords());
+        hitVector.resize(circles.getCount());
+        circles.collide(planet.x, planet.y, PLANET_RADIUS, &hitMask[0], &hitVector[0]);
+        for (int n=0; n<circles.getCount(); n++)
+        {
+            if (!(hitMask[n / circleBatchNS::MASK_BITS] & (1u << (n % circleBatchNS::MASK_BITS))))
+                continue;
+            int i = circleBody[n];          // ship hit planet
+            world.toOldPosition(i);         // move ship out of collision
+            world.damage(i, PLANET);
+            for (int j=0; j<playerLimit; j++)   // for all ships
+            {
+                if(i != j && player[j].connected)   // for all other players
+                    player[j].score++;      // everyone else scores
+            }
+        }
+    }
+
+    // torpedos that hit the planet, backwards as removing one reorders the rest
+    for (int n=world.getTorpedoCount()-1; n>=0; n--)
+    {
+        int t = world.getTorpedo(n);
+        float toi;
+        if (world.sweep(t, planet.x, planet.y, PLANET_RADIUS, toi))
+        {
+            world.removeTorpedo(t);
+            // change the state of the sound bit to play the sound
+            toClientData.sounds ^= TORPEDO_CRASH_BIT;
+        }
+    }
+
+    for (int i=0; i<playerLimit; i++)
+    {
+        if(world.getExplosionOn(i))
+            toClientData.sounds ^= EXPLODE_BIT; // play explosion sound
+    }
+
+    broadphase.clear();
+    // each bound covers the body's whole move over the last tick
+    proxyBody.clear();
+    int bodies = playerLimit + world.getTorpedoCount();
+    for (int n=0; n<bodies; n++)
+    {
+        int i = body(n);
+        if (!world.getActive(i))
+            continue;
+        VECTOR2 move = world.getMove(i);
+        broadphase.add(world.getCenterX(i) - move.x/2, world.getCenterY(i) - move.y/2,
+                       BOUND_RADIUS + vector2Length(move)/2);
+        proxyBody.push_back(i);
+    }
+
+    const std::vector<BroadphasePair> &pairs = broadphase.findPairs();
+    for (size_t n=0; n<pairs.size(); n++)
+    {
+        int a = proxyBody[pairs[n].a];
+        int b = proxyBody[pairs[n].b];
+        bool aIsShip = world.isShip(a);
+        bool bIsShip = world.isShip(b);
+        if (aIsShip && bIsShip)
+            collideShips(a, b, sounds);
+        else if (aIsShip && (torpedoLag[b] <= 0 || !rewound))
+            collideTorpedo(a, b, sounds);
+        else if (bIsShip && (torpedoLag[a] <= 0 || !rewound))
+            collideTorpedo(b, a, sounds);
+    }
+
+    // torpedos of lagging players hit the ships where their shooters saw them
+    unsigned int sweeps = rewind.getSweeps();
+    double start = now();
+    for (int n=world.getTorpedoCount()-1; n>=0 && rewound; n--)
+    {
+        int t = world.getTorpedo(n);
+        if (torpedoLag[t] <= 0)
+            continue;
+        VECTOR2 move = world.getMove(t);
+        int i = rewind.sweep(torpedoLag[t], world.getCenterX(t) - move.x, world.getCenterY(t) - move.y,
+                             move.x, move.y, world.getRadius(t), world.getOwner(t));
+        if (i >= 0 && world.getActive(i))
+            torpedoHit(i, t, sounds);
+    }
+    if (rewind.getSweeps() != sweeps)
+    {
+        rewindTime += now() - start;
+        rewindTicks++;
+    }
+}
+
+//=============================================================================
+// Collide ship i with ship j
+// sounds = sound states before collisions were checked
+//=============================================================================
+void Match::collideShips(int i, int j, UCHAR sounds)
+{
+    VECTOR2 collisionVector;
+
+    // if collision between ships
+    if(world.collides(i, j, collisionVector))
+    {
+        // bounce off other ship
+        world.bounce(i, collisionVector, j);
+        world.bounce(j, collisionVector*-1, i);
+        world.damage(i, SHIP);
+        world.damage(j, SHIP);
+        if(world.getHealth(i) <= 0)
+            player[j].score++;
+        if(world.getHealth(j) <= 0)
+            player[i].score++;
+        // change the state of the sound bit to play the sound
+        if(sounds & COLLIDE_BIT)    // if bit was 1
+            toClientData.sounds &= (0xFF ^ COLLIDE_BIT); // set to 0
+        else                        // bit was 0
+            toClientData.sounds |= COLLIDE_BIT;     // set to 1
+    }
+}
+
+//=============================================================================
+// Collide ship i with torpedo body t
+// sounds = sound states before collisions were checked
+//=============================================================================
+void Match::collideTorpedo(int i, int t, UCHAR sounds)
+{
+    float toi;
+    int j = world.getOwner(t);
+
+    if(i == j)  // don't collide with our own torpedo
+        return;
+    // if torpedo touched the ship at any time during the last move
+    if(world.sweep(i, t, toi))
+        torpedoHit(i, t, sounds);
+}
+
+//=============================================================================
+// Torpedo body t hit ship i
+// sounds = sound states before collisions were checked
+//=============================================================================
+void Match::torpedoHit(int i, int t, UCHAR sounds)
+{
+    world.damage(i, TORPEDO);
+    player[world.getOwner(t)].score++;
+    world.removeTorpedo(t);
+    // change the state of the sound bit to play the sound
+    if(sounds & TORPEDO_HIT_BIT)    // if bit was 1
+        toClientData.sounds &= (0xFF ^ TORPEDO_HIT_BIT); // set 0
+    else                            // bit was 0
+        toClientData.sounds |= TORPEDO_HIT_BIT;     // set 1
+}
+
+//=============================================================================
+// Judge the torpedos player p just fired against the ships where p saw them
+// p sees the other ships its playout delay, sent with its input, behind the
+// newest snapshot it has acknowledged. Its torpedos are swept against the ships that far back, up
+// to the rewind window, for as long as they fly, instead of against the
+// ships now.
+// fired = torpedos just fired, the newest in flight
+//=============================================================================
+void Match::compensate(int p, int fired)
+{
+    float lag = 0;
+    UINT seen = history.getTime(player[p].ack);
+    if (seen != 0)              // a snapshot p has is still held
+        lag = (float)(clock - (seen / 1000.0 - player[p].delay));
+    if (lag > rewind.getWindow())
+        lag = rewind.getWindow();
+    if (lag < 0)
+        lag = 0;
+    for (int n=0; n<fired; n++)
+        torpedoLag[world.getTorpedo(world.getTorpedoCount() - 1 - n)] = lag;
+    if (lag > 0)
+    {
+        compensated += fired;
+        lagTotal += lag * fired;
+    }
+}
+
+////////////////////////////
+//   Network Functions    //
+////////////////////////////
+
+//=============================================================================
+// Return the index in encoded of the newest snapshot against baseline ack
+// Players that acknowledged the same snapshot share one encoding.
+//=============================================================================
+int Match::getReply(USHORT ack)
+{
+    for (size_t n=0; n<encoded.size(); n++)
+        if (encoded[n].ack == ack)
+            return (int)n;
+    MatchReply reply;
+    reply.ack = ack;
+    reply.offset = (int)replies.size();
+    replies.resize(reply.offset + snapshotNS::MAX_SIZE);
+    reply.size = history.write(ack, &replies[reply.offset], snapshotNS::MAX_SIZE);
+    replies.resize(reply.offset + reply.size);
+    encoded.push_back(reply);
+    return (int)encoded.size() - 1;
+}
+
+//=============================================================================
+// Apply queued input and send each sender the latest game data
+// Check for inactive players every NET_TIME seconds
+//=============================================================================
+void Match::communicate(float frameTime)
+{
+    std::stringstream ss;
+    int count;
+
+    if(!inbox.empty())
+    {
+        // prepare data for transmission to clients
+        for (int i=0; i<playerLimit; i++)   // for all players
+        {
+            ShipStc &shipData = toClientData.player[i].shipData;
+            shipData = world.getShipNetData(i);
+            shipData.score = (short)player[i].score;
+            if (player[i].connected)
+                shipData.flags |= SHIP_CONNECTED_BIT;
+            player[i].shownInput = player[i].input;
+        }
+        // the pull the clients replay their ships with
+        GravityStc &gravity = toClientData.gravity;
+        gravity.flags = 0;
+        if (gravityOn)
+            gravity.flags |= GRAVITY_ON_BIT;
+        if (gravityBatch.getMutual())
+            gravity.flags |= MUTUAL_GRAVITY_BIT;
+        gravity.wellCount = (UCHAR)wells.size();
+        for (size_t n=0; n<wells.size(); n++)
+        {
+            gravity.well[n].x = wells[n].x;
+            gravity.well[n].y = wells[n].y;
+            gravity.well[n].mass = wells[n].mass;
+        }
+        // every torpedo in flight, the pool holds at most MAX_BURST per ship
+        toClientData.torpedoCount = world.getTorpedoCount();
+        for (int n=0; n<toClientData.torpedoCount; n++)
+            toClientData.torpedo[n] = world.getTorpedoNetData(world.getTorpedo(n));
+        history.add(toClientData, (UINT)(clock * 1000));
+        replies.clear();
+        encoded.clear();
+
+        outbox.clear();
+        outboxReply.clear();
+        outboxHeader.clear();
+        for (size_t n=0; n<inbox.size(); n++)
+        {
+            int playN = inbox[n].playerN;
+            if (!player[playN].connected)       // if player timed out
+                continue;
+            // drop input that is a duplicate or older than input applied
+            if (!player[playN].link.receive(inbox[n].header))
+            {
+                player[playN].commErrors++;
+                if (++player[playN].commWarnings <= netNS::MAX_COMM_WARNINGS)
+                    continue;
+                // so many in a row, the client must have started over
+                player[playN].link.resync();
+                player[playN].link.receive(inbox[n].header);
+            }
+            if (world.getActive(playN))         // if this player is active
+                player[playN].buttons = inbox[n].buttons;
+            player[playN].input = inbox[n].header.sequence;
+            if ((short)(inbox[n].ack - player[playN].ack) > 0 || player[playN].ack == 0)
+                player[playN].ack = inbox[n].ack;   // acks may arrive out of order
+            player[playN].delay = inbox[n].delay / 1000.0f;
+            // reply to player with the latest game data, as a change from
+            // the newest snapshot the player has
+            int reply = getReply(player[playN].ack);
+            if (encoded[reply].size == 0)
+                continue;
+            NetPacket packet;
+            packet.data = NULL;                 // set once packets stops growing
+            packet.size = snapshotNS::PREFIX_SIZE + encoded[reply].size;
+            packet.address = player[playN].address;
+            outbox.push_back(packet);
+            outboxReply.push_back(reply);
+            MatchPacket header;
+            player[playN].link.stamp(header.header);
+            header.input = player[playN].shownInput;
+            outboxHeader.push_back(header);
+            player[playN].timeout = 0;
+            player[playN].commWarnings = 0;
+        }
+        inbox.clear();
+        // each packet is its player's header and input and the shared snapshot
+        int offset = 0;
+        for (size_t n=0; n<outbox.size(); n++)
+            offset += outbox[n].size;
+        packets.resize(offset);
+        offset = 0;
+        for (size_t n=0; n<outbox.size(); n++)
+        {
+            const MatchReply &reply = encoded[outboxReply[n]];
+            PacketLink::writeHeader(outboxHeader[n].header, &packets[offset]);
+            BitWriter input(&packets[offset + packetLinkNS::HEADER_SIZE], 2);
+            input.write(outboxHeader[n].input, 16);
+            memcpy(&packets[offset + snapshotNS::PREFIX_SIZE], &replies[reply.offset], reply.size);
+            outbox[n].data = &packets[offset];
+            offset += outbox[n].size;
+        }
+        // send every reply at once
+        count = (int)outbox.size();
+        if (count > 0)
+            net->sendBatch(&outbox[0], count);
+    }
+
+    // calculate elapsed time for network communications
+    netTime += frameTime;
+    if(netTime < netNS::NET_TIME)      // if not time to communicate
+        return;
+    netTime -= netNS::NET_TIME;
+
+    // check for inactive clients, called every NET_TIME seconds
+    for (int i=0; i<playerLimit; i++)       // for all players
+    {
+        if (player[i].connected)
+        {
+            player[i].timeout++;
+            // if communication timeout
+            if (player[i].timeout > netNS::MAX_ERRORS) 
+            {
+                player[i].connected = false;
+                ss.str("");
+                ss << "***** Player " << i << " disconnected. *****";
+                print(ss.str());
+            }
+        }
+    }
+}
+
+//=============================================================================
+// Queue input from playerN
+//=============================================================================
+void Match::addInput(int playerN, UCHAR buttons, USHORT ack, USHORT delay, const PacketHeader &header)
+{
+    MatchInput input;
+    input.playerN = (UCHAR)playerN;
+    input.buttons = buttons;
+    input.ack = ack;
+    input.delay = delay;
+    input.header = header;
+    inbox.push_back(input);
+}
+
+//=============================================================================
+// Connect a new player from address
+// Returns player number or -1 if the match is full
+//=============================================================================
+int Match::addPlayer(const NetAddress &address)
+{
+    std::stringstream ss;
+
+    if(getPlayerCount() == 0)           // if no players currently in game
+    {
+        roundOver = true;               // start a new round
+        for(int i=0; i<playerLimit; i++)    // for all players
+            player[i].score = 0;        // reset score
+    }
+
+    // find available player position to use
+    for(int i=0; i<playerLimit; i++)        // search all player positions
+    {
+        if (player[i].connected == false)   // if this position available
+        {
+            player[i].connected = true;
+            player[i].ack = 0;              // full snapshots until one is acked
+            player[i].delay = rewindNS::VIEW_DELAY; // until its input says
+            player[i].link.reset();
+            player[i].input = 0;
+            player[i].shownInput = 0;
+            player[i].timeout = 0;
+            player[i].commWarnings = 0;
+            player[i].address = address;    // save player's address
+            address.toString(player[i].netIP);
+            player[i].commErrors = 0;       // clear old errors
+            ss << "Connected player as number: " << i << " from " << player[i].netIP;
+            print(ss.str());
+            return i;                       // found available player position
+        }
+    }
+    return -1;
+}
+
+//=============================================================================
+// Return true if playerN is connected from address
+//=============================================================================
+bool Match::isPlayer(int playerN, const NetAddress &address)
+{
+    if (playerN < 0 || playerN >= playerLimit)
+        return false;
+    return player[playerN].connected && player[playerN].address == address;
+}
+
+//=============================================================================
+// Return number of connected players
+//=============================================================================
+int Match::getPlayerCount()
+{
+    int count = 0;
+    for (int i=0; i<playerLimit; i++)
+        if (player[i].connected)
+            count++;
+    return count;
+}
+
+//=============================================================================
+// Add an invisible gravity well at x,y
+// Returns false if the match already has MAX_WELLS.
+//=============================================================================
+bool Match::addWell(float x, float y, float mass)
+{
+    if (wells.size() >= (size_t)MAX_WELLS)
+        return false;
+    GravitySource well;
+    well.x = x;
+    well.y = y;
+    well.mass = mass;
+    wells.push_back(well);
+    return true;
+}
+
+//=============================================================================
+// Return one line summary of players and scores
+//=============================================================================
+std::string Match::getStatus()
+{
+    std::stringstream ss;
+
+    ss << "Match " << number << ": " << getPlayerCount() << "/" << playerLimit << " players";
+    for (int i=0; i<playerLimit; i++)
+    {
+        if (player[i].connected)
+            ss << "\n  Player " << i << " " << player[i].netIP << " score " << player[i].score
+               << " health " << (int)world.getHealth(i)
+               << "\n    " << player[i].link.getStatsString();
+    }
+    ss << "\n  Lag compensation: " << compensated << " torpedos "
+       << (int)(compensated ? lagTotal / compensated * 1000 : 0) << " ms back, "
+       << rewind.getSweeps() << " sweeps " << rewind.getHits() << " hits";
+    return ss.str();
+}
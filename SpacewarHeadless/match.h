@@ -0,0 +1,215 @@
+#ifndef _MATCH_H                // Prevent multiple definitions if this 
+#define _MATCH_H                // file is included in more than one place
+
+#include <string>
+#include <vector>
+#include "spacewar.h"
+#include "broadphase.h"
+#include "circleBatch.h"
+#include "gravityBatch.h"
+#include "world.h"
+#include "rewind.h"
+
+// Network and score state of one player position in a match
+struct MatchPlayer
+{
+    NetAddress address;     // where the player's datagrams come from
+    char    netIP[netNS::ADDRESS_SIZE]; // IP address as text, for status output
+    int     timeout;
+    int     commWarnings;   // stale or duplicate inputs in a row
+    int     commErrors;     // stale or duplicate inputs dropped
+    bool    connected;      // true when a player has joined
+    UCHAR   buttons;        // current key presses
+    USHORT  ack;            // newest snapshot the player has, its delta baseline
+    float   delay;          // seconds the player shows the other ships behind it
+    PacketLink link;        // sequence numbers and acks of the player's packets
+    USHORT  input;          // sequence of the newest input applied
+    USHORT  shownInput;     // input when this frame's snapshot was taken
+    int     score;
+};
+
+// Input from one player waiting to be applied to a match
+struct MatchInput
+{
+    UCHAR playerN;      // player number within the match
+    UCHAR buttons;      // bit 0=Left, 1=Forward, 2=Right, 3=Fire
+    USHORT ack;         // newest snapshot the player has
+    USHORT delay;       // player's playout delay in ms
+    PacketHeader header;
+};
+
+// What a reply to one player starts with
+struct MatchPacket
+{
+    PacketHeader header;
+    USHORT input;       // MatchPlayer::shownInput
+};
+
+// A snapshot encoded for the players that acknowledged the same baseline
+struct MatchReply
+{
+    USHORT ack;
+    int    offset;      // in replies
+    int    size;
+};
+
+//=============================================================================
+// One independent free-for-all game of 2 to MAX_PLAYERS ships.
+// Holds the ships, torpedos, planet and round state that SpacewarServer keeps
+// for its single game. Ship p and its torpedos live in the World arrays; the
+// Ship, Torpedo and Planet classes are only used by clients to draw them.
+// The Spacewar container owns the socket and routes each
+// datagram to the match it belongs to. A match is only touched by one thread
+// at a time: the main thread between ticks and a worker during a tick.
+//=============================================================================
+class Match
+{
+private:
+    // game items
+    World   world;                  // ships and torpedos, one of each per player
+    std::vector<MatchPlayer> player;
+    Broadphase broadphase;          // finds ships and torpedos that may collide
+    std::vector<int> proxyBody;     // broadphase index -> world body
+    CircleBatch circles;            // active ships and torpedos, tested against the planet
+    std::vector<int> circleBody;    // circles index -> world body
+    std::vector<unsigned int> hitMask;  // planet hits from circles.collide()
+    std::vector<VECTOR2> hitVector;
+    RewindHistory rewind;           // where the ships were, for torpedos fired by lagging players
+    std::vector<float> torpedoLag;  // seconds each torpedo body is judged behind, 0 for none
+    unsigned int compensated;       // torpedos fired with a lag
+    double  lagTotal;               // seconds of lag of those torpedos
+    double  rewindTime;             // seconds spent sweeping them
+    unsigned int rewindTicks;       // ticks that swept any
+    GravityBatch gravityBatch;      // planet and wells pulling the world bodies
+    std::vector<GravitySource> wells;   // gravity sources besides the planet
+    bool    gravityOn;          // false turns off all gravity
+    int     burst;              // torpedos fired at once
+    int     playerLimit;        // players in a full match
+    GravitySource planet;       // the planet, fixed at the center of the screen
+    bool    countDownOn;        // true when count down is running
+    bool    startTimerRun;      // true when start timer is running
+    float   countDownTimer;
+    float   startTimer;
+    bool    roundOver;          // true when round is over
+
+    // Network variables
+    Net     *net;               // socket shared by all matches
+    Console *console;           // server console
+    int     number;             // match number, used in console output
+    ToClientStc toClientData;
+    SnapshotHistory history;        // recent snapshots, baselines for the deltas
+    std::vector<char> replies;      // this frame's snapshots, one per baseline in use
+    std::vector<MatchReply> encoded;
+    std::vector<int> outboxReply;   // encoded entry of each outbox packet
+    std::vector<MatchPacket> outboxHeader;  // player's header of each outbox packet
+    std::vector<char> packets;      // the outbox datagrams
+    double  clock;                  // seconds simulated, stamps snapshots and rewind ticks
+    std::vector<MatchInput> inbox;  // input received since the last communicate
+    std::vector<NetPacket> outbox;  // replies, sent together by communicate
+    int     playerCount;        // number of players in match
+    float   netTime;
+
+    // Print str prefixed with the match number
+    void print(const std::string &str);
+
+    // Add the pull of the planet, wells and, if mutual, other ships and torpedos
+    void applyGravity(float frameTime);
+
+    // Collide ship i with ship j
+    void collideShips(int i, int j, UCHAR sounds);
+
+    // Body n of the ships followed by the torpedos in flight
+    int  body(int n);
+
+    // Return the index in encoded of the newest snapshot written against
+    // baseline ack, encoding it on first use
+    int  getReply(USHORT ack);
+
+    // Collide ship i with torpedo body t
+    void collideTorpedo(int i, int t, UCHAR sounds);
+
+    // Torpedo body t hit ship i
+    void torpedoHit(int i, int t, UCHAR sounds);
+
+    // Judge the torpedos player p just fired against the ships where p saw them
+    void compensate(int p, int fired);
+
+public:
+    // Constructor
+    Match();
+    // Destructor
+    virtual ~Match();
+
+    // Initialize the match
+    // Pre: n = match number
+    //      players = players in a full match, 2 to MAX_PLAYERS
+    //      *net = server socket used to send game state to players
+    //      *console = console for status messages
+    // Throws GameError on error
+    void initialize(int n, int players, Net *net, Console *console);
+
+    void update(float frameTime);   // update all game items
+    void collisions();              // handle collisions
+    void roundStart();              // start a new round of play
+    void reset();                   // disconnect all players and clear scores
+
+    // Apply queued input, reply to each player with the latest game state
+    // and check for timeouts. Called once per frame.
+    void communicate(float frameTime);
+
+    // Queue input received from playerN for the next communicate()
+    // ack = newest snapshot sequence playerN has received
+    // header = sequence of the input and playerN's acks of our packets
+    void addInput(int playerN, UCHAR buttons, USHORT ack, USHORT delay, const PacketHeader &header);
+
+    // Connect a new player from address
+    // Returns player number or -1 if the match is full
+    int  addPlayer(const NetAddress &address);
+
+    // Return true if playerN is connected from address
+    bool isPlayer(int playerN, const NetAddress &address);
+
+    // Return number of connected players
+    int  getPlayerCount();
+
+    // Return true if a player may join
+    bool hasOpening()   {return getPlayerCount() < playerLimit;}
+
+    // Turn planet gravity on or off
+    void setGravity(bool on)    {gravityOn = on;}
+
+    // Add an invisible gravity well at x,y
+    // Returns false if the match already has MAX_WELLS, clients can not be sent more.
+    bool addWell(float x, float y, float mass);
+
+    // Remove all gravity wells
+    void clearWells()           {wells.clear();}
+
+    // Ships and torpedos attract each other when on
+    void setMutualGravity(bool on)  {gravityBatch.setMutual(on);}
+
+    // Barnes-Hut opening angle and the number of sources before it is used
+    void setGravityTheta(float theta)       {gravityBatch.setTheta(theta);}
+    void setGravityTreeThreshold(int n)     {gravityBatch.setTreeThreshold(n);}
+
+    // Torpedos fired per shot, 1 to worldNS::MAX_BURST
+    void setBurst(int n)        {burst = n;}
+
+    // Select broadphaseNS::GRID or SWEEP collision culling
+    void setBroadphase(int method)  {broadphase.setMethod(method);}
+
+    // Longest lag compensation in seconds, 0 to rewindNS::MAX_WINDOW, 0 is off
+    void setRewindWindow(float seconds) {rewind.setWindow(seconds);}
+
+    // Return the lag compensation history
+    const RewindHistory &getRewind() const  {return rewind;}
+
+    // Return seconds spent on lag compensation and the ticks it was used
+    double getRewindTime() const            {return rewindTime;}
+    unsigned int getRewindTicks() const     {return rewindTicks;}
+
+    // Return one line summary of players and scores
+    std::string getStatus();
+};
+
+#endif
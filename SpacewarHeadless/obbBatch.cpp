@@ -0,0 +1,172 @@
+#include <string.h>
+#include <math.h>
+#include "obbBatch.h"
+using namespace obbBatchNS;
+
+//=============================================================================
+// Remove all boxes
+//=============================================================================
+void ObbBatch::clear()
+{
+    x.clear();
+    y.clear();
+    ux.clear();
+    uy.clear();
+    hw.clear();
+    hh.clear();
+    angle.clear();
+}
+
+//=============================================================================
+// Add a box
+//=============================================================================
+int ObbBatch::add(float cx, float cy, float a, float halfWidth, float halfHeight)
+{
+    x.push_back(cx);
+    y.push_back(cy);
+    ux.push_back((float)cos(a));
+    uy.push_back((float)sin(a));
+    hw.push_back(halfWidth);
+    hh.push_back(halfHeight);
+    angle.push_back(a);
+    return (int)x.size() - 1;
+}
+
+//=============================================================================
+// Move box i
+//=============================================================================
+void ObbBatch::set(int i, float cx, float cy, float a)
+{
+    x[i] = cx;
+    y[i] = cy;
+    if (a != angle[i])
+    {
+        ux[i] = (float)cos(a);
+        uy[i] = (float)sin(a);
+        angle[i] = a;
+    }
+}
+
+//=============================================================================
+// Separating axis test of box pairs
+// Each lane is one pair. The box fields of a block of pairs are gathered
+// into registers, then the four axes are tested without branches. The y
+// axis of a box is its x axis turned 90 degrees, (-uy, ux).
+//=============================================================================
+int ObbBatch::collide(const int *a, const int *b, int pairs, unsigned int *hitMask) const
+{
+    memset(hitMask, 0, getMaskWords(pairs) * sizeof(unsigned int));
+    int n = 0;
+
+#if defined(SIMD_AVX2)
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    for (; n + 8 <= pairs; n += 8)
+    {
+        __m256i ia = _mm256_loadu_si256((const __m256i*)&a[n]);
+        __m256i ib = _mm256_loadu_si256((const __m256i*)&b[n]);
+        __m256 tx = _mm256_sub_ps(_mm256_i32gather_ps(&x[0], ib, 4), _mm256_i32gather_ps(&x[0], ia, 4));
+        __m256 ty = _mm256_sub_ps(_mm256_i32gather_ps(&y[0], ib, 4), _mm256_i32gather_ps(&y[0], ia, 4));
+        __m256 axA = _mm256_i32gather_ps(&ux[0], ia, 4);
+        __m256 ayA = _mm256_i32gather_ps(&uy[0], ia, 4);
+        __m256 axB = _mm256_i32gather_ps(&ux[0], ib, 4);
+        __m256 ayB = _mm256_i32gather_ps(&uy[0], ib, 4);
+        __m256 hwA = _mm256_i32gather_ps(&hw[0], ia, 4);
+        __m256 hhA = _mm256_i32gather_ps(&hh[0], ia, 4);
+        __m256 hwB = _mm256_i32gather_ps(&hw[0], ib, 4);
+        __m256 hhB = _mm256_i32gather_ps(&hh[0], ib, 4);
+
+        // |cos| and |sin| of the angle between the boxes
+        __m256 c = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(axA, axB), _mm256_mul_ps(ayA, ayB)), absMask);
+        __m256 s = _mm256_and_ps(_mm256_sub_ps(_mm256_mul_ps(axA, ayB), _mm256_mul_ps(ayA, axB)), absMask);
+
+        // A's x axis, A's y axis, B's x axis, B's y axis
+        __m256 dist = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(tx, axA), _mm256_mul_ps(ty, ayA)), absMask);
+        __m256 reach = _mm256_add_ps(hwA, _mm256_add_ps(_mm256_mul_ps(hwB, c), _mm256_mul_ps(hhB, s)));
+        __m256 hit = _mm256_cmp_ps(dist, reach, _CMP_LE_OQ);
+        dist = _mm256_and_ps(_mm256_sub_ps(_mm256_mul_ps(ty, axA), _mm256_mul_ps(tx, ayA)), absMask);
+        reach = _mm256_add_ps(hhA, _mm256_add_ps(_mm256_mul_ps(hwB, s), _mm256_mul_ps(hhB, c)));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(dist, reach, _CMP_LE_OQ));
+        dist = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(tx, axB), _mm256_mul_ps(ty, ayB)), absMask);
+        reach = _mm256_add_ps(hwB, _mm256_add_ps(_mm256_mul_ps(hwA, c), _mm256_mul_ps(hhA, s)));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(dist, reach, _CMP_LE_OQ));
+        dist = _mm256_and_ps(_mm256_sub_ps(_mm256_mul_ps(ty, axB), _mm256_mul_ps(tx, ayB)), absMask);
+        reach = _mm256_add_ps(hhB, _mm256_add_ps(_mm256_mul_ps(hwA, s), _mm256_mul_ps(hhA, c)));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(dist, reach, _CMP_LE_OQ));
+
+        unsigned int bits = (unsigned int)_mm256_movemask_ps(hit);
+        hitMask[n / MASK_BITS] |= bits << (n % MASK_BITS);
+    }
+#elif defined(SIMD_SSE2)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (; n + 4 <= pairs; n += 4)
+    {
+        const int a0 = a[n], a1 = a[n+1], a2 = a[n+2], a3 = a[n+3];
+        const int b0 = b[n], b1 = b[n+1], b2 = b[n+2], b3 = b[n+3];
+        __m128 tx = _mm_sub_ps(_mm_set_ps(x[b3], x[b2], x[b1], x[b0]),
+                               _mm_set_ps(x[a3], x[a2], x[a1], x[a0]));
+        __m128 ty = _mm_sub_ps(_mm_set_ps(y[b3], y[b2], y[b1], y[b0]),
+                               _mm_set_ps(y[a3], y[a2], y[a1], y[a0]));
+        __m128 axA = _mm_set_ps(ux[a3], ux[a2], ux[a1], ux[a0]);
+        __m128 ayA = _mm_set_ps(uy[a3], uy[a2], uy[a1], uy[a0]);
+        __m128 axB = _mm_set_ps(ux[b3], ux[b2], ux[b1], ux[b0]);
+        __m128 ayB = _mm_set_ps(uy[b3], uy[b2], uy[b1], uy[b0]);
+        __m128 hwA = _mm_set_ps(hw[a3], hw[a2], hw[a1], hw[a0]);
+        __m128 hhA = _mm_set_ps(hh[a3], hh[a2], hh[a1], hh[a0]);
+        __m128 hwB = _mm_set_ps(hw[b3], hw[b2], hw[b1], hw[b0]);
+        __m128 hhB = _mm_set_ps(hh[b3], hh[b2], hh[b1], hh[b0]);
+
+        // |cos| and |sin| of the angle between the boxes
+        __m128 c = _mm_and_ps(_mm_add_ps(_mm_mul_ps(axA, axB), _mm_mul_ps(ayA, ayB)), absMask);
+        __m128 s = _mm_and_ps(_mm_sub_ps(_mm_mul_ps(axA, ayB), _mm_mul_ps(ayA, axB)), absMask);
+
+        // A's x axis, A's y axis, B's x axis, B's y axis
+        __m128 dist = _mm_and_ps(_mm_add_ps(_mm_mul_ps(tx, axA), _mm_mul_ps(ty, ayA)), absMask);
+        __m128 reach = _mm_add_ps(hwA, _mm_add_ps(_mm_mul_ps(hwB, c), _mm_mul_ps(hhB, s)));
+        __m128 hit = _mm_cmple_ps(dist, reach);
+        dist = _mm_and_ps(_mm_sub_ps(_mm_mul_ps(ty, axA), _mm_mul_ps(tx, ayA)), absMask);
+        reach = _mm_add_ps(hhA, _mm_add_ps(_mm_mul_ps(hwB, s), _mm_mul_ps(hhB, c)));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(dist, reach));
+        dist = _mm_and_ps(_mm_add_ps(_mm_mul_ps(tx, axB), _mm_mul_ps(ty, ayB)), absMask);
+        reach = _mm_add_ps(hwB, _mm_add_ps(_mm_mul_ps(hwA, c), _mm_mul_ps(hhA, s)));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(dist, reach));
+        dist = _mm_and_ps(_mm_sub_ps(_mm_mul_ps(ty, axB), _mm_mul_ps(tx, ayB)), absMask);
+        reach = _mm_add_ps(hhB, _mm_add_ps(_mm_mul_ps(hwA, s), _mm_mul_ps(hhA, c)));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(dist, reach));
+
+        unsigned int bits = (unsigned int)_mm_movemask_ps(hit);
+        hitMask[n / MASK_BITS] |= bits << (n % MASK_BITS);
+    }
+#endif
+
+    // scalar fallback and the pairs left over after the last full block
+    for (; n < pairs; n++)
+    {
+        int i = a[n], j = b[n];
+        float tx = x[j] - x[i];
+        float ty = y[j] - y[i];
+        float c = fabsf(ux[i]*ux[j] + uy[i]*uy[j]);
+        float s = fabsf(ux[i]*uy[j] - uy[i]*ux[j]);
+        if (fabsf(tx*ux[i] + ty*uy[i]) > hw[i] + hw[j]*c + hh[j]*s)
+            continue;
+        if (fabsf(ty*ux[i] - tx*uy[i]) > hh[i] + hw[j]*s + hh[j]*c)
+            continue;
+        if (fabsf(tx*ux[j] + ty*uy[j]) > hw[j] + hw[i]*c + hh[i]*s)
+            continue;
+        if (fabsf(ty*ux[j] - tx*uy[j]) > hh[j] + hw[i]*s + hh[i]*c)
+            continue;
+        hitMask[n / MASK_BITS] |= 1u << (n % MASK_BITS);
+    }
+
+    // count the hits
+    int hits = 0;
+    for (int word = 0; word < getMaskWords(pairs); word++)
+    {
+        unsigned int bits = hitMask[word];
+        while (bits)
+        {
+            bits &= bits - 1;               // clear lowest set bit
+            hits++;
+        }
+    }
+    return hits;
+}
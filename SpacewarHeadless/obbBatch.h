@@ -0,0 +1,57 @@
+#ifndef _OBBBATCH_H             // Prevent multiple definitions if this
+#define _OBBBATCH_H             // file is included in more than one place
+
+#include <vector>
+#include "simd.h"
+
+// Batched rotated box (ROTATED_BOX) collision
+// Boxes are kept as center, unit x axis and half size in separate arrays.
+// The axis is only recomputed by set() when the angle changes, so boxes that
+// move without turning cost no sin or cos. collide() runs the separating
+// axis test on a list of box pairs several pairs at a time, using the four
+// box axes in center and half size form:
+//
+//   separated on axis L if |T.L| > halfA.L + halfB.L
+//
+// where T is the vector between centers. Touching boxes collide, as in
+// Entity::collideRotatedBox. See simd.h for the instruction sets used.
+
+namespace obbBatchNS
+{
+    const int MASK_BITS = 32;       // pairs per hitMask word
+}
+
+class ObbBatch
+{
+private:
+    std::vector<float> x, y;        // box centers
+    std::vector<float> ux, uy;      // unit x axis, (cos, sin) of angle
+    std::vector<float> hw, hh;      // half width and half height, already scaled
+    std::vector<float> angle;       // angle ux, uy were computed for
+
+public:
+    // Remove all boxes
+    void clear();
+
+    // Add a box. Returns its index in the batch.
+    // Pre: cx,cy = center, angle in radians, halfWidth and halfHeight scaled
+    int add(float cx, float cy, float angle, float halfWidth, float halfHeight);
+
+    // Move box i, recomputing its axis only if the angle changed
+    void set(int i, float cx, float cy, float angle);
+
+    // Number of boxes in the batch
+    int getCount() const        {return (int)x.size();}
+
+    // Number of hitMask words needed by collide() for pairs pairs
+    static int getMaskWords(int pairs)
+    {return (pairs + obbBatchNS::MASK_BITS - 1) / obbBatchNS::MASK_BITS;}
+
+    // Test box a[n] against box b[n] for n = 0 to pairs-1
+    // Pre: hitMask has getMaskWords(pairs) entries
+    // Post: bit n%32 of hitMask[n/32] is set if pair n collides
+    //       returns number of colliding pairs
+    int collide(const int *a, const int *b, int pairs, unsigned int *hitMask) const;
+};
+
+#endif
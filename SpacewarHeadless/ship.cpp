@@ -0,0 +1,248 @@
+
+#include "ship.h"
+
+//=============================================================================
+// default constructor
+//=============================================================================
+Ship::Ship() : Entity()
+{
+    spriteData.width = shipNS::WIDTH;           // size of Ship1
+    spriteData.height = shipNS::HEIGHT;
+    spriteData.x = shipNS::X;                   // location on screen
+    spriteData.y = shipNS::Y;
+    spriteData.rect.bottom = shipNS::HEIGHT;    // rectangle to select parts of an image
+    spriteData.rect.right = shipNS::WIDTH;
+    oldX = shipNS::X;
+    oldY = shipNS::Y;
+    oldAngle = 0.0f;
+    rotation = 0.0f;
+    velocity.x = 0;
+    velocity.y = 0;
+    frameDelay = shipNS::SHIP_ANIMATION_DELAY;
+    startFrame = shipNS::SHIP1_START_FRAME;     // first frame of ship animation
+    endFrame     = shipNS::SHIP1_END_FRAME;     // last frame of ship animation
+    currentFrame = startFrame;
+    radius = shipNS::WIDTH/2.0;
+    collisionType = entityNS::CIRCLE;
+    direction = shipNS::NONE;                   // direction of rotation thruster
+    engineOn = false;
+    shieldOn = false;
+    explosionOn = false;
+    mass = shipNS::MASS;
+    strcpy(netIP,"000.000.000.000");  // IP address as dotted quad; nnn.nnn.nnn.nnn
+    timeout = 0;
+    connected = false;
+    buttons = 0;
+    playerN = 0;
+    commWarnings = 0;
+    commErrors = 0;
+}
+
+//=============================================================================
+// Initialize the Ship.
+// Post: returns true if successful, false if failed
+//=============================================================================
+bool Ship::initialize(int width, int height, int ncols)
+{
+    engine.initialize(width, height, ncols);
+    engine.setFrames(shipNS::ENGINE_START_FRAME, shipNS::ENGINE_END_FRAME);
+    engine.setCurrentFrame(shipNS::ENGINE_START_FRAME);
+    engine.setFrameDelay(shipNS::ENGINE_ANIMATION_DELAY);
+    shield.initialize(width, height, ncols);
+    shield.setFrames(shipNS::SHIELD_START_FRAME, shipNS::SHIELD_END_FRAME);
+    shield.setCurrentFrame(shipNS::SHIELD_START_FRAME);
+    shield.setFrameDelay(shipNS::SHIELD_ANIMATION_DELAY);
+    shield.setLoop(false);                  // do not loop animation
+    explosion.initialize(width, height, ncols);
+    explosion.setFrames(shipNS::EXPLOSION_START_FRAME, shipNS::EXPLOSION_END_FRAME);
+    explosion.setCurrentFrame(shipNS::EXPLOSION_START_FRAME);
+    explosion.setFrameDelay(shipNS::EXPLOSION_ANIMATION_DELAY);
+    explosion.setLoop(false);               // do not loop animation
+    return(Entity::initialize(width, height, ncols));
+}
+
+//=============================================================================
+// update
+// typically called once per frame
+// frameTime is used to regulate the speed of movement and animation
+//=============================================================================
+void Ship::update(float frameTime)
+{
+    if(explosionOn)
+    {
+        explosion.update(frameTime);
+        if(explosion.getAnimationComplete())    // if explosion animation complete
+        {
+            explosionOn = false;                // turn off explosion
+            visible = false;
+            explosion.setAnimationComplete(false);
+            explosion.setCurrentFrame(shipNS::EXPLOSION_START_FRAME);
+        }
+    }
+
+    if(shieldOn)
+    {
+        shield.update(frameTime);
+        if(shield.getAnimationComplete())
+        {
+            shieldOn = false;
+            shield.setAnimationComplete(false);
+        }
+    }
+
+    if(engineOn)
+    {
+        velocity.x += (float)cos(spriteData.angle) * shipNS::SPEED * frameTime;
+        velocity.y += (float)sin(spriteData.angle) * shipNS::SPEED * frameTime;
+        engine.update(frameTime);
+    }
+
+    Entity::update(frameTime);
+    // no faster than a snapshot can carry
+    float speed = (float)sqrt(velocity.x*velocity.x + velocity.y*velocity.y);
+    if (speed > shipNS::MAX_SPEED)
+        velocity *= shipNS::MAX_SPEED / speed;
+    oldX = spriteData.x;                        // save current position
+    oldY = spriteData.y;
+    oldAngle = spriteData.angle;
+
+    switch (direction)                          // rotate ship
+    {
+    case shipNS::LEFT:
+        rotation -= frameTime * shipNS::ROTATION_RATE;  // rotate left
+        break;
+    case shipNS::RIGHT:
+        rotation += frameTime * shipNS::ROTATION_RATE;  // rotate right
+        break;
+    default:
+        break;
+    }
+    spriteData.angle += frameTime * rotation;   // apply rotation
+
+    spriteData.x += frameTime * velocity.x;     // move ship along X 
+    spriteData.y += frameTime * velocity.y;     // move ship along Y
+    // Wrap around screen edge
+    if (spriteData.x > GAME_WIDTH)              // if off right screen edge
+        spriteData.x = -shipNS::WIDTH;          // position off left screen edge
+    else if (spriteData.x < -shipNS::WIDTH)     // else if off left screen edge
+        spriteData.x = GAME_WIDTH;              // position off right screen edge
+    if (spriteData.y > GAME_HEIGHT)             // if off bottom screen edge
+        spriteData.y = -shipNS::HEIGHT;         // position off top screen edge
+    else if (spriteData.y < -shipNS::HEIGHT)    // else if off top screen edge
+        spriteData.y = GAME_HEIGHT;             // position off bottom screen edge
+}
+
+//=============================================================================
+// damage
+//=============================================================================
+void Ship::damage(WEAPON weapon)
+{
+    if (shieldOn)
+        return;
+
+    switch(weapon)
+    {
+    case TORPEDO:
+        //audio->playCue(TORPEDO_HIT);
+        health -= shipNS::TORPEDO_DAMAGE;
+        break;
+    case SHIP:
+        //audio->playCue(COLLIDE);    // play sound
+        health -= shipNS::SHIP_DAMAGE;
+        break;
+    case PLANET:
+        health = 0;
+        break;
+    }
+    if (health <= 0)
+        explode();
+    else
+        shieldOn = true;
+}
+
+//=============================================================================
+// explode
+//=============================================================================
+void Ship::explode()
+{
+    //audio->playCue(EXPLODE);
+    active = false;
+    health = 0;
+    explosionOn = true;
+    engineOn = false;
+    shieldOn = false;
+    velocity.x = 0.0f;
+    velocity.y = 0.0f;
+}
+
+//=============================================================================
+// repair
+//=============================================================================
+void Ship::repair()
+{
+    active = true;
+    health = FULL_HEALTH;
+    explosionOn = false;
+    engineOn = false;
+    shieldOn = false;
+    rotation = 0.0f;
+    direction = shipNS::NONE;           // direction of rotation thruster
+    visible = true;
+}
+
+//=============================================================================
+// Sets all ship data from ShipStc sent from server to client
+//  ShipStc
+//      float X;
+//      float Y;
+//      float radians;
+//      float health;
+//      VECTOR2 velocity;
+//      float rotation;         // rotation rate (radians/second)
+//      short score;
+//      UCHAR playerN;          // which player (255 is request to join)
+//      UCHAR flags;            // SHIP_ACTIVE_BIT to SHIP_CONNECTED_BIT
+//=============================================================================
+void Ship::setNetData(ShipStc ss)
+{
+    setX(ss.X);
+    setY(ss.Y);
+    setRadians(ss.radians);
+    setHealth(ss.health);
+    setVelocity(ss.velocity);
+    setRotation(ss.rotation);
+    setActive((ss.flags & spacewarNS::SHIP_ACTIVE_BIT) != 0);
+    if(active)
+        visible = true;
+    setEngineOn((ss.flags & spacewarNS::SHIP_ENGINE_BIT) != 0);
+    setShieldOn((ss.flags & spacewarNS::SHIP_SHIELD_BIT) != 0);
+    setConnected((ss.flags & spacewarNS::SHIP_CONNECTED_BIT) != 0);
+    if(health <= 0 && explosionOn == false && visible) // if ship destroyed
+        explode();
+}
+
+//=============================================================================
+// Return current ship state in ShipStc
+//=============================================================================
+ShipStc Ship::getNetData()
+{
+    ShipStc data;
+    data.X = getX();
+    data.Y = getY();
+    data.radians = getRadians();
+    data.health = getHealth();
+    data.velocity = getVelocity();
+    data.rotation = getRotation();
+    data.score = getScore();
+    data.playerN = getPlayerN();
+    data.flags = 0;
+    if(getActive())
+        data.flags |= spacewarNS::SHIP_ACTIVE_BIT;
+    if(getEngineOn())
+        data.flags |= spacewarNS::SHIP_ENGINE_BIT;
+    if(getShieldOn())
+        data.flags |= spacewarNS::SHIP_SHIELD_BIT;
+    if(getConnected())
+        data.flags |= spacewarNS::SHIP_CONNECTED_BIT;
+    return data;
+}
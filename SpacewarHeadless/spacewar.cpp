@@ -0,0 +1,548 @@
+// This class is the core of the game
+
+#include <string.h>
+#include <algorithm>
+#include "spacewar.h"
+#include "match.h"
+using namespace spacewarNS;
+
+//=============================================================================
+// Constructor
+//=============================================================================
+Spacewar::Spacewar()
+{
+    initialized = false;
+    matchCount = 1;
+    playerLimit = DEFAULT_PLAYERS;
+    threads = 1;
+    port = netNS::DEFAULT_PORT;
+    netEngine = netNS::SOCKETS;
+    netTime = 0;
+    rejected = 0;
+    error = netNS::NET_OK;
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+Spacewar::~Spacewar()
+{
+    pool.shutdown();
+    for (size_t i=0; i<matches.size(); i++)
+        SAFE_DELETE(matches[i]);
+    matches.clear();
+}
+
+//=============================================================================
+// Initializes the game
+// Throws GameError on error
+//=============================================================================
+void Spacewar::initialize(const char *logName, long spin, int backend)
+{
+    std::stringstream ss;
+
+    Game::initialize(logName, spin, backend); // throws GameError
+
+    if (matchCount < 1 || matchCount > MAX_MATCHES)
+        throw(GameError(gameErrorNS::FATAL_ERROR, "Invalid number of matches"));
+    if (pool.initialize(threads) == false)
+        throw(GameError(gameErrorNS::FATAL_ERROR, "Error starting worker threads"));
+
+    // matches
+    for (int i=0; i<matchCount; i++)
+    {
+        matches.push_back(new Match);
+        matches[i]->initialize(i, playerLimit, &net, console);  // throws GameError
+    }
+
+    if (initializeServer(port) != netNS::NET_OK)   // initialize game server
+        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing game server"));
+
+    ss << "Hosting " << matchCount << " matches of " << playerLimit << " players on "
+       << pool.getThreads() << " threads";
+    console->print(ss.str());
+    return;
+}
+
+//=============================================================================
+// Update all matches
+// Each worker updates its matches and handles their collisions in one pass.
+//=============================================================================
+void Spacewar::update()
+{
+    pool.run(matchCount, [this](int i)
+    {
+        matches[i]->update(frameTime);
+        matches[i]->collisions();
+    });
+}
+
+//=============================================================================
+// Artificial Intelligence
+//=============================================================================
+void Spacewar::ai()
+{}
+
+//=============================================================================
+// Handle collisions
+// Collisions are handled per match in update().
+//=============================================================================
+void Spacewar::collisions()
+{}
+
+//=============================================================================
+// process console commands
+//=============================================================================
+void Spacewar::consoleCommand()
+{
+    command = console->getCommand();    // get command from console
+    if(command == "")                   // if no command
+        return;
+
+    if (command == "help")              // if "help" command
+    {
+        console->print("Console Commands:");
+        console->print("fps - display frames per second");
+        console->print("sched - display tick scheduler statistics");
+        console->print("sched reset - clear tick scheduler statistics");
+        console->print("status - display matches with players and scores");
+        console->print("match # - display players in match # with their packet loss");
+        console->print("broadphase grid|sweep - selects collision culling method");
+        console->print("gravity off - turns off planet gravity");
+        console->print("gravity on - turns on planet gravity");
+        console->print("gravity mutual on|off - ships and torpedos attract each other");
+        console->print("gravity theta # - sets Barnes-Hut opening angle, 0 is exact");
+        console->print("gravity tree # - sets gravity sources before Barnes-Hut is used");
+        console->print("well x y [mass] - adds a gravity well, mass in planet masses");
+        console->print("well clear - removes all gravity wells");
+        console->print("burst # - sets torpedos fired per shot, 1 to 8");
+        console->print("rewind - display lag compensation memory and CPU");
+        console->print("rewind # - sets lag compensation window in ms, 0 is off, max 250");
+        console->print("port # - sets port number, CAUTION! Restarts server");
+        console->print("tick # - sets simulation ticks/sec, 0 uses frame time");
+        console->print("quit - shut down the server");
+        return;
+    }
+    else if (command == "fps")
+    {
+        std::stringstream ss;
+        ss << "fps " << (int)fps;
+        console->print(ss.str());
+    }
+    else if (command == "sched")
+        console->print(scheduler.getStatsString());
+    else if (command == "sched reset")
+    {
+        scheduler.resetStats();
+        console->print("Scheduler statistics cleared");
+    }
+    else if (command == "status")
+        printStatus();
+    else if (command.substr(0,5) == "match")
+    {
+        int n = -1;
+        if(command.size() > 6)
+            n = atoi(command.substr(6).c_str());
+        if(n >= 0 && n < matchCount)
+            console->print(matches[n]->getStatus());
+        else
+            console->print("Invalid match number");
+    }
+    else if (command == "broadphase grid" || command == "broadphase sweep")
+    {
+        int method = (command == "broadphase grid") ? broadphaseNS::GRID : broadphaseNS::SWEEP;
+        for (int i=0; i<matchCount; i++)
+            matches[i]->setBroadphase(method);
+        console->print("Collision " + command);
+    }
+    else if (command == "gravity off")
+    {
+        for (int i=0; i<matchCount; i++)
+            matches[i]->setGravity(false);
+        console->print("Gravity Off");
+    }
+    else if (command == "gravity on")
+    {
+        for (int i=0; i<matchCount; i++)
+            matches[i]->setGravity(true);
+        console->print("Gravity On");
+    }
+    else if (command == "gravity mutual on" || command == "gravity mutual off")
+    {
+        bool on = (command == "gravity mutual on");
+        for (int i=0; i<matchCount; i++)
+            matches[i]->setMutualGravity(on);
+        console->print(on ? "Mutual gravity On" : "Mutual gravity Off");
+    }
+    else if (command.substr(0,13) == "gravity theta")
+    {
+        float theta = -1;
+        if(command.size() > 14)
+            theta = (float)atof(command.substr(14).c_str());
+        if(theta >= 0)
+        {
+            for (int i=0; i<matchCount; i++)
+                matches[i]->setGravityTheta(theta);
+            std::stringstream ss;
+            ss << "Barnes-Hut theta " << theta;
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid theta");
+    }
+    else if (command.substr(0,12) == "gravity tree")
+    {
+        int n = -1;
+        if(command.size() > 13)
+            n = atoi(command.substr(13).c_str());
+        if(n >= 0)
+        {
+            for (int i=0; i<matchCount; i++)
+                matches[i]->setGravityTreeThreshold(n);
+            std::stringstream ss;
+            ss << "Barnes-Hut used above " << n << " gravity sources";
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid source count");
+    }
+    else if (command == "well clear")
+    {
+        for (int i=0; i<matchCount; i++)
+            matches[i]->clearWells();
+        console->print("Gravity wells removed");
+    }
+    else if (command.substr(0,4) == "well")
+    {
+        float x = 0, y = 0, mass = 1;
+        std::stringstream args(command.substr(4));
+        if(args >> x >> y)
+        {
+            args >> mass;
+            bool added = true;
+            for (int i=0; i<matchCount; i++)
+                added = matches[i]->addWell(x, y, mass * planetNS::MASS) && added;
+            std::stringstream ss;
+            if (added)
+                ss << "Gravity well at " << x << "," << y << " mass " << mass;
+            else
+                ss << "At most " << MAX_WELLS << " gravity wells";
+            console->print(ss.str());
+        }
+        else
+            console->print("Usage: well x y [mass]");
+    }
+    else if (command.substr(0,5) == "burst")
+    {
+        int n = 0;
+        if(command.size() > 6)
+            n = atoi(command.substr(6).c_str());
+        if(n >= 1 && n <= worldNS::MAX_BURST)
+        {
+            for (int i=0; i<matchCount; i++)
+                matches[i]->setBurst(n);
+            std::stringstream ss;
+            ss << "Torpedos per shot " << n;
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid burst size");
+    }
+    else if (command == "rewind")
+    {
+        size_t bytes = 0;
+        double seconds = 0;
+        unsigned int ticks = 0;
+        for (int i=0; i<matchCount; i++)
+        {
+            bytes += matches[i]->getRewind().getBytes();
+            seconds += matches[i]->getRewindTime();
+            ticks += matches[i]->getRewindTicks();
+        }
+        std::stringstream ss;
+        ss << "Lag compensation window "
+           << (int)(matchCount ? matches[0]->getRewind().getWindow() * 1000 : 0) << " ms, "
+           << bytes / 1024 << " KB in " << matchCount << " matches, "
+           << (ticks ? seconds / ticks * 1e6 : 0) << " us per tick over " << ticks << " ticks";
+        console->print(ss.str());
+    }
+    else if (command.substr(0,6) == "rewind")
+    {
+        int ms = -1;
+        if(command.size() > 7)
+            ms = atoi(command.substr(7).c_str());
+        if(ms >= 0 && ms <= (int)(rewindNS::MAX_WINDOW * 1000))
+        {
+            for (int i=0; i<matchCount; i++)
+                matches[i]->setRewindWindow(ms / 1000.0f);
+            std::stringstream ss;
+            ss << "Lag compensation window " << ms << " ms";
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid rewind window");
+    }
+    else if (command.substr(0,4) == "tick")
+    {
+        std::stringstream ss;
+        if(command.size() > 5)
+            setSimRate((float)atof(command.substr(5).c_str()));
+        if(getSimRate() > 0)
+            ss << "Simulation rate " << getSimRate() << " ticks/sec";
+        else
+            ss << "Simulation uses variable frame time";
+        console->print(ss.str());
+    }
+    else if (command.substr(0,4) == "port")
+    {
+        int newPort = 0;
+        if(command.size() > 5)
+            newPort = atoi(command.substr(5).c_str());
+        if(newPort > netNS::MIN_PORT && newPort < 65536)
+        {
+            port = newPort;             // set new port
+            netTime = 0;
+            initializeServer(port);     // re-initialize game server
+        }
+        else
+            console->print("Invalid port number");
+    }
+    else if (command == "quit")
+    {
+        console->print("Server shutting down.");
+        exitGame();
+    }
+    else
+        console->print("Unknown command, type help for a list of commands");
+}
+
+//=============================================================================
+// Display connected players and scores for every match with players
+//=============================================================================
+void Spacewar::printStatus()
+{
+    std::stringstream ss;
+    int players = 0;
+    int active = 0;
+
+    for (int i=0; i<matchCount; i++)
+    {
+        int count = matches[i]->getPlayerCount();
+        players += count;
+        if (count > 0)
+            active++;
+    }
+    ss << "Port: " << port << "  Matches: " << active << "/" << matchCount
+       << "  Threads: " << pool.getThreads() << "  Players: " << players
+       << "  Rejected: " << rejected;
+    console->print(ss.str());
+    for (int i=0; i<matchCount; i++)
+    {
+        if (matches[i]->getPlayerCount() > 0)
+            console->print(matches[i]->getStatus());
+    }
+}
+
+////////////////////////////
+//   Network Functions    //
+////////////////////////////
+
+//=============================================================================
+// Initialize Server
+//=============================================================================
+int Spacewar::initializeServer(int port)
+{
+    std::stringstream ss;
+
+    if(port < netNS::MIN_PORT)
+    {
+        console->print("Invalid port number");
+        return netNS::NET_ERROR;
+    }
+    // ----- Initialize network stuff -----
+    error = net.createServer(port, netNS::UDP, true);   // IPv4 and IPv6 clients
+    if(error != netNS::NET_OK)              // if error
+    {
+        console->print(net.getError(error));
+        return netNS::NET_ERROR;
+    }
+    int engine = net.setEngine(netEngine);
+    if (engine != netEngine)
+        console->print("Network engine not available, using " + std::string(netNS::ENGINE_NAMES[engine]));
+
+    for (int i=0; i<matchCount; i++)        // for all matches
+        matches[i]->reset();
+    connections.clear();
+
+    console->print("----- Server -----");
+    net.getLocalIP(localIP);
+    ss << "Server IP: " << localIP;
+    console->print(ss.str());
+    ss.str("");                             // clear stringstream
+    ss << "Port: " << port << " (" << netNS::ENGINE_NAMES[engine]
+       << (net.isDualStack() ? ", IPv4 and IPv6)" : ", IPv4)");
+    console->print(ss.str());
+    return netNS::NET_OK;
+}
+
+//=============================================================================
+// Do network communications
+// Datagrams are read and routed on the main thread, then each worker
+// replies to the players in its matches.
+//=============================================================================
+void Spacewar::communicate(float frameTime)
+{
+    // this function is not delayed so client response is as fast as possible
+    readClientData();
+
+    pool.run(matchCount, [this, frameTime](int i)
+    {
+        matches[i]->communicate(frameTime);
+    });
+    net.flush();                // send the replies queued by the matches
+
+    // calculate elapsed time for network communications
+    netTime += frameTime;
+    if(netTime < netNS::NET_TIME)      // if not time to communicate
+        return;
+    netTime -= netNS::NET_TIME;
+
+    // forget addresses of players that timed out, every NET_TIME seconds
+    removeStaleConnections();
+}
+
+//=============================================================================
+// Read waiting datagrams and queue each one with the match it belongs to
+// Datagrams are read MAX_BATCH at a time.
+//=============================================================================
+void Spacewar::readClientData()
+{
+    int count;
+    int status;
+    int maxReads = matchCount * playerLimit * READS_PER_PLAYER;
+
+    for (int reads=0; reads<maxReads; reads+=count)
+    {
+        count = std::min(maxReads - reads, netNS::MAX_BATCH);
+        for (int n=0; n<count; n++)
+        {
+            inPacket[n].data = inData[n];
+            inPacket[n].size = messageNS::TO_SERVER_SIZE;
+        }
+        status = net.readBatch(inPacket, count);
+
+        for (int n=0; n<count; n++)
+        {
+            if(!readToServer(inPacket[n].data, inPacket[n].size, toServerData))
+                continue;       // runt datagram
+            remoteAddr = inPacket[n].address;
+            readClientPacket();
+        }
+        // stop on a read error or when no more data is waiting
+        if(status != netNS::NET_OK || count < netNS::MAX_BATCH)
+            break;
+    }
+}
+
+//=============================================================================
+// Route toServerData from remoteAddr to its match
+// Input is only accepted from a connected player's address with that
+// player's token, anything else is dropped here.
+//=============================================================================
+void Spacewar::readClientPacket()
+{
+    std::unordered_map<NetAddress, Connection, NetAddressHash>::iterator found =
+        connections.find(remoteAddr);
+    if (found != connections.end())
+    {
+        const Connection &connection = found->second;
+        if (matches[connection.matchN]->isPlayer(connection.playerN, remoteAddr))
+        {
+            if (toServerData.playerN == 255)    // connect response was lost
+                sendConnectResponse(connection);
+            else if (toServerData.token == connection.token)
+                matches[connection.matchN]->addInput(connection.playerN, toServerData.buttons,
+                                                    toServerData.ack, toServerData.delay,
+                                                    toServerData.header);
+            else
+                rejected++;     // stale or spoofed
+            return;
+        }
+        connections.erase(found);   // player timed out
+    }
+
+    if (toServerData.playerN == 255)    // if request to join game
+        clientWantsToJoin();
+    else
+        rejected++;             // not from a connected player
+}
+
+//=============================================================================
+// Client is requesting to join a game
+// Players are placed in the first match with an open position.
+//=============================================================================
+void Spacewar::clientWantsToJoin()
+{
+    char response[messageNS::CONNECT_RESPONSE_SIZE];
+    int size;
+
+    console->print("Player requesting to join.");
+    for (int i=0; i<matchCount; i++)        // search all matches
+    {
+        if (matches[i]->hasOpening())
+        {
+            Connection connection;
+            connection.matchN = i;
+            connection.playerN = matches[i]->addPlayer(remoteAddr);
+            do
+                connection.token = tokenSource();
+            while (connection.token == 0);      // 0 is sent by joining clients
+            connections[remoteAddr] = connection;
+            sendConnectResponse(connection);
+            return;
+        }
+    }
+    // send SERVER_FULL to client
+    strcpy(connectResponse.response, netNS::SERVER_FULL);
+    connectResponse.number = 255;       // set to invalid player number
+    connectResponse.token = 0;
+    writeConnectResponse(connectResponse, response);
+    size = messageNS::CONNECT_RESPONSE_SIZE;
+    net.sendTo(response, size, remoteAddr);
+    console->print("Server full.");
+}
+
+//=============================================================================
+// Send SERVER_ID, player number and session token to the client at remoteAddr
+//=============================================================================
+void Spacewar::sendConnectResponse(const Connection &connection)
+{
+    char response[messageNS::CONNECT_RESPONSE_SIZE];
+    int size;
+    int status;
+
+    strcpy(connectResponse.response, netNS::SERVER_ID);
+    connectResponse.number = (UCHAR)connection.playerN;
+    connectResponse.token = connection.token;
+    writeConnectResponse(connectResponse, response);
+    size = messageNS::CONNECT_RESPONSE_SIZE;
+    status = net.sendTo(response, size, remoteAddr);
+    if ( (status & netNS::STATUS_MASK) == netNS::NET_ERROR) 
+        console->print(net.getError(status));   // display error message
+}
+
+//=============================================================================
+// Remove connections of players that are no longer connected
+//=============================================================================
+void Spacewar::removeStaleConnections()
+{
+    std::unordered_map<NetAddress, Connection, NetAddressHash>::iterator found =
+        connections.begin();
+    while (found != connections.end())
+    {
+        if (matches[found->second.matchN]->isPlayer(found->second.playerN, found->first))
+            ++found;
+        else
+            found = connections.erase(found);
+    }
+}
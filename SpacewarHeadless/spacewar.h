@@ -0,0 +1,121 @@
+#ifndef _SPACEWAR_H             // Prevent multiple definitions if this 
+#define _SPACEWAR_H             // file is included in more than one place
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include "game.h"
+#include "planet.h"
+#include "ship.h"
+#include "torpedo.h"
+#include "net.h"
+#include "packetLink.h"
+#include "protocol.h"
+#include "workerPool.h"
+
+namespace spacewarNS
+{
+    const int COUNT_DOWN = 5;           // count down from 5
+    const int ROUND_TIME = 5;           // time until new round starts
+    const int START_TIME = 5;           // delay until round timer starts
+    // Game types
+    const int CLIENT = 1;           // client in network game
+    const int SERVER = 2;           // server in network game
+    const int DEFAULT_PLAYERS = 2;  // players per match unless set with -n
+    const int MAX_MATCHES = 4096;   // maximum number of matches per server
+    const int READS_PER_PLAYER = 4; // datagrams read per player each frame
+    // Starting orbits, ships fill the first ring before the next
+    const int   ORBITS = 3;
+    const float ORBIT_RADIUS[ORBITS] = {GAME_WIDTH/4.0f, GAME_WIDTH/4.0f + 60, GAME_WIDTH/4.0f - 60};
+    const float ORBIT_SPACING = 44;     // minimum distance between ships on an orbit
+    // Network
+    const int BUFSIZE = 256;
+}
+
+// A connected player, found by the address its datagrams come from
+struct Connection
+{
+    int     matchN;     // match the player is in
+    int     playerN;    // player number within the match
+    UINT    token;      // random, must arrive with every ToServerStc
+};
+
+//=============================================================================
+// Spacewar dedicated server without window, graphics or audio.
+// Hosts any number of independent matches behind one UDP port.
+// Each datagram is routed to its match by the sender's address and only
+// accepted with that player's session token. The matches are simulated on
+// a pool of worker threads.
+//=============================================================================
+class Match;
+
+class Spacewar : public Game
+{
+private:
+    // game items
+    std::vector<Match*> matches;    // independent games
+    WorkerPool pool;                // threads that run the matches
+    int     matchCount;             // number of matches hosted
+    int     playerLimit;            // players per match
+    int     threads;                // worker threads including the main thread
+
+    // Network variables
+    Net  net;                   // network object, shared by all matches
+    USHORT port;                // Port number
+    int    netEngine;           // netNS::ENGINE requested for the socket
+    NetAddress remoteAddr;      // address of the client being served
+    char localIP[16];           // Local IP address as dotted quad; nnn.nnn.nnn.nnn
+    ToServerStc toServerData;
+    char inData[netNS::MAX_BATCH][messageNS::TO_SERVER_SIZE];   // buffers for one readBatch
+    NetPacket   inPacket[netNS::MAX_BATCH];
+    ConnectResponse connectResponse;
+    // player address -> session
+    std::unordered_map<NetAddress, Connection, NetAddressHash> connections;
+    std::random_device tokenSource; // unpredictable session tokens
+    UINT rejected;              // datagrams not from a connected player
+    float netTime;
+    int error;
+
+public:
+    // Constructor
+    Spacewar();
+    // Destructor
+    virtual ~Spacewar();
+    // Initialize the game
+    void initialize(const char *logName = NULL,
+                    long spin = tickSchedulerNS::DEFAULT_SPIN_NS,
+                    int backend = tickSchedulerNS::SLEEP);
+    void update();      // must override pure virtual from Game
+    void ai();          // "
+    void collisions();  // "
+    void consoleCommand(); // process console command
+    void printStatus(); // display connected players and scores
+
+    // Set port number, call before initialize
+    void setPort(int p) {port = (USHORT)p;}
+
+    // Set number of matches hosted, call before initialize
+    void setMatches(int n)  {matchCount = n;}
+
+    // Set number of players per match, call before initialize
+    void setPlayers(int n)  {playerLimit = n;}
+
+    // Set number of worker threads including the main thread, call before initialize
+    void setThreads(int n)  {threads = n;}
+
+    // Set netNS::SOCKETS, EPOLL or URING, call before initialize
+    void setNetEngine(int e)    {netEngine = e;}
+
+    // Network functions
+    void communicate(float frameTime);
+    int  initializeServer(int port);
+    void readClientData();
+    void readClientPacket();
+    void clientWantsToJoin();
+    void sendConnectResponse(const Connection &connection);
+    void removeStaleConnections();
+};
+
+#endif
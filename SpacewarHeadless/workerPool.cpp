@@ -0,0 +1,126 @@
+#include "workerPool.h"
+using namespace workerPoolNS;
+
+//=============================================================================
+// Constructor
+//=============================================================================
+WorkerPool::WorkerPool()
+{
+    job = NULL;
+    jobCount = 0;
+    generation = 0;
+    pending = 0;
+    quit = false;
+}
+
+//=============================================================================
+// Destructor
+//=============================================================================
+WorkerPool::~WorkerPool()
+{
+    shutdown();
+}
+
+//=============================================================================
+// Start threads-1 helper threads
+// Returns false if the threads could not be started
+//=============================================================================
+bool WorkerPool::initialize(int threads)
+{
+    shutdown();
+    if (threads < 1 || threads > MAX_THREADS)
+        return false;
+    quit = false;
+    try
+    {
+        for (int i=1; i<threads; i++)
+            workers.push_back(std::thread(&WorkerPool::workerMain, this, i, generation));
+    }
+    catch(...)
+    {
+        shutdown();
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// Call job(i) for i = 0 to count-1 spread over the pool
+//=============================================================================
+void WorkerPool::run(int count, const std::function<void(int)> &job)
+{
+    if (workers.empty())            // no helpers, run everything here
+    {
+        for (int i=0; i<count; i++)
+            job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        this->job = &job;
+        jobCount = count;
+        pending = (int)workers.size();
+        generation++;
+    }
+    start.notify_all();
+
+    runShare(0, job, count);        // the caller is thread 0
+
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this]{return pending == 0;});
+    this->job = NULL;
+}
+
+//=============================================================================
+// Run job on every index belonging to thread
+//=============================================================================
+void WorkerPool::runShare(int thread, const std::function<void(int)> &job, int count)
+{
+    int stride = getThreads();
+    for (int i=thread; i<count; i+=stride)
+        job(i);
+}
+
+//=============================================================================
+// Helper thread, waits for a job, runs its share and reports back
+//=============================================================================
+void WorkerPool::workerMain(int thread, unsigned seen)
+{
+    const std::function<void(int)> *current;
+    int count;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            start.wait(guard, [&]{return quit || generation != seen;});
+            if (quit)
+                return;
+            seen = generation;
+            current = job;
+            count = jobCount;
+        }
+
+        runShare(thread, *current, count);
+
+        std::lock_guard<std::mutex> guard(lock);
+        if (--pending == 0)
+            done.notify_one();
+    }
+}
+
+//=============================================================================
+// Stop and join the helper threads
+//=============================================================================
+void WorkerPool::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    start.notify_all();
+    for (size_t i=0; i<workers.size(); i++)
+        workers[i].join();
+    workers.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef _WORKERPOOL_H           // Prevent multiple definitions if this 
+#define _WORKERPOOL_H           // file is included in more than one place
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Worker thread pool
+// Runs a job over a range of indices on a fixed set of threads and returns
+// when every index is done. Index i always runs on the same thread
+// (i modulo the thread count) so each thread keeps working on the same data.
+// The calling thread takes a share of the work, a pool of 1 thread runs
+// everything on the caller.
+
+namespace workerPoolNS
+{
+    const int MAX_THREADS = 64;
+}
+
+class WorkerPool
+{
+private:
+    std::vector<std::thread> workers;   // helper threads, the caller is thread 0
+    std::mutex  lock;
+    std::condition_variable start;      // signalled when a job is posted
+    std::condition_variable done;       // signalled when the last helper finishes
+    const std::function<void(int)> *job;
+    int         jobCount;               // number of indices in the current job
+    unsigned    generation;             // incremented for each job posted
+    int         pending;                // helpers still working on the current job
+    bool        quit;
+
+    // Run job on the indices belonging to thread
+    void runShare(int thread, const std::function<void(int)> &job, int count);
+    // Helper thread main loop, seen = generation when the thread was started
+    void workerMain(int thread, unsigned seen);
+
+public:
+    // Constructor
+    WorkerPool();
+    // Destructor
+    virtual ~WorkerPool();
+
+    // Start the pool
+    // Pre: threads = total threads including the caller, 1 to MAX_THREADS
+    // Returns false if the threads could not be started
+    bool initialize(int threads);
+
+    // Call job(i) for i = 0 to count-1 spread over the pool.
+    // Returns when all calls have returned.
+    void run(int count, const std::function<void(int)> &job);
+
+    // Stop and join the helper threads
+    void shutdown();
+
+    // Return total threads including the caller
+    int getThreads()    {return (int)workers.size() + 1;}
+};
+
+#endif
@@ -0,0 +1,524 @@
+// Simulation state of every ship and torpedo in one match
+
+#include <math.h>
+#include "world.h"
+using namespace worldNS;
+
+//=============================================================================
+// Constructor
+//=============================================================================
+World::World()
+{
+    ships = 0;
+    slots = 0;
+    nextTorpedoId = 0;
+}
+
+//=============================================================================
+// Create ships and the torpedo pool
+//=============================================================================
+void World::initialize(int shipCount)
+{
+    ships = shipCount;
+    slots = ships * MAX_BURST;
+    int bodies = ships + slots;
+
+    x.assign(bodies, 0);
+    y.assign(bodies, 0);
+    vx.assign(bodies, 0);
+    vy.assign(bodies, 0);
+    mx.assign(bodies, 0);
+    my.assign(bodies, 0);
+    mass.assign(bodies, 0);
+    flags.assign(bodies, 0);
+    cx.assign(bodies, 0);
+    cy.assign(bodies, 0);
+    gvx.assign(bodies, 0);
+    gvy.assign(bodies, 0);
+    gm.assign(bodies, 0);
+    pullMass.assign(bodies, 0);
+
+    dvx.assign(ships, 0);
+    dvy.assign(ships, 0);
+    angle.assign(ships, 0);
+    rotation.assign(ships, 0);
+    health.assign(ships, FULL_HEALTH);
+    oldX.assign(ships, (float)shipNS::X);
+    oldY.assign(ships, (float)shipNS::Y);
+    oldAngle.assign(ships, 0);
+    direction.assign(ships, (signed char)shipNS::NONE);
+    shieldTimer.assign(ships, 0);
+    explosionTimer.assign(ships, 0);
+    shieldFrame.assign(ships, 0);
+    explosionFrame.assign(ships, 0);
+    fireTimer.assign(ships, 0);
+
+    owner.assign(slots, 0);
+    life.assign(slots, 0);
+    torpedoId.assign(slots, 0);
+    livePos.assign(slots, 0);
+    freeSlots.clear();
+    freeSlots.reserve(slots);
+    live.clear();
+    live.reserve(slots);
+    clearTorpedos();
+
+    for (int p=0; p<ships; p++)
+    {
+        x[p] = (float)shipNS::X;
+        y[p] = (float)shipNS::Y;
+        mass[p] = shipNS::MASS;
+    }
+    for (int i=ships; i<bodies; i++)
+        mass[i] = torpedoNS::MASS;
+}
+
+//=============================================================================
+// Return every torpedo slot to the free list
+// Lowest slots are handed out first.
+//=============================================================================
+void World::clearTorpedos()
+{
+    for (size_t n=0; n<live.size(); n++)
+        flags[ships + live[n]] = 0;
+    live.clear();
+    freeSlots.clear();
+    for (int slot=slots-1; slot>=0; slot--)
+        freeSlots.push_back(slot);
+}
+
+//=============================================================================
+// Advance an animation of frames+1 frames that does not loop.
+// Returns true on the tick it completes; the frame then stays on the last
+// frame until the caller resets it, as Image does.
+//=============================================================================
+bool World::animate(float &timer, int &frame, int frames, float delay, float frameTime)
+{
+    timer += frameTime;
+    if (timer > delay)
+    {
+        timer -= delay;
+        frame++;
+        if (frame > frames)
+        {
+            frame = frames;
+            return true;
+        }
+    }
+    return false;
+}
+
+//=============================================================================
+// Move every ship and torpedo
+//=============================================================================
+void World::update(float frameTime)
+{
+    for (int p=0; p<ships; p++)
+    {
+        if (flags[p] & EXPLOSION)
+        {
+            if (animate(explosionTimer[p], explosionFrame[p], EXPLOSION_FRAMES,
+                        shipNS::EXPLOSION_ANIMATION_DELAY, frameTime))
+            {
+                flags[p] &= ~(EXPLOSION | VISIBLE);
+                explosionFrame[p] = 0;
+            }
+        }
+        if (flags[p] & SHIELD)
+        {
+            if (animate(shieldTimer[p], shieldFrame[p], SHIELD_FRAMES,
+                        shipNS::SHIELD_ANIMATION_DELAY, frameTime))
+                flags[p] &= ~SHIELD;
+        }
+        if (flags[p] & ENGINE)
+        {
+            vx[p] += (float)cos(angle[p]) * shipNS::SPEED * frameTime;
+            vy[p] += (float)sin(angle[p]) * shipNS::SPEED * frameTime;
+        }
+        vx[p] += dvx[p];
+        vy[p] += dvy[p];
+        dvx[p] = 0;
+        dvy[p] = 0;
+        // no faster than a snapshot can carry
+        float speed = sqrtf(vx[p]*vx[p] + vy[p]*vy[p]);
+        if (speed > shipNS::MAX_SPEED)
+        {
+            vx[p] *= shipNS::MAX_SPEED / speed;
+            vy[p] *= shipNS::MAX_SPEED / speed;
+        }
+
+        oldX[p] = x[p];                         // save current position
+        oldY[p] = y[p];
+        oldAngle[p] = angle[p];
+        if (direction[p] == shipNS::LEFT)
+            rotation[p] -= frameTime * shipNS::ROTATION_RATE;
+        else if (direction[p] == shipNS::RIGHT)
+            rotation[p] += frameTime * shipNS::ROTATION_RATE;
+        angle[p] += frameTime * rotation[p];
+        move(p, frameTime);
+        fireTimer[p] -= frameTime;              // time remaining until fire enabled
+    }
+
+    // backwards, so a removed torpedo is replaced by one already moved
+    for (int n=(int)live.size()-1; n>=0; n--)
+    {
+        int slot = live[n];
+        life[slot] -= frameTime;
+        move(ships + slot, frameTime);
+        if (life[slot] < 0)                     // old torpedo off
+            removeTorpedo(ships + slot);
+    }
+}
+
+//=============================================================================
+// Move body i by its velocity and wrap around the screen edge.
+// Ships and torpedos are both 32x32.
+//=============================================================================
+void World::move(int i, float frameTime)
+{
+    mx[i] = frameTime * vx[i];
+    my[i] = frameTime * vy[i];
+    x[i] += mx[i];
+    y[i] += my[i];
+    if (x[i] > GAME_WIDTH)                      // if off right screen edge
+        x[i] = -(float)shipNS::WIDTH;           // position off left screen edge
+    else if (x[i] < -shipNS::WIDTH)             // else if off left screen edge
+        x[i] = (float)GAME_WIDTH;               // position off right screen edge
+    if (y[i] > GAME_HEIGHT)                     // if off bottom screen edge
+        y[i] = -(float)shipNS::HEIGHT;          // position off top screen edge
+    else if (y[i] < -shipNS::HEIGHT)            // else if off top screen edge
+        y[i] = (float)GAME_HEIGHT;              // position off bottom screen edge
+}
+
+//=============================================================================
+// Gravity on every active body
+// Inactive bodies neither pull nor are pulled, as in Entity::gravityForce.
+//=============================================================================
+void World::applyGravity(GravityBatch &batch, float frameTime)
+{
+    int count = ships + (int)live.size();
+    if (count == 0)
+        return;
+    // pack the ships and live torpedos, only they are pulled
+    for (int n=0; n<count; n++)
+    {
+        int i = (n < ships) ? n : ships + live[n - ships];
+        bool active = (flags[i] & ACTIVE) != 0;
+        cx[n] = getCenterX(i);
+        cy[n] = getCenterY(i);
+        gvx[n] = vx[i];
+        gvy[n] = vy[i];
+        gm[n] = active ? entityNS::GRAVITY * mass[i] : 0;
+        pullMass[n] = active ? mass[i] : 0;
+    }
+    batch.pull(&cx[0], &cy[0], &gvx[0], &gvy[0], &gm[0], &pullMass[0], count, frameTime);
+    for (int n=0; n<count; n++)
+    {
+        int i = (n < ships) ? n : ships + live[n - ships];
+        vx[i] = gvx[n];
+        vy[i] = gvy[n];
+    }
+}
+
+//=============================================================================
+// Center of body i
+//=============================================================================
+float World::getCenterX(int i) const
+{
+    return x[i] + shipNS::WIDTH/2;
+}
+
+float World::getCenterY(int i) const
+{
+    return y[i] + shipNS::HEIGHT/2;
+}
+
+//=============================================================================
+// Circle collision between bodies a and b
+//=============================================================================
+bool World::collides(int a, int b, VECTOR2 &collisionVector) const
+{
+    if (!getActive(a) || !getActive(b))
+        return false;
+    float dx = getCenterX(a) - getCenterX(b);
+    float dy = getCenterY(a) - getCenterY(b);
+    float sumRadii = getRadius(a) + getRadius(b);
+    if (dx*dx + dy*dy <= sumRadii*sumRadii)
+    {
+        collisionVector = VECTOR2(getCenterX(b) - getCenterX(a), getCenterY(b) - getCenterY(a));
+        return true;
+    }
+    return false;
+}
+
+//=============================================================================
+// Time of first contact between two circles over one move
+// p = start of b relative to a, d = move of b relative to a, r = sum of radii
+// Solves |p + t*d| = r for the smallest t in 0 to 1.
+//=============================================================================
+static bool timeOfImpact(float px, float py, float dx, float dy, float r, float &toi)
+{
+    float c = px*px + py*py - r*r;
+    if (c <= 0)                 // touching at the start
+    {
+        toi = 0;
+        return true;
+    }
+    float a = dx*dx + dy*dy;
+    float b = px*dx + py*dy;
+    if (a <= 0 || b >= 0)       // not moving closer
+        return false;
+    float disc = b*b - a*c;
+    if (disc < 0)               // closest approach is farther than r
+        return false;
+    float t = (-b - sqrtf(disc)) / a;
+    if (t > 1)                  // contact is after this move
+        return false;
+    toi = t;
+    return true;
+}
+
+//=============================================================================
+// Swept circle collision between bodies a and b
+// Both are swept back along their last move. A body that wrapped around the
+// screen edge is swept from just outside the edge it came back in at, never
+// across the screen.
+//=============================================================================
+bool World::sweep(int a, int b, float &toi) const
+{
+    if (!getActive(a) || !getActive(b))
+        return false;
+    float px = (getCenterX(b) - mx[b]) - (getCenterX(a) - mx[a]);
+    float py = (getCenterY(b) - my[b]) - (getCenterY(a) - my[a]);
+    return timeOfImpact(px, py, mx[b] - mx[a], my[b] - my[a],
+                        getRadius(a) + getRadius(b), toi);
+}
+
+//=============================================================================
+// Swept circle collision between body a and a fixed circle
+//=============================================================================
+bool World::sweep(int a, float cx, float cy, float radius, float &toi) const
+{
+    if (!getActive(a))
+        return false;
+    float px = (getCenterX(a) - mx[a]) - cx;
+    float py = (getCenterY(a) - my[a]) - cy;
+    return timeOfImpact(px, py, mx[a], my[a], getRadius(a) + radius, toi);
+}
+
+//=============================================================================
+// Turn ship p engine on or off
+//=============================================================================
+void World::setEngineOn(int p, bool on)
+{
+    if (on)
+        flags[p] |= ENGINE;
+    else
+        flags[p] &= ~ENGINE;
+}
+
+//=============================================================================
+// Fire a burst of torpedos from ship p if it is ready
+// Torpedos are spaced BURST_SPREAD apart, centered on the ship's heading.
+// Fewer are fired if the pool runs out.
+//=============================================================================
+int World::fire(int p, int count)
+{
+    if (fireTimer[p] > 0.0f)
+        return 0;
+    if (count > MAX_BURST)
+        count = MAX_BURST;
+    int fired = 0;
+    for (; fired < count && !freeSlots.empty(); fired++)
+    {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        livePos[slot] = (int)live.size();
+        live.push_back(slot);
+
+        int t = ships + slot;
+        float a = angle[p] + (fired - (count-1)/2.0f) * BURST_SPREAD;
+        vx[t] = (float)cos(a) * torpedoNS::SPEED;
+        vy[t] = (float)sin(a) * torpedoNS::SPEED;
+        x[t] = getCenterX(p) - torpedoNS::WIDTH/2;
+        y[t] = getCenterY(p) - torpedoNS::HEIGHT/2;
+        mx[t] = 0;                              // has not moved yet
+        my[t] = 0;
+        flags[t] = VISIBLE | ACTIVE;            // visible and enable collisions
+        owner[slot] = p;
+        life[slot] = torpedoNS::FIRE_DELAY;
+        torpedoId[slot] = nextTorpedoId++;
+    }
+    if (fired > 0)
+        fireTimer[p] = torpedoNS::FIRE_DELAY;   // delay firing
+    return fired;
+}
+
+//=============================================================================
+// Damage ship p with weapon
+//=============================================================================
+void World::damage(int p, WEAPON weapon)
+{
+    if (flags[p] & SHIELD)
+        return;
+
+    switch(weapon)
+    {
+    case TORPEDO:
+        health[p] -= shipNS::TORPEDO_DAMAGE;
+        break;
+    case SHIP:
+        health[p] -= shipNS::SHIP_DAMAGE;
+        break;
+    case PLANET:
+        health[p] = 0;
+        break;
+    }
+    if (health[p] <= 0)
+        explode(p);
+    else
+        flags[p] |= SHIELD;
+}
+
+//=============================================================================
+// Ship p explodes
+//=============================================================================
+void World::explode(int p)
+{
+    flags[p] &= ~(ACTIVE | ENGINE | SHIELD);
+    flags[p] |= EXPLOSION;
+    health[p] = 0;
+    vx[p] = 0.0f;
+    vy[p] = 0.0f;
+}
+
+//=============================================================================
+// Ship p is repaired
+//=============================================================================
+void World::repair(int p)
+{
+    flags[p] &= ~(EXPLOSION | ENGINE | SHIELD);
+    flags[p] |= ACTIVE | VISIBLE;
+    health[p] = FULL_HEALTH;
+    rotation[p] = 0.0f;
+    direction[p] = (signed char)shipNS::NONE;
+    mx[p] = 0;
+    my[p] = 0;
+}
+
+//=============================================================================
+// Move ship p out of collision
+//=============================================================================
+void World::toOldPosition(int p)
+{
+    x[p] = oldX[p];
+    y[p] = oldY[p];
+    angle[p] = oldAngle[p];
+    rotation[p] = 0.0f;
+    mx[p] = 0;                                  // back where it started
+    my[p] = 0;
+}
+
+//=============================================================================
+// Ship p bounces off body other, as Entity::bounce
+//=============================================================================
+void World::bounce(int p, const VECTOR2 &collisionVector, int other)
+{
+    VECTOR2 Vdiff = getVelocity(other) - getVelocity(p);
+    VECTOR2 cUV = collisionVector;              // collision unit vector
+    vector2Normalize(cUV);
+    float cUVdotVdiff = vector2Dot(cUV, Vdiff);
+    float massRatio = 2.0f;
+    if (mass[p] != 0)
+        massRatio *= (mass[other] / (mass[p] + mass[other]));
+
+    // If ships are already moving apart then bounce must
+    // have been previously called and they are still colliding.
+    // Move ship apart along collisionVector
+    if(cUVdotVdiff > 0)
+    {
+        x[p] -= cUV.x * massRatio;
+        y[p] -= cUV.y * massRatio;
+    }
+    else
+    {
+        dvx[p] += massRatio * cUVdotVdiff * cUV.x;
+        dvy[p] += massRatio * cUVdotVdiff * cUV.y;
+    }
+}
+
+//=============================================================================
+// Remove torpedo body i
+// The last live torpedo takes its place in the live list.
+//=============================================================================
+void World::removeTorpedo(int i)
+{
+    int slot = i - ships;
+    if (!(flags[i] & VISIBLE))                  // already removed
+        return;
+    flags[i] = 0;
+    int pos = livePos[slot];
+    int last = live.back();
+    live[pos] = last;
+    livePos[last] = pos;
+    live.pop_back();
+    freeSlots.push_back(slot);
+}
+
+//=============================================================================
+// Set active and visible flags of body i
+//=============================================================================
+void World::setActive(int i, bool a)
+{
+    if (a)
+        flags[i] |= ACTIVE;
+    else
+        flags[i] &= ~ACTIVE;
+}
+
+void World::setVisible(int i, bool v)
+{
+    if (v)
+        flags[i] |= VISIBLE;
+    else
+        flags[i] &= ~VISIBLE;
+}
+
+//=============================================================================
+// Return ship p state, flags bits 0-2 as Ship::getNetData
+//=============================================================================
+ShipStc World::getShipNetData(int p) const
+{
+    ShipStc data;
+    data.X = x[p];
+    data.Y = y[p];
+    data.radians = angle[p];
+    data.health = health[p];
+    data.velocity = getVelocity(p);
+    data.rotation = rotation[p];
+    data.score = 0;
+    data.playerN = (UCHAR)p;
+    data.flags = 0;
+    if (flags[p] & ACTIVE)
+        data.flags |= spacewarNS::SHIP_ACTIVE_BIT;
+    if (flags[p] & ENGINE)
+        data.flags |= spacewarNS::SHIP_ENGINE_BIT;
+    if (flags[p] & SHIELD)
+        data.flags |= spacewarNS::SHIP_SHIELD_BIT;
+    return data;
+}
+
+//=============================================================================
+// Return torpedo body i state
+//=============================================================================
+TorpedoStc World::getTorpedoNetData(int i) const
+{
+    TorpedoStc data;
+    data.X = x[i];
+    data.Y = y[i];
+    data.velocity = getVelocity(i);
+    data.active = (flags[i] & ACTIVE) != 0;
+    data.id = torpedoId[i - ships];
+    data.owner = (UCHAR)owner[i - ships];
+    return data;
+}
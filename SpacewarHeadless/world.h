@@ -0,0 +1,180 @@
+#ifndef _WORLD_H                // Prevent multiple definitions if this
+#define _WORLD_H                // file is included in more than one place
+
+#include <vector>
+#include "constants.h"
+#include "vector2.h"
+#include "ship.h"
+#include "torpedo.h"
+#include "gravityBatch.h"
+
+// Simulation state of every ship and torpedo in one match
+// Ship and Torpedo carry sprite data, textures, animations and network
+// fields the server never reads during a tick. World keeps only what the
+// simulation needs, one array per field, so a tick walks a few contiguous
+// arrays and the gravity and collision kernels read them directly.
+// Bodies 0 to ships-1 are ships, followed by a pool of torpedo slots
+// allocated once by initialize(). Free slots are kept on a free list and the
+// live ones in a dense list, so firing and removing a torpedo are O(1) and a
+// tick never allocates.
+// The rules are the same as Ship::update, Torpedo::update, Entity::bounce
+// and Ship::damage; the shield and explosion times follow the frame timing
+// of the Image animations they replace.
+
+namespace worldNS
+{
+    // body flags
+    const UCHAR ACTIVE      = 0x01;     // collides and is pulled by gravity
+    const UCHAR VISIBLE     = 0x02;
+    const UCHAR ENGINE      = 0x04;     // ship engine on
+    const UCHAR SHIELD      = 0x08;     // ship shield on
+    const UCHAR EXPLOSION   = 0x10;     // ship exploding
+    const float SHIP_RADIUS = shipNS::WIDTH/2.0f;               // collision radius
+    const float TORPEDO_RADIUS = (float)torpedoNS::COLLISION_RADIUS;
+    const int   SHIELD_FRAMES = shipNS::SHIELD_END_FRAME - shipNS::SHIELD_START_FRAME;
+    const int   EXPLOSION_FRAMES = shipNS::EXPLOSION_END_FRAME - shipNS::EXPLOSION_START_FRAME;
+    const int   MAX_BURST = 8;          // most torpedos one ship fires at once
+    const float BURST_SPREAD = 0.1f;    // radians between torpedos of a burst
+}
+
+class World
+{
+private:
+    int ships;                      // number of ships
+    int slots;                      // size of the torpedo pool
+
+    // every body
+    std::vector<float> x, y;        // top left corner, as SpriteData
+    std::vector<float> vx, vy;      // velocity
+    std::vector<float> mx, my;      // distance moved by the last update()
+    std::vector<float> mass;
+    std::vector<UCHAR> flags;       // worldNS flags
+    // scratch for the gravity kernel, ships followed by live torpedos
+    std::vector<float> cx, cy;      // centers
+    std::vector<float> gvx, gvy;    // velocities
+    std::vector<float> gm;          // gravity * mass, 0 when inactive
+    std::vector<float> pullMass;    // mass, 0 when inactive
+
+    // ships, index 0 to ships-1
+    std::vector<float> dvx, dvy;    // added to velocity at the next tick by bounce()
+    std::vector<float> angle;       // radians
+    std::vector<float> rotation;    // rotation rate (radians/second)
+    std::vector<float> health;
+    std::vector<float> oldX, oldY, oldAngle;    // position before the last move
+    std::vector<signed char> direction;         // shipNS::DIRECTION
+    std::vector<float> shieldTimer, explosionTimer;
+    std::vector<int>   shieldFrame, explosionFrame;
+    std::vector<float> fireTimer;   // time remaining until fire enabled
+
+    // torpedo pool, index 0 to slots-1 is body ships+slot
+    std::vector<int>   owner;       // ship that fired the torpedo
+    std::vector<float> life;        // time remaining until the torpedo is removed
+    std::vector<USHORT> torpedoId;  // serial number, TorpedoStc::id
+    USHORT nextTorpedoId;           // given to the next torpedo fired
+    std::vector<int>   freeSlots;   // free list, used as a stack
+    std::vector<int>   live;        // live slots, in no particular order
+    std::vector<int>   livePos;     // slot -> position in live
+
+    // Move body i by its velocity and wrap around the screen edge
+    void move(int i, float frameTime);
+
+    // Advance an animation timer as Image::update does.
+    // Returns true when the last frame has passed.
+    static bool animate(float &timer, int &frame, int frames, float delay, float frameTime);
+
+public:
+    // Constructor
+    World();
+
+    // Create ships ships, all inactive and invisible, and a pool of
+    // MAX_BURST torpedos per ship
+    void initialize(int ships);
+
+    // Number of ships
+    int  getShipCount() const       {return ships;}
+
+    // Number of body indexes, ships plus torpedo slots
+    int  getBodyCount() const       {return ships + slots;}
+
+    // Return true if body i is a ship
+    bool isShip(int i) const        {return i < ships;}
+
+    // Number of torpedos in flight
+    int  getTorpedoCount() const    {return (int)live.size();}
+
+    // Body index of torpedo n in flight, n = 0 to getTorpedoCount()-1
+    int  getTorpedo(int n) const    {return ships + live[n];}
+
+    // Ship that fired torpedo body i
+    int  getOwner(int i) const      {return owner[i - ships];}
+
+    // Move ships and torpedos one tick, as Ship::update and Torpedo::update
+    void update(float frameTime);
+
+    // Add the pull of the batch's planets, and of other bodies if the batch
+    // is mutual, to every active body
+    void applyGravity(GravityBatch &batch, float frameTime);
+
+    // Circle collision test between bodies a and b, as Entity::collideCircle
+    // Post: collisionVector = center b - center a if they collide
+    bool collides(int a, int b, VECTOR2 &collisionVector) const;
+
+    // Swept circle test of bodies a and b over the last update(), so fast
+    // torpedos cannot pass through a ship between ticks.
+    // Post: toi = fraction of the last move at first contact, 0 to 1
+    bool sweep(int a, int b, float &toi) const;
+
+    // Swept circle test of body a against a fixed circle, such as the planet
+    bool sweep(int a, float cx, float cy, float radius, float &toi) const;
+
+    // Ship functions, p = ship index
+    void setEngineOn(int p, bool on);
+    void rotate(int p, shipNS::DIRECTION dir)   {direction[p] = (signed char)dir;}
+
+    // Fire a burst of count torpedos spread around the ship's heading if
+    // the ship is ready. Returns the number fired, 0 if not ready.
+    int  fire(int p, int count = 1);
+    void damage(int p, WEAPON weapon);
+    void explode(int p);
+    void repair(int p);
+    void toOldPosition(int p);
+    void bounce(int p, const VECTOR2 &collisionVector, int other);
+
+    // Torpedo body i crashed or hit a ship, returns its slot to the pool
+    void removeTorpedo(int i);
+
+    // Remove every torpedo in flight
+    void clearTorpedos();
+
+    // Return ship p state in ShipStc.
+    // The caller sets score, playerN and the connected flag.
+    ShipStc getShipNetData(int p) const;
+
+    // Return state of torpedo body i
+    TorpedoStc getTorpedoNetData(int i) const;
+
+    // get functions, i = body index
+    float getX(int i) const         {return x[i];}
+    float getY(int i) const         {return y[i];}
+    float getCenterX(int i) const;
+    float getCenterY(int i) const;
+    float getRadius(int i) const    {return isShip(i) ? worldNS::SHIP_RADIUS : worldNS::TORPEDO_RADIUS;}
+    VECTOR2 getVelocity(int i) const {return VECTOR2(vx[i], vy[i]);}
+    bool  getActive(int i) const    {return (flags[i] & worldNS::ACTIVE) != 0;}
+    bool  getVisible(int i) const   {return (flags[i] & worldNS::VISIBLE) != 0;}
+    float getHealth(int p) const    {return health[p];}
+    float getRadians(int p) const   {return angle[p];}
+    bool  getExplosionOn(int p) const {return (flags[p] & worldNS::EXPLOSION) != 0;}
+    float getLife(int i) const      {return life[i - ships];}   // torpedo time remaining
+    VECTOR2 getMove(int i) const    {return VECTOR2(mx[i], my[i]);} // last update() move
+
+    // set functions, i = body index
+    void  setX(int i, float newX)   {x[i] = newX;}
+    void  setY(int i, float newY)   {y[i] = newY;}
+    void  setVelocity(int i, const VECTOR2 &v)  {vx[i] = v.x; vy[i] = v.y;}
+    void  setActive(int i, bool a);
+    void  setVisible(int i, bool v);
+    void  setRadians(int p, float a) {angle[p] = a;}
+};
+
+#endif
@@ -37,6 +37,8 @@ const float FRAME_RATE = 200.0f;            // the target frame rate (frames/sec
 const float MIN_FRAME_RATE = 10.0f;             // the minimum frame rate
 const float MIN_FRAME_TIME = 1.0f/FRAME_RATE;   // minimum desired time for 1 frame
 const float MAX_FRAME_TIME = 1.0f/MIN_FRAME_RATE; // maximum time used in calculations
+const float SIM_RATE = 120.0f;              // fixed simulation ticks/sec, 0 uses variable frameTime
+const int   MAX_SIM_STEPS = 5;              // most ticks run in one frame when catching up
 const float FULL_HEALTH = 100;
 
 // graphic images
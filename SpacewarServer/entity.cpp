@@ -18,6 +18,8 @@ Entity::Entity() : Image()
     deltaV.y = 0.0;
     active = true;                  // the entity is active
     rotatedBoxReady = false;
+    edgesReady = false;
+    edgeAngle = 0;
     collisionType = entityNS::CIRCLE;
     health = 100;
     gravity = entityNS::GRAVITY;
@@ -187,44 +189,31 @@ bool Entity::collideRotatedBox(Entity &ent, VECTOR2 &collisionVector)
 //=============================================================================
 // Projects other box onto this edge01 and edge03.
 // Called by collideRotatedBox()
+// The other box projects to its center projection plus or minus the sum of
+// its half edges projected onto the axis, so no corners are visited.
 // Post: returns true if projections overlap, false otherwise
 //=============================================================================
 bool Entity::projectionsOverlap(Entity &ent)
 {
-    float projection, min01, max01, min03, max03;
+    float projection, extent;
+
+    // center and half size of other box
+    VECTOR2 boxCenter = (*ent.getCorner(0) + *ent.getCorner(2)) * 0.5f;
+    float halfWidth = (ent.getEdge().right - ent.getEdge().left) * ent.getScale() * 0.5f;
+    float halfHeight = (ent.getEdge().bottom - ent.getEdge().top) * ent.getScale() * 0.5f;
 
     // project other box onto edge01
-    projection = graphics->Vector2Dot(&edge01, ent.getCorner(0)); // project corner 0
-    min01 = projection;
-    max01 = projection;
-    // for each remaining corner
-    for(int c=1; c<4; c++)
-    {
-        // project corner onto edge01
-        projection = graphics->Vector2Dot(&edge01, ent.getCorner(c));
-        if (projection < min01)
-            min01 = projection;
-        else if (projection > max01)
-            max01 = projection;
-    }
-    if (min01 > edge01Max || max01 < edge01Min) // if projections do not overlap
+    projection = vector2Dot(edge01, boxCenter);
+    extent = halfWidth * fabs(vector2Dot(edge01, ent.edge01)) +
+             halfHeight * fabs(vector2Dot(edge01, ent.edge03));
+    if (projection - extent > edge01Max || projection + extent < edge01Min)
         return false;                       // no collision is possible
 
     // project other box onto edge03
-    projection = graphics->Vector2Dot(&edge03, ent.getCorner(0)); // project corner 0
-    min03 = projection;
-    max03 = projection;
-    // for each remaining corner
-    for(int c=1; c<4; c++)
-    {
-        // project corner onto edge03
-        projection = graphics->Vector2Dot(&edge03, ent.getCorner(c));
-        if (projection < min03)
-            min03 = projection;
-        else if (projection > max03)
-            max03 = projection;
-    }
-    if (min03 > edge03Max || max03 < edge03Min) // if projections do not overlap
+    projection = vector2Dot(edge03, boxCenter);
+    extent = halfWidth * fabs(vector2Dot(edge03, ent.edge01)) +
+             halfHeight * fabs(vector2Dot(edge03, ent.edge03));
+    if (projection - extent > edge03Max || projection + extent < edge03Min)
         return false;                       // no collision is possible
 
     return true;                            // projections overlap
@@ -256,14 +245,14 @@ bool Entity::collideRotatedBoxCircle(Entity &ent, VECTOR2 &collisionVector)
     computeRotatedBox();                    // prepare rotated box
 
     // project circle center onto edge01
-    center01 = graphics->Vector2Dot(&edge01, ent.getCenter());
+    center01 = vector2Dot(edge01, *ent.getCenter());
     min01 = center01 - ent.getRadius()*ent.getScale(); // min and max are Radius from center
     max01 = center01 + ent.getRadius()*ent.getScale();
     if (min01 > edge01Max || max01 < edge01Min) // if projections do not overlap
         return false;                       // no collision is possible
         
     // project circle center onto edge03
-    center03 = graphics->Vector2Dot(&edge03, ent.getCenter());
+    center03 = vector2Dot(edge03, *ent.getCenter());
     min03 = center03 - ent.getRadius()*ent.getScale(); // min and max are Radius from center
     max03 = center03 + ent.getRadius()*ent.getScale();
     if (min03 > edge03Max || max03 < edge03Min) // if projections do not overlap
@@ -317,52 +306,42 @@ bool Entity::collideCornerCircle(VECTOR2 corner, Entity &ent, VECTOR2 &collision
 // 0---1  corner numbers
 // |   |
 // 3---2
+// The edges are the unit x and y axes rotated by the sprite angle. They are
+// only recomputed when the angle changes, the corners whenever the entity
+// has moved.
 //=============================================================================
 void Entity::computeRotatedBox()
 {
     if(rotatedBoxReady)
         return;
-    float projection;
 
-    VECTOR2 rotatedX(cos(spriteData.angle), sin(spriteData.angle));
-    VECTOR2 rotatedY(-sin(spriteData.angle), cos(spriteData.angle));
+    if(!edgesReady || edgeAngle != spriteData.angle)
+    {
+        float cosA = (float)cos(spriteData.angle);
+        float sinA = (float)sin(spriteData.angle);
+        edge01 = VECTOR2(cosA, sinA);       // corner 0 to corner 1
+        edge03 = VECTOR2(-sinA, cosA);      // corner 0 to corner 3
+        edgeAngle = spriteData.angle;
+        edgesReady = true;
+    }
 
+    float left = (float)edge.left*getScale();
+    float right = (float)edge.right*getScale();
+    float top = (float)edge.top*getScale();
+    float bottom = (float)edge.bottom*getScale();
     const VECTOR2 *center = getCenter();
-    corners[0] = *center + rotatedX * ((float)edge.left*getScale())  +
-                           rotatedY * ((float)edge.top*getScale());
-    corners[1] = *center + rotatedX * ((float)edge.right*getScale()) + 
-                           rotatedY * ((float)edge.top*getScale());
-    corners[2] = *center + rotatedX * ((float)edge.right*getScale()) + 
-                           rotatedY * ((float)edge.bottom*getScale());
-    corners[3] = *center + rotatedX * ((float)edge.left*getScale())  +
-                           rotatedY * ((float)edge.bottom*getScale());
-
-    // corners[0] is used as origin
-    // The two edges connected to corners[0] are used as the projection lines
-    edge01 = VECTOR2(corners[1].x - corners[0].x, corners[1].y - corners[0].y);
-    graphics->Vector2Normalize(&edge01);
-    edge03 = VECTOR2(corners[3].x - corners[0].x, corners[3].y - corners[0].y);
-    graphics->Vector2Normalize(&edge03);
+    corners[0] = *center + edge01*left  + edge03*top;
+    corners[1] = *center + edge01*right + edge03*top;
+    corners[2] = *center + edge01*right + edge03*bottom;
+    corners[3] = *center + edge01*left  + edge03*bottom;
 
     // this entities min and max projection onto edges
-    projection = graphics->Vector2Dot(&edge01, &corners[0]);
-    edge01Min = projection;
-    edge01Max = projection;
-    // project onto edge01
-    projection = graphics->Vector2Dot(&edge01, &corners[1]);
-    if (projection < edge01Min)
-        edge01Min = projection;
-    else if (projection > edge01Max)
-        edge01Max = projection;
-    // project onto edge03
-    projection = graphics->Vector2Dot(&edge03, &corners[0]);
-    edge03Min = projection;
-    edge03Max = projection;
-    projection = graphics->Vector2Dot(&edge03, &corners[3]);
-    if (projection < edge03Min)
-        edge03Min = projection;
-    else if (projection > edge03Max)
-        edge03Max = projection;
+    float center01 = vector2Dot(edge01, *center);
+    float center03 = vector2Dot(edge03, *center);
+    edge01Min = center01 + left;
+    edge01Max = center01 + right;
+    edge03Min = center03 + top;
+    edge03Max = center03 + bottom;
 
     rotatedBoxReady = true;
 }
@@ -396,8 +375,8 @@ void Entity::bounce(VECTOR2 &collisionVector, Entity &ent)
 {
     VECTOR2 Vdiff = ent.getVelocity() - velocity;
     VECTOR2 cUV = collisionVector;              // collision unit vector
-    Graphics::Vector2Normalize(&cUV);
-    float cUVdotVdiff = Graphics::Vector2Dot(&cUV, &Vdiff);
+    vector2Normalize(cUV);
+    float cUVdotVdiff = vector2Dot(cUV, Vdiff);
     float massRatio = 2.0f;
     if (getMass() != 0)
         massRatio *= (ent.getMass() / (getMass() + ent.getMass()));
@@ -436,7 +415,7 @@ void Entity::gravityForce(Entity *ent, float frameTime)
     VECTOR2 gravityV(ent->getCenterX() - getCenterX(),
                         ent->getCenterY() - getCenterY());
     // Normalize the vector
-    Graphics::Vector2Normalize(&gravityV);
+    vector2Normalize(gravityV);
     // Multipy by force of gravity to create gravity vector
     gravityV *= force * frameTime;
     // Add gravity vector to moving velocity vector to change direction
@@ -17,6 +17,10 @@ Game::Game()
     messageDialog = NULL;
     inputDialog = NULL;
     fps = 100;
+    simAccumulator = 0;
+    simSteps = 0;
+    simTicks = 0;
+    setSimRate(SIM_RATE);
     fpsOn = false;              // default to fps display off
     initialized = false;
 }
@@ -141,12 +145,10 @@ void Game::initialize(HWND hw)
         }
     }
 
-    // attempt to set up high resolution timer
-    if(QueryPerformanceFrequency(&timerFreq) == false)
+    // attempt to set up high resolution frame scheduler
+    if(scheduler.initialize(FRAME_RATE) == false)
         throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing high resolution timer"));
 
-    QueryPerformanceCounter(&timeStart);        // get starting time
-
     initialized = true;
 }
 
@@ -233,34 +235,50 @@ void Game::run(HWND hwnd)
     if(graphics == NULL)            // if graphics not initialized
         return;
 
-    // calculate elapsed time of last frame, save in frameTime
-    QueryPerformanceCounter(&timeEnd);
-    frameTime = (float)(timeEnd.QuadPart - timeStart.QuadPart ) / (float)timerFreq.QuadPart;
+    // Power saving code, sleep until the next frame deadline
+    scheduler.waitForTick();
 
-    // Power saving code, requires winmm.lib
-    // if not enough time has elapsed for desired frame rate
-    if (frameTime < MIN_FRAME_TIME) 
-    {
-        sleepTime = (DWORD)((MIN_FRAME_TIME - frameTime)*1000);
-        timeBeginPeriod(1);         // Request 1mS resolution for windows timer
-        Sleep(sleepTime);           // release cpu for sleepTime
-        timeEndPeriod(1);           // End 1mS timer resolution
-        return;
-    }
+    // elapsed time of last frame, measured between deadlines
+    frameTime = (float)scheduler.getFrameTime();
 
     if (frameTime > 0.0)
         fps = (fps*0.99f) + (0.01f/frameTime);  // average fps
     if (frameTime > MAX_FRAME_TIME) // if frame rate is very slow
         frameTime = MAX_FRAME_TIME; // limit maximum frameTime
-    timeStart = timeEnd;
 
     // update(), ai(), and collisions() are pure virtual functions.
     // These functions must be provided in the class that inherits from Game.
     if (!paused)                    // if not paused
     {
-        update();                   // update all game items
-        ai();                       // artificial intelligence
-        collisions();               // handle collisions
+        if (simTime > 0)            // if fixed simulation tick
+        {
+            // Simulate the elapsed time in fixed steps so the results do not
+            // depend on frame rate. Leftover time carries into the next frame.
+            float elapsed = frameTime;
+            simAccumulator += elapsed;
+            frameTime = simTime;    // update() uses frameTime
+            simSteps = 0;
+            while (simAccumulator >= simTime && simSteps < MAX_SIM_STEPS)
+            {
+                update();           // update all game items
+                ai();               // artificial intelligence
+                collisions();       // handle collisions
+                simAccumulator -= simTime;
+                simSteps++;
+                simTicks++;
+            }
+            // if too far behind drop the backlog instead of trying to catch up
+            if (simAccumulator >= simTime)
+                simAccumulator = fmod(simAccumulator, simTime);
+            frameTime = elapsed;    // render and network use real time
+        }
+        else
+        {
+            update();               // update all game items
+            ai();                   // artificial intelligence
+            collisions();           // handle collisions
+            simTicks++;
+        }
         input->vibrateControllers(frameTime); // handle controller vibration
     }
     renderGame();                   // draw all game items
@@ -295,6 +313,18 @@ void Game::run(HWND hwnd)
     input->clear(inputNS::KEYS_PRESSED);
 }
 
+//=============================================================================
+// Set fixed simulation rate in ticks per second, 0 for variable frameTime
+//=============================================================================
+void Game::setSimRate(float rate)
+{
+    if (rate > 0)
+        simTime = 1.0f/rate;
+    else
+        simTime = 0;
+    simAccumulator = 0;
+}
+
 //=============================================================================
 // Process console commands
 // Override this function in the derived class if new console commands are added.
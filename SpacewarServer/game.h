@@ -15,6 +15,7 @@
 #include "messageDialog.h"
 #include "inputDialog.h"
 #include "net.h"
+#include "tickScheduler.h"
 
 
 namespace gameNS
@@ -36,14 +37,15 @@ protected:
     InputDialog *inputDialog;       // pointer to InputDialog
     HWND    hwnd;                   // window handle
     HRESULT hr;                     // standard return type
-    LARGE_INTEGER timeStart;        // Performance Counter start value
-    LARGE_INTEGER timeEnd;          // Performance Counter end value
-    LARGE_INTEGER timerFreq;        // Performance Counter frequency
+    TickScheduler scheduler;        // wakes the game loop at each frame deadline
     float   frameTime;              // time required for last frame
+    float   simTime;                // fixed simulation time step, 0 for variable frameTime
+    float   simAccumulator;         // elapsed time not yet simulated
+    int     simSteps;               // simulation ticks run during the last frame
+    UINT    simTicks;               // simulation ticks since start
     float   fps;                    // frames per second
     TextDX  dxFont;                 // DirectX font for fps
     bool    fpsOn;                  // true to display fps
-    DWORD   sleepTime;              // number of milli-seconds to sleep between frames
     bool    paused;                 // true if game is paused
     bool    initialized;
     std::string  command;           // command from console
@@ -82,6 +84,21 @@ public:
     // Do network communications.
     virtual void communicate(float frameTime) {}
 
+    // Set fixed simulation rate in ticks per second.
+    // update(), ai() and collisions() are then called with frameTime equal to
+    // 1/rate, as many times as needed to keep up with real time (up to
+    // MAX_SIM_STEPS per frame). A rate of 0 uses the variable frameTime.
+    void setSimRate(float rate);
+
+    // Return fixed simulation rate in ticks per second, 0 if variable.
+    float getSimRate()      {return (simTime > 0) ? 1.0f/simTime : 0.0f;}
+
+    // Return number of simulation ticks since start
+    UINT getSimTicks()      {return simTicks;}
+
+    // Return the frame scheduler
+    TickScheduler& getScheduler()   {return scheduler;}
+
     // Render game items.
     virtual void renderGame();
 
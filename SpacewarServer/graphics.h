@@ -10,13 +10,13 @@
 #include <d3dx9.h>
 #include "constants.h"
 #include "gameError.h"
+#include "vector2.h"
 
 // DirectX pointer types
 #define LP_TEXTURE  LPDIRECT3DTEXTURE9
 #define LP_SPRITE   LPD3DXSPRITE
 #define LP_3DDEVICE LPDIRECT3DDEVICE9
 #define LP_3D       LPDIRECT3D9
-#define VECTOR2     D3DXVECTOR2
 #define LP_VERTEXBUFFER LPDIRECT3DVERTEXBUFFER9
 #define LP_DXFONT   LPD3DXFONT
 #define LP_VERTEXBUFFER LPDIRECT3DVERTEXBUFFER9
@@ -181,17 +181,22 @@ public:
     // Post: All user surfaces are recreated.
     void    changeDisplayMode(graphicsNS::DISPLAY_MODE mode = graphicsNS::TOGGLE);
 
+    // Vector functions kept for older code, the simulation uses vector2.h
     // Return length of vector v.
-    static float    Vector2Length(const VECTOR2 *v) {return D3DXVec2Length(v);}
+    static float    Vector2Length(const VECTOR2 *v) {return vector2Length(*v);}
 
     // Return Dot product of vectors v1 and v2.
-    static float    Vector2Dot(const VECTOR2 *v1, const VECTOR2 *v2) {return D3DXVec2Dot(v1, v2);}
+    static float    Vector2Dot(const VECTOR2 *v1, const VECTOR2 *v2) {return vector2Dot(*v1, *v2);}
 
     // Normalize vector v.
-    static void     Vector2Normalize(VECTOR2 *v) {D3DXVec2Normalize(v, v);}
+    static void     Vector2Normalize(VECTOR2 *v) {vector2Normalize(*v);}
 
-    // Transform vector v with matrix m.
-    static VECTOR2* Vector2Transform(VECTOR2 *v, D3DXMATRIX *m) {return D3DXVec2TransformCoord(v,v,m);}
+    // Transform vector v with matrix m. VECTOR2 has the layout of D3DXVECTOR2.
+    static VECTOR2* Vector2Transform(VECTOR2 *v, D3DXMATRIX *m)
+    {
+        D3DXVec2TransformCoord((D3DXVECTOR2*)v, (D3DXVECTOR2*)v, m);
+        return v;
+    }
 
     // get functions
     // Return direct3d.
@@ -118,6 +118,10 @@ void Ship::update(float frameTime)
     }
 
     Entity::update(frameTime);
+    // no faster than a snapshot can carry
+    float speed = (float)sqrt(velocity.x*velocity.x + velocity.y*velocity.y);
+    if (speed > shipNS::MAX_SPEED)
+        velocity *= shipNS::MAX_SPEED / speed;
     oldX = spriteData.x;                        // save current position
     oldY = spriteData.y;
     oldAngle = spriteData.angle;
@@ -215,11 +219,7 @@ void Ship::repair()
 //      float rotation;         // rotation rate (radians/second)
 //      short score;
 //      UCHAR playerN;          // which player (255 is request to join)
-//      -----flags-----
-//          bit0 active         // true when player is active
-//          bit1 engineOn
-//          bit2 shieldOn
-//      UCHAR flags;            // boolean status flags
+//      UCHAR flags;            // SHIP_ACTIVE_BIT to SHIP_CONNECTED_BIT
 //=============================================================================
 void Ship::setNetData(ShipStc ss)
 {
@@ -229,11 +229,12 @@ void Ship::setNetData(ShipStc ss)
     setHealth(ss.health);
     setVelocity(ss.velocity);
     setRotation(ss.rotation);
-    setActive((ss.flags & 0x01) == 0x01);
+    setActive((ss.flags & spacewarNS::SHIP_ACTIVE_BIT) != 0);
     if(active)
         visible = true;
-    setEngineOn((ss.flags & 0x02) == 0x02);
-    setShieldOn((ss.flags & 0x04) == 0x04);
+    setEngineOn((ss.flags & spacewarNS::SHIP_ENGINE_BIT) != 0);
+    setShieldOn((ss.flags & spacewarNS::SHIP_SHIELD_BIT) != 0);
+    setConnected((ss.flags & spacewarNS::SHIP_CONNECTED_BIT) != 0);
     if(health <= 0 && explosionOn == false && visible) // if ship destroyed
         explode();
 }
@@ -252,16 +253,14 @@ ShipStc Ship::getNetData()
     data.rotation = getRotation();
     data.score = getScore();
     data.playerN = getPlayerN();
-    //-----flags-----
-    // bit0 active
-    // bit1 engineOn
-    // bit2 shieldOn
     data.flags = 0;
     if(getActive())
-        data.flags |= 0x01;
+        data.flags |= spacewarNS::SHIP_ACTIVE_BIT;
     if(getEngineOn())
-        data.flags |= 0x02;
+        data.flags |= spacewarNS::SHIP_ENGINE_BIT;
     if(getShieldOn())
-        data.flags |= 0x04;
+        data.flags |= spacewarNS::SHIP_SHIELD_BIT;
+    if(getConnected())
+        data.flags |= spacewarNS::SHIP_CONNECTED_BIT;
     return data;
 }
@@ -1,6 +1,7 @@
 // This class is the core of the game
 
 #include "spaceWar.h"
+#include "bitStream.h"
 using namespace spacewarNS;
 
 //=============================================================================
@@ -16,7 +17,21 @@ Spacewar::Spacewar()
     startTimerRun = false;
     startTimer = 0;
     playerCount = 0;
+    playerLimit = DEFAULT_PLAYERS;
+    snapshotClock = 0;
+    nextTorpedoId = 0;
+    for (int i=0; i<MAX_PLAYERS; i++)
+    {
+        sessionToken[i] = 0;            // assigned when a player joins
+        snapshotAck[i] = 0;
+        inputApplied[i] = 0;
+        inputShown[i] = 0;
+        torpedoId[i] = 0;
+        torpedoLag[i] = 0;
+        playoutDelay[i] = rewindNS::VIEW_DELAY;
+    }
     menuTimer = 0;
+    gravityOn = true;
 }
 
 //=============================================================================
@@ -39,6 +54,7 @@ void Spacewar::initialize(HWND hwnd)
     fontBig.initialize(graphics, spacewarNS::FONT_BIG_SIZE, false, false, spacewarNS::FONT);
     fontBig.setFontColor(spacewarNS::FONT_COLOR);
     fontScore.initialize(graphics, spacewarNS::FONT_SCORE_SIZE, false, false, spacewarNS::FONT);
+    fontLabel.initialize(graphics, spacewarNS::FONT_LABEL_SIZE, false, false, spacewarNS::FONT);
 
     // menu texture
     if (!menuTexture.initialize(graphics,MENU_IMAGE))
@@ -64,45 +80,42 @@ void Spacewar::initialize(HWND hwnd)
     if (!planet.initialize(this, planetNS::WIDTH, planetNS::HEIGHT, 2, &gameTextures))
         throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing planet"));
 
-    // ship1
-    if (!ship[0].initialize(this, shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing ship1"));
-
-    ship[0].setFrames(shipNS::SHIP1_START_FRAME, shipNS::SHIP1_END_FRAME);
-    ship[0].setCurrentFrame(shipNS::SHIP1_START_FRAME);
-    ship[0].setColorFilter(SETCOLOR_ARGB(255,230,230,255));   // light blue, used for shield and torpedo
-    ship[0].setMass(shipNS::MASS);
-
-    // ship2
-    if (!ship[1].initialize(this, shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing ship2"));
-
-    ship[1].setFrames(shipNS::SHIP2_START_FRAME, shipNS::SHIP2_END_FRAME);
-    ship[1].setCurrentFrame(shipNS::SHIP2_START_FRAME);
-    ship[1].setColorFilter(SETCOLOR_ARGB(255,255,255,64));    // light yellow, used for shield
-    ship[1].setMass(shipNS::MASS);
-
-    // torpedo1
-    if (!torpedo[0].initialize(this, torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing torpedo1"));
-
-    torpedo[0].setFrames(torpedoNS::START_FRAME, torpedoNS::END_FRAME);
-    torpedo[0].setCurrentFrame(torpedoNS::START_FRAME);
-    torpedo[0].setColorFilter(SETCOLOR_ARGB(255,128,128,255));   // light blue
-
-    // torpedo2
-    if (!torpedo[1].initialize(this, torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS, &gameTextures))
-        throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing torpedo2"));
-
-    torpedo[1].setFrames(torpedoNS::START_FRAME, torpedoNS::END_FRAME);
-    torpedo[1].setCurrentFrame(torpedoNS::START_FRAME);
-    torpedo[1].setColorFilter(SETCOLOR_ARGB(255,255,255,64));     // light yellow
+    // ships and torpedos, even players use the ship1 image and colors,
+    // odd players use ship2
+    for (int i=0; i<MAX_PLAYERS; i++)
+    {
+        if (!ship[i].initialize(this, shipNS::WIDTH, shipNS::HEIGHT, shipNS::TEXTURE_COLS, &gameTextures))
+            throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing ship"));
+        ship[i].setMass(shipNS::MASS);
+        if (!torpedo[i].initialize(this, torpedoNS::WIDTH, torpedoNS::HEIGHT, torpedoNS::TEXTURE_COLS, &gameTextures))
+            throw(GameError(gameErrorNS::FATAL_ERROR, "Error initializing torpedo"));
+        torpedo[i].setFrames(torpedoNS::START_FRAME, torpedoNS::END_FRAME);
+        torpedo[i].setCurrentFrame(torpedoNS::START_FRAME);
+        if (i % 2 == 0)
+        {
+            ship[i].setFrames(shipNS::SHIP1_START_FRAME, shipNS::SHIP1_END_FRAME);
+            ship[i].setCurrentFrame(shipNS::SHIP1_START_FRAME);
+            ship[i].setColorFilter(SETCOLOR_ARGB(255,230,230,255));   // light blue, used for shield and torpedo
+            torpedo[i].setColorFilter(SETCOLOR_ARGB(255,128,128,255));   // light blue
+        }
+        else
+        {
+            ship[i].setFrames(shipNS::SHIP2_START_FRAME, shipNS::SHIP2_END_FRAME);
+            ship[i].setCurrentFrame(shipNS::SHIP2_START_FRAME);
+            ship[i].setColorFilter(SETCOLOR_ARGB(255,255,255,64));    // light yellow, used for shield
+            torpedo[i].setColorFilter(SETCOLOR_ARGB(255,255,255,64));     // light yellow
+        }
+    }
 
     // health bar
     healthBar.initialize(graphics, &gameTextures, 0, spacewarNS::HEALTHBAR_Y, 2.0f, graphicsNS::WHITE);
 
     toClientData.gameState = 0;
     toClientData.sounds = 0;
+    broadphase.initialize((float)GAME_WIDTH, (float)GAME_HEIGHT);
+    proxyEntity.reserve(MAX_PLAYERS * 2);
+    // every position, so a players # change does not need a new ring
+    rewind.initialize(MAX_PLAYERS, (float)GAME_WIDTH, (float)GAME_HEIGHT);
     initializeServer(port);     // initialize game server
 
     roundOver = true;
@@ -111,21 +124,52 @@ void Spacewar::initialize(HWND hwnd)
 
 //=============================================================================
 // Start a new round of play
+// Connected players start spread around the planet in stable clockwise
+// orbits, filling the ORBIT_RADIUS rings in order. Open positions sit out.
 //=============================================================================
 void Spacewar::roundStart()
 {
-    // Start ships on opposite sides of planet in stable clockwise orbit
-    ship[0].setX(GAME_WIDTH/4 - shipNS::WIDTH);
-    ship[1].setX(GAME_WIDTH - GAME_WIDTH/4);
-    ship[0].setY(GAME_HEIGHT/2 - shipNS::HEIGHT);
-    ship[1].setY(GAME_HEIGHT/2);
-    ship[0].setVelocity(VECTOR2(0,-shipNS::SPEED));
-    ship[1].setVelocity(VECTOR2(0,shipNS::SPEED));
-
-    ship[0].setDegrees(0);
-    ship[1].setDegrees(180);
-    ship[0].repair();
-    ship[1].repair();
+    int players = getPlayerCount();
+    int placed = 0;             // players already placed
+    int ring = 0;               // orbit being filled
+    int ringStart = 0;          // first player on this orbit
+    int ringCount;              // players on this orbit
+
+    ringCount = (int)(2*PI*ORBIT_RADIUS[0] / ORBIT_SPACING);
+    if (ringCount > players)
+        ringCount = players;
+
+    rewind.clear();             // the ships were somewhere else last round
+    for (int i=0; i<playerLimit; i++)
+    {
+        torpedo[i].setActive(false);
+        torpedo[i].setVisible(false);
+        if (!ship[i].getConnected())
+        {
+            ship[i].setActive(false);
+            ship[i].setVisible(false);
+            continue;
+        }
+        if (placed - ringStart >= ringCount && ring < ORBITS-1)  // orbit full
+        {
+            ring++;
+            ringStart = placed;
+            ringCount = (int)(2*PI*ORBIT_RADIUS[ring] / ORBIT_SPACING);
+            if (ringCount > players - placed)
+                ringCount = players - placed;
+        }
+        // first player on each orbit starts on the left side of the planet
+        float radius = ORBIT_RADIUS[ring];
+        float angle = (float)PI + 2*(float)PI*(placed - ringStart)/ringCount;
+        // speed of a circular orbit so ships on different rings never cross
+        float speed = sqrt(entityNS::GRAVITY * planetNS::MASS * shipNS::MASS / radius);
+        ship[i].setX(GAME_WIDTH/2 + radius*cos(angle) - shipNS::WIDTH/2);
+        ship[i].setY(GAME_HEIGHT/2 + radius*sin(angle) - shipNS::HEIGHT/2);
+        ship[i].setVelocity(VECTOR2(-speed*sin(angle), speed*cos(angle)));
+        ship[i].setRadians(angle - (float)PI);   // nose along the orbit
+        ship[i].repair();
+        placed++;
+    }
     countDownTimer = spacewarNS::COUNT_DOWN;
     countDownOn = true;
     roundOver = false;
@@ -140,6 +184,7 @@ void Spacewar::update()
 {
     int shipCount = 0;      // visible ships
     playerCount = 0;
+    snapshotClock += frameTime; // time of the state this tick makes
 
     if(menuOn)
     {
@@ -174,7 +219,10 @@ void Spacewar::update()
     } 
     else
     {
-        for (int i=0; i<MAX_PLAYERS; i++)       // for all players
+        toClientData.sounds &= (0xFF ^ ENGINE1_BIT);    // sound off
+        toClientData.sounds &= (0xFF ^ ENGINE2_BIT);    // sound off
+
+        for (int i=0; i<playerLimit; i++)       // for all players
         {
             if(ship[i].getConnected())
                 playerCount++;  // count connected players
@@ -182,17 +230,14 @@ void Spacewar::update()
             if(ship[i].getVisible())
                 shipCount++;        // count visible ships
 
-            toClientData.sounds &= (0xFF ^ ENGINE1_BIT);    // sound off
-            toClientData.sounds &= (0xFF ^ ENGINE2_BIT);    // sound off
-
             if (ship[i].getActive())
             {
                 if (ship[i].getButtons() & FORWARD_BIT) // if move forward button
                 {
                     ship[i].setEngineOn(true);
-                    if(i==0)        // if ship1
+                    if(i % 2 == 0)  // if ship1 image
                         toClientData.sounds |= ENGINE1_BIT; // sound on
-                    else            // if ship2
+                    else            // if ship2 image
                         toClientData.sounds |= ENGINE2_BIT; // sound on
                 }
                 else
@@ -209,15 +254,20 @@ void Spacewar::update()
                     torpedo[i].fire(&ship[i]);          // fire torpedo
                     if(torpedo[i].getFired())           // if it fired
                     {
+                        torpedoId[i] = nextTorpedoId++;
                         // change the state of the sound bit to play the sound
                         toClientData.sounds ^= TORPEDO_FIRE_BIT;
                         torpedo[i].setFired(false);     // do not play sound again
+                        compensate(i);
                     }
                 }
             }
-            ship[i].gravityForce(&planet, frameTime);
-            torpedo[i].gravityForce(&planet, frameTime);
+        }
 
+        applyGravity(frameTime);
+
+        for (int i=0; i<playerLimit; i++)
+        {
             // Update the entities
             ship[i].update(frameTime);
             torpedo[i].update(frameTime);
@@ -238,82 +288,259 @@ void Spacewar::ai()
 {}
 
 //=============================================================================
-// Handle collisions
+// Add ent to the broadphase if it can collide
+// id = playerN*2 for a ship, playerN*2+1 for a torpedo
 //=============================================================================
-void Spacewar::collisions()
+static void addToBroadphase(Broadphase &broadphase, std::vector<int> &proxyEntity,
+                            Entity &ent, int id)
 {
-    VECTOR2 collisionVector;
-    UCHAR sounds = toClientData.sounds; // get current sound states
+    if (!ent.getActive())
+        return;
+    // half the diagonal covers the entity at any rotation
+    float radius = (float)(ent.getWidth() > ent.getHeight() ? ent.getWidth() : ent.getHeight())
+                   * ent.getScale() * 0.7072f;
+    if (ent.getRadius() * ent.getScale() > radius)
+        radius = ent.getRadius() * ent.getScale();
+    broadphase.add(ent.getCenterX(), ent.getCenterY(), radius);
+    proxyEntity.push_back(id);
+}
 
-    for (int i=0; i<MAX_PLAYERS; i++)   // for all players
+//=============================================================================
+// Add the pull of the planet and gravity wells to every active ship and
+// torpedo, and of the ships and torpedos on each other if mutual gravity is on.
+// Same result as calling gravityForce for each of them, in one batch.
+//=============================================================================
+void Spacewar::applyGravity(float frameTime)
+{
+    if (!gravityOn)
+        return;
+    gravityBatch.clear();
+    gravityBatch.clearPlanets();
+    if (planet.getActive())
+        gravityBatch.addPlanet(planet.getCenterX(), planet.getCenterY(), planet.getMass());
+    for (size_t n=0; n<wells.size(); n++)
+        gravityBatch.addPlanet(wells[n].x, wells[n].y, wells[n].mass);
+    gravityEntity.clear();
+    for (int i=0; i<playerLimit; i++)
     {
-        // if collision between ship and planet
-        if(ship[i].collidesWith(planet, collisionVector))
+        Entity *ent[2] = {&ship[i], &torpedo[i]};
+        for (int n=0; n<2; n++)
         {
-            ship[i].toOldPosition();    // move ship out of collision
-            ship[i].damage(PLANET);
-            for (int j=0; j<MAX_PLAYERS; j++) // for all ships
-            {
-                if(i != j)              // for all other ships
-                    ship[j].scored();   // everyone else scores
-            }
+            if (!ent[n]->getActive())
+                continue;
+            VECTOR2 v = ent[n]->getVelocity();
+            gravityBatch.add(ent[n]->getCenterX(), ent[n]->getCenterY(), v.x, v.y,
+                             ent[n]->getGravity(), ent[n]->getMass());
+            gravityEntity.push_back(ent[n]);
         }
+    }
+    gravityBatch.step(frameTime);
+    for (size_t n=0; n<gravityEntity.size(); n++)
+        gravityEntity[n]->setVelocity(VECTOR2(gravityBatch.getVelocityX((int)n),
+                                              gravityBatch.getVelocityY((int)n)));
+}
 
-        for (int j=i+1; j<MAX_PLAYERS; j++) // for all other ships
-        {
-            // if collision between ships
-            if(ship[i].collidesWith(ship[j], collisionVector))
-            {
-                // bounce off other ship
-                ship[i].bounce(collisionVector, ship[j]);
-                ship[j].bounce(collisionVector*-1, ship[i]);
-                ship[i].damage(SHIP);
-                ship[j].damage(SHIP);
-                if(ship[i].getHealth() <= 0)
-                    ship[j].scored();
-                if(ship[j].getHealth() <= 0)
-                    ship[i].scored();
-                // change the state of the sound bit to play the sound
-                if(sounds & COLLIDE_BIT)    // if bit was 1
-                    toClientData.sounds &= (0xFF ^ COLLIDE_BIT); // set to 0
-                else                        // bit was 0
-                    toClientData.sounds |= COLLIDE_BIT;     // set to 1
-            }
-        }
+//=============================================================================
+// Add ent to the circle batch if it can collide
+// id = playerN*2 for a ship, playerN*2+1 for a torpedo
+//=============================================================================
+static void addToBatch(CircleBatch &circles, std::vector<int> &circleEntity,
+                       Entity &ent, int id)
+{
+    if (!ent.getActive())
+        return;
+    circles.add(ent.getCenterX(), ent.getCenterY(), ent.getRadius() * ent.getScale());
+    circleEntity.push_back(id);
+}
+
+//=============================================================================
+// Handle collisions
+// Ships and torpedos are tested against the planet as one batch.
+// The broadphase returns only the ships and torpedos that are close enough
+// to collide, so the cost grows with the number of nearby entities instead
+// of the square of the player count.
+// A torpedo fired by a lagging player is swept against the ships where
+// that player saw them instead, see compensate.
+//=============================================================================
+void Spacewar::collisions()
+{
+    UCHAR sounds = toClientData.sounds; // get current sound states
 
-        for (int j=0; j<MAX_PLAYERS; j++)   // for all torpedos
+    // keep where every ship is this tick, at the time it is sent as
+    RewindState *state = rewind.record(snapshotClock);
+    for (int i=0; i<MAX_PLAYERS; i++)   // open positions are inactive
+    {
+        state[i].x = ship[i].getCenterX();
+        state[i].y = ship[i].getCenterY();
+        state[i].radius = ship[i].getRadius() * ship[i].getScale();
+        state[i].active = ship[i].getActive();
+    }
+    // lagging torpedos are tested against the ships now until there is a
+    // tick to sweep them back over
+    bool rewound = rewind.canSweep();
+
+    // test every ship and torpedo against the planet at once
+    circles.clear();
+    circleEntity.clear();
+    for (int i=0; i<playerLimit; i++)
+    {
+        addToBatch(circles, circleEntity, ship[i], i*2);
+        addToBatch(circles, circleEntity, torpedo[i], i*2+1);
+    }
+    if (planet.getActive() && circles.getCount() > 0)
+    {
+        hitMask.resize(circles.getMaskWords());
+        hitVector.resize(circles.getCount());
+        circles.collide(planet.getCenterX(), planet.getCenterY(),
+                        planet.getRadius()*planet.getScale(), &hitMask[0], &hitVector[0]);
+        for (int n=0; n<circles.getCount(); n++)
         {
-            if(i != j)  // don't collide with our own torpedo
+            if (!(hitMask[n / circleBatchNS::MASK_BITS] & (1u << (n % circleBatchNS::MASK_BITS))))
+                continue;
+            int i = circleEntity[n] / 2;
+            if (circleEntity[n] % 2 == 0)   // ship hit planet
             {
-                // if collision between ship and torpedo
-                if(ship[i].collidesWith(torpedo[j], collisionVector))
+                ship[i].toOldPosition();    // move ship out of collision
+                ship[i].damage(PLANET);
+                for (int j=0; j<playerLimit; j++) // for all ships
                 {
-                    ship[i].damage(TORPEDO);
-                    torpedo[j].setVisible(false);
-                    torpedo[j].setActive(false);
-                    ship[j].scored();
-                    // change the state of the sound bit to play the sound
-                    if(sounds & TORPEDO_HIT_BIT)    // if bit was 1
-                        toClientData.sounds &= (0xFF ^ TORPEDO_HIT_BIT); // set 0
-                    else                            // bit was 0
-                        toClientData.sounds |= TORPEDO_HIT_BIT;     // set 1
+                    if(i != j && ship[j].getConnected())    // for all other players
+                        ship[j].scored();   // everyone else scores
                 }
             }
+            else                            // torpedo hit planet
+            {
+                torpedo[i].crash();
+                // change the state of the sound bit to play the sound
+                toClientData.sounds ^= TORPEDO_CRASH_BIT;
+            }
         }
+    }
 
+    for (int i=0; i<playerLimit; i++)
+    {
         if(ship[i].getExplosionOn())
             toClientData.sounds ^= EXPLODE_BIT; // play explosion sound
+    }
 
-        // if collision between torpedo and planet
-        if(torpedo[i].collidesWith(planet, collisionVector))
-        {
-            torpedo[i].crash();
-            // change the state of the sound bit to play the sound
-            toClientData.sounds ^= TORPEDO_CRASH_BIT;
-        }
+    broadphase.clear();
+    proxyEntity.clear();
+    for (int i=0; i<playerLimit; i++)
+    {
+        addToBroadphase(broadphase, proxyEntity, ship[i], i*2);
+        addToBroadphase(broadphase, proxyEntity, torpedo[i], i*2+1);
+    }
+
+    const std::vector<BroadphasePair> &pairs = broadphase.findPairs();
+    for (size_t n=0; n<pairs.size(); n++)
+    {
+        int a = proxyEntity[pairs[n].a];
+        int b = proxyEntity[pairs[n].b];
+        bool aIsShip = (a % 2 == 0);
+        bool bIsShip = (b % 2 == 0);
+        if (aIsShip && bIsShip)
+            collideShips(a/2, b/2, sounds);
+        else if (aIsShip && (torpedoLag[b/2] <= 0 || !rewound))
+            collideTorpedo(a/2, b/2, sounds);
+        else if (bIsShip && (torpedoLag[a/2] <= 0 || !rewound))
+            collideTorpedo(b/2, a/2, sounds);
+    }
+
+    // torpedos of lagging players hit the ships where their shooters saw them
+    for (int j=0; j<playerLimit && rewound; j++)
+    {
+        if (!torpedo[j].getActive() || torpedoLag[j] <= 0)
+            continue;
+        // the torpedo's move over this tick
+        VECTOR2 move = torpedo[j].getVelocity() * frameTime;
+        int i = rewind.sweep(torpedoLag[j], torpedo[j].getCenterX() - move.x,
+                             torpedo[j].getCenterY() - move.y, move.x, move.y,
+                             torpedo[j].getRadius() * torpedo[j].getScale(), j);
+        if (i >= 0 && ship[i].getActive())
+            torpedoHit(i, j, sounds);
+    }
+}
+
+//=============================================================================
+// Collide ship i with ship j
+// sounds = sound states before collisions were checked
+//=============================================================================
+void Spacewar::collideShips(int i, int j, UCHAR sounds)
+{
+    VECTOR2 collisionVector;
+
+    // if collision between ships
+    if(ship[i].collidesWith(ship[j], collisionVector))
+    {
+        // bounce off other ship
+        ship[i].bounce(collisionVector, ship[j]);
+        ship[j].bounce(collisionVector*-1, ship[i]);
+        ship[i].damage(SHIP);
+        ship[j].damage(SHIP);
+        if(ship[i].getHealth() <= 0)
+            ship[j].scored();
+        if(ship[j].getHealth() <= 0)
+            ship[i].scored();
+        // change the state of the sound bit to play the sound
+        if(sounds & COLLIDE_BIT)    // if bit was 1
+            toClientData.sounds &= (0xFF ^ COLLIDE_BIT); // set to 0
+        else                        // bit was 0
+            toClientData.sounds |= COLLIDE_BIT;     // set to 1
     }
 }
 
+//=============================================================================
+// Collide ship i with torpedo j
+// sounds = sound states before collisions were checked
+//=============================================================================
+void Spacewar::collideTorpedo(int i, int j, UCHAR sounds)
+{
+    VECTOR2 collisionVector;
+
+    if(i == j)  // don't collide with our own torpedo
+        return;
+    // if collision between ship and torpedo
+    if(ship[i].collidesWith(torpedo[j], collisionVector))
+        torpedoHit(i, j, sounds);
+}
+
+//=============================================================================
+// Torpedo j hit ship i
+// sounds = sound states before collisions were checked
+//=============================================================================
+void Spacewar::torpedoHit(int i, int j, UCHAR sounds)
+{
+    ship[i].damage(TORPEDO);
+    torpedo[j].setVisible(false);
+    torpedo[j].setActive(false);
+    ship[j].scored();
+    // change the state of the sound bit to play the sound
+    if(sounds & TORPEDO_HIT_BIT)    // if bit was 1
+        toClientData.sounds &= (0xFF ^ TORPEDO_HIT_BIT); // set 0
+    else                            // bit was 0
+        toClientData.sounds |= TORPEDO_HIT_BIT;     // set 1
+}
+
+//=============================================================================
+// Judge the torpedo player p just fired against the ships where p saw them
+// p sees the other ships its playout delay, sent with its input, behind the
+// newest snapshot it has acknowledged. Its torpedo is swept against the
+// ships that far back, up to the rewind window, for as long as it flies,
+// instead of against the ships now.
+//=============================================================================
+void Spacewar::compensate(int p)
+{
+    float lag = 0;
+    UINT seen = history.getTime(snapshotAck[p]);
+    if (seen != 0)              // a snapshot p has is still held
+        lag = (float)(snapshotClock - (seen / 1000.0 - playoutDelay[p]));
+    if (lag > rewind.getWindow())
+        lag = rewind.getWindow();
+    if (lag < 0)
+        lag = 0;
+    torpedoLag[p] = lag;
+}
+
 //=============================================================================
 // Render game items
 //=============================================================================
@@ -340,11 +567,24 @@ void Spacewar::render()
     healthBar.set(ship[1].getHealth());
     healthBar.draw(spacewarNS::SHIP2_COLOR);
 
-    ship[0].draw();                           // draw the spaceships
-    ship[1].draw();
+    // ships after the first two show their score above the ship
+    for (int i=2; i<MAX_PLAYERS; i++)
+    {
+        if (!ship[i].getVisible())
+            continue;
+        if (i % 2 == 0)
+            fontLabel.setFontColor(spacewarNS::SHIP1_COLOR);
+        else
+            fontLabel.setFontColor(spacewarNS::SHIP2_COLOR);
+        _snprintf_s(buffer, spacewarNS::BUF_SIZE, "%d", ship[i].getScore());
+        fontLabel.print(buffer, (int)ship[i].getX(), (int)ship[i].getY() - spacewarNS::FONT_LABEL_SIZE);
+    }
 
-    torpedo[0].draw(graphicsNS::FILTER);      // draw the torpedos using colorFilter
-    torpedo[1].draw(graphicsNS::FILTER);
+    for (int i=0; i<MAX_PLAYERS; i++)
+    {
+        ship[i].draw();                         // draw the spaceships
+        torpedo[i].draw(graphicsNS::FILTER);    // draw the torpedos using colorFilter
+    }
 
     if(menuOn)
         menu.draw();
@@ -372,9 +612,20 @@ void Spacewar::consoleCommand()
         console->print("Console Commands:");
         console->print("~ - show/hide console");
         console->print("fps - toggle display of frames per second");
+        console->print("sched - display frame scheduler statistics");
+        console->print("sched reset - clear frame scheduler statistics");
+        console->print("link - display packet loss, reordering and duplicates of each player");
         console->print("gravity off - turns off planet gravity");
         console->print("gravity on - turns on planet gravity");
+        console->print("gravity mutual on|off - ships and torpedos attract each other");
+        console->print("gravity theta # - sets Barnes-Hut opening angle, 0 is exact");
+        console->print("gravity tree # - sets gravity sources before Barnes-Hut is used");
+        console->print("well x y [mass] - adds a gravity well, mass in planet masses");
+        console->print("well clear - removes all gravity wells");
         console->print("port # - sets port number, CAUTION! Restarts server");
+        console->print("players # - sets players in a full game, CAUTION! Restarts server");
+        console->print("tick # - sets simulation ticks/sec, 0 uses frame time");
+        console->print("rewind # - sets lag compensation window in ms, 0 is off, max 250");
         return;
     }
     else if (command == "fps")
@@ -385,16 +636,141 @@ void Spacewar::consoleCommand()
         else
             console->print("fps Off");
     }
+    else if (command == "sched")
+        console->print(scheduler.getStatsString());
+    else if (command == "sched reset")
+    {
+        scheduler.resetStats();
+        console->print("Scheduler statistics cleared");
+    }
+    else if (command == "link")
+    {
+        for (int i=0; i<playerLimit; i++)
+        {
+            if (!ship[i].getConnected())
+                continue;
+            std::stringstream ss;
+            ss << "Player " << i << " " << ship[i].getNetIP() << " "
+               << ship[i].getLink().getStatsString() << ", dropped " << ship[i].getCommErrors();
+            console->print(ss.str());
+        }
+    }
     else if (command == "gravity off")
     {
-        planet.setMass(0);
+        gravityOn = false;
         console->print("Gravity Off");
     }
     else if (command == "gravity on")
     {
-        planet.setMass(planetNS::MASS);
+        gravityOn = true;
         console->print("Gravity On");
     }
+    else if (command == "gravity mutual on" || command == "gravity mutual off")
+    {
+        gravityBatch.setMutual(command == "gravity mutual on");
+        console->print(gravityBatch.getMutual() ? "Mutual gravity On" : "Mutual gravity Off");
+    }
+    else if (command.substr(0,13) == "gravity theta")
+    {
+        float theta = -1;
+        if(command.size() > 14)
+            theta = (float)atof(command.substr(14).c_str());
+        if(theta >= 0)
+        {
+            gravityBatch.setTheta(theta);
+            std::stringstream ss;
+            ss << "Barnes-Hut theta " << theta;
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid theta");
+    }
+    else if (command.substr(0,12) == "gravity tree")
+    {
+        int n = -1;
+        if(command.size() > 13)
+            n = atoi(command.substr(13).c_str());
+        if(n >= 0)
+        {
+            gravityBatch.setTreeThreshold(n);
+            std::stringstream ss;
+            ss << "Barnes-Hut used above " << n << " gravity sources";
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid source count");
+    }
+    else if (command == "well clear")
+    {
+        wells.clear();
+        console->print("Gravity wells removed");
+    }
+    else if (command.substr(0,4) == "well")
+    {
+        GravitySource well;
+        float mass = 1;
+        std::stringstream args(command.substr(4));
+        if(wells.size() >= (size_t)MAX_WELLS)      // clients can not be sent more
+        {
+            std::stringstream ss;
+            ss << "At most " << MAX_WELLS << " gravity wells";
+            console->print(ss.str());
+        }
+        else if(args >> well.x >> well.y)
+        {
+            args >> mass;
+            well.mass = mass * planetNS::MASS;
+            wells.push_back(well);
+            std::stringstream ss;
+            ss << "Gravity well at " << well.x << "," << well.y << " mass " << mass;
+            console->print(ss.str());
+        }
+        else
+            console->print("Usage: well x y [mass]");
+    }
+    else if (command.substr(0,4) == "tick")
+    {
+        std::stringstream ss;
+        if(command.size() > 5)
+            setSimRate((float)atof(command.substr(5).c_str()));
+        if(getSimRate() > 0)
+            ss << "Simulation rate " << getSimRate() << " ticks/sec";
+        else
+            ss << "Simulation uses variable frame time";
+        console->print(ss.str());
+    }
+    else if (command.substr(0,6) == "rewind")
+    {
+        int ms = -1;
+        if(command.size() > 7)
+            ms = atoi(command.substr(7).c_str());
+        if(ms >= 0 && ms <= (int)(rewindNS::MAX_WINDOW * 1000))
+        {
+            rewind.setWindow(ms / 1000.0f);
+            std::stringstream ss;
+            ss << "Lag compensation window " << ms << " ms";
+            console->print(ss.str());
+        }
+        else
+            console->print("Invalid rewind window");
+    }
+    else if (command.substr(0,7) == "players")
+    {
+        int players = 0;
+        if(command.size() > 8)
+            players = atoi(command.substr(8).c_str());
+        if(players >= 2 && players <= MAX_PLAYERS)
+        {
+            playerLimit = players;      // set players in a full game
+            countDownOn = false;
+            playerCount = 0;
+            netTime = 0;
+            initializeServer(port);     // re-initialize game server
+            roundOver = true;
+        }
+        else
+            console->print("Invalid number of players");
+    }
     else if (command.substr(0,4) == "port")
     {
         int newPort = atoi(command.substr(5).c_str());
@@ -422,6 +798,7 @@ void Spacewar::releaseAll()
     nebulaTexture.onLostDevice();
     gameTextures.onLostDevice();
     fontScore.onLostDevice();
+    fontLabel.onLostDevice();
     fontBig.onLostDevice();
 
     Game::releaseAll();
@@ -436,6 +813,7 @@ void Spacewar::resetAll()
 {
     fontBig.onResetDevice();
     fontScore.onResetDevice();
+    fontLabel.onResetDevice();
     gameTextures.onResetDevice();
     nebulaTexture.onResetDevice();
     menuTexture.onResetDevice();
@@ -471,16 +849,21 @@ int Spacewar::initializeServer(int port)
     for (int i=0; i<MAX_PLAYERS; i++)       // for all players
     {
         ship[i].setActive(false);
+        ship[i].setVisible(false);
+        torpedo[i].setActive(false);
+        torpedo[i].setVisible(false);
         ship[i].setConnected(false);
         ship[i].setScore(0);
     }
+    toClientData.playerCount = (UCHAR)playerLimit;
+    history.initialize(playerLimit);
 
     console->print("----- Server -----");
     net.getLocalIP(localIP);
     ss << "Server IP: " << localIP;
     console->print(ss.str());
     ss.str("");                             // clear stringstream
-    ss << "Port: " << port;
+    ss << "Port: " << port << "  Players: " << playerLimit;
     console->print(ss.str());
     return netNS::NET_OK;
 }
@@ -511,7 +894,7 @@ void Spacewar::checkNetworkTimeout()
 {
     std::stringstream ss;
 
-    for (int i=0; i<MAX_PLAYERS; i++)       // for all players
+    for (int i=0; i<playerLimit; i++)       // for all players
     {
         if (ship[i].getConnected())
         {
@@ -535,29 +918,71 @@ void Spacewar::doClientCommunication()
 {
     int playN;                  // player number we are communicating with
     int size;
-    prepareDataForClient();     // prepare data for transmission to clients
+    char message[messageNS::TO_SERVER_SIZE];
+    bool prepared = false;      // snapshot of this frame taken
 
-    for (int i=0; i<MAX_PLAYERS; i++)   // for all players
+    for (int i=0; i<playerLimit; i++)   // for all players
     {
-        size = sizeof(toServerData);
-        if( net.readData((char*) &toServerData, size, remoteIP, port) == netNS::NET_OK) 
+        size = messageNS::TO_SERVER_SIZE;
+        if( net.readData(message, size, remoteIP, port) == netNS::NET_OK) 
         {
-            if(size > 0)                // if data received
+            if(readToServer(message, size, toServerData))   // if input received
             {
                 playN = toServerData.playerN;
                 if (playN == 255)       // if request to join game
                 {
                     clientWantsToJoin();
                 } 
-                else if (playN >= 0 && playN < MAX_PLAYERS)  // if valid playerN
+                else if (playN >= 0 && playN < playerLimit)  // if valid playerN
                 {
-                    if (ship[playN].getConnected()) // if this player is connected
+                    // if this player is connected and sent its own token
+                    // from the address it joined from
+                    if (ship[playN].getConnected() &&
+                        toServerData.token == sessionToken[playN] &&
+                        strcmp(ship[playN].getNetIP(), remoteIP) == 0)
                     {
+                        // drop input that is a duplicate or older than input applied
+                        PacketLink &link = ship[playN].getLink();
+                        if (!link.receive(toServerData.header))
+                        {
+                            ship[playN].incCommErrors();
+                            ship[playN].incCommWarnings();
+                            if (ship[playN].getCommWarnings() <= netNS::MAX_COMM_WARNINGS)
+                                continue;
+                            // so many in a row, the client must have started over
+                            link.resync();
+                            link.receive(toServerData.header);
+                        }
+                        // snapshot the game once a frame, only when there is a
+                        // reply to send, before this frame's input is applied
+                        if (!prepared)
+                        {
+                            prepareDataForClient();
+                            prepared = true;
+                        }
                         if (ship[playN].getActive()) // if this player is active
                             ship[playN].setButtons(toServerData.buttons);
-                        size = sizeof(toClientData);
-                        // send player the latest game data
-                        net.sendData((char*) &toClientData, size, remoteIP, port);
+                        inputApplied[playN] = toServerData.header.sequence;
+                        playoutDelay[playN] = toServerData.delay / 1000.0f;
+                        // inputs may arrive out of order, keep the newest ack
+                        if (snapshotAck[playN] == 0 ||
+                            (short)(toServerData.ack - snapshotAck[playN]) > 0)
+                            snapshotAck[playN] = toServerData.ack;
+                        // send player the latest game data, as changes from
+                        // the newest snapshot it has
+                        size = history.write(snapshotAck[playN], packet + snapshotNS::PREFIX_SIZE,
+                                             sizeof(packet) - snapshotNS::PREFIX_SIZE);
+                        if (size > 0)
+                        {
+                            PacketHeader header;
+                            link.stamp(header);
+                            PacketLink::writeHeader(header, packet);
+                            // the input the player's ship had when the snapshot was taken
+                            BitWriter tag(packet + packetLinkNS::HEADER_SIZE, 2);
+                            tag.write(inputShown[playN], 16);
+                            size += snapshotNS::PREFIX_SIZE;
+                            net.sendData(packet, size, remoteIP, port);
+                        }
                         ship[playN].setTimeout(0);
                         ship[playN].setCommWarnings(0);
                     }
@@ -576,11 +1001,34 @@ void Spacewar::doClientCommunication()
 //=============================================================================
 void Spacewar::prepareDataForClient()
 {
-    for (int i=0; i<MAX_PLAYERS; i++)       // for all players
+    // the pull the clients replay their ships with
+    GravityStc &gravity = toClientData.gravity;
+    gravity.flags = 0;
+    if (gravityOn)
+        gravity.flags |= GRAVITY_ON_BIT;
+    if (gravityBatch.getMutual())
+        gravity.flags |= MUTUAL_GRAVITY_BIT;
+    gravity.wellCount = (UCHAR)wells.size();
+    for (size_t n=0; n<wells.size(); n++)
+    {
+        gravity.well[n].x = wells[n].x;
+        gravity.well[n].y = wells[n].y;
+        gravity.well[n].mass = wells[n].mass;
+    }
+    toClientData.torpedoCount = 0;
+    for (int i=0; i<playerLimit; i++)       // for all players
     {
         toClientData.player[i].shipData = ship[i].getNetData();
-        toClientData.player[i].torpedoData = torpedo[i].getNetData();
+        if (torpedo[i].getActive())         // each player has one torpedo
+        {
+            TorpedoStc &torpedoData = toClientData.torpedo[toClientData.torpedoCount++];
+            torpedoData = torpedo[i].getNetData();
+            torpedoData.id = torpedoId[i];
+            torpedoData.owner = (UCHAR)i;
+        }
+        inputShown[i] = inputApplied[i];
     }
+    history.add(toClientData, (UINT)(snapshotClock * 1000));
 }
 
 //=============================================================================
@@ -589,21 +1037,22 @@ void Spacewar::prepareDataForClient()
 void Spacewar::clientWantsToJoin()
 {
     std::stringstream ss;
+    char response[messageNS::CONNECT_RESPONSE_SIZE];
     int size;
     int status;
 
     connectResponse.number = 255;       // set to invalid player number
 
-    if(playerCount == 0)                // if no players currently in game
+    if(getPlayerCount() == 0)           // if no players currently in game
     {
         roundOver = true;               // start a new round
-        for(int i=0; i<MAX_PLAYERS; i++)    // for all players
+        for(int i=0; i<playerLimit; i++)    // for all players
             ship[i].setScore(0);        // reset score
     }
 
     console->print("Player requesting to join.");
     // find available player position to use
-    for(int i=0; i<MAX_PLAYERS; i++)        // search all player positions
+    for(int i=0; i<playerLimit; i++)        // search all player positions
     {
         if (ship[i].getConnected() == false)    // if this position available
         {
@@ -612,11 +1061,21 @@ void Spacewar::clientWantsToJoin()
             ship[i].setCommWarnings(0);
             ship[i].setNetIP(remoteIP);     // save player's IP
             ship[i].setCommErrors(0);       // clear old errors
-            // send SERVER_ID and player number to client
+            snapshotAck[i] = 0;             // first snapshot is sent in full
+            playoutDelay[i] = rewindNS::VIEW_DELAY; // until its input says
+            inputApplied[i] = 0;
+            inputShown[i] = 0;
+            ship[i].getLink().reset();
+            do
+                sessionToken[i] = tokenSource();
+            while (sessionToken[i] == 0);   // 0 is sent by joining clients
+            // send SERVER_ID, player number and session token to client
             strcpy_s(connectResponse.response, netNS::SERVER_ID);
             connectResponse.number = (UCHAR)i;
-            size = sizeof(connectResponse);
-            status = net.sendData((char*)&connectResponse, size, remoteIP, port);
+            connectResponse.token = sessionToken[i];
+            writeConnectResponse(connectResponse, response);
+            size = messageNS::CONNECT_RESPONSE_SIZE;
+            status = net.sendData(response, size, remoteIP, port);
             if ( status == netNS::NET_ERROR) 
             {
                 console->print(net.getError(status));   // display error message
@@ -630,9 +1089,21 @@ void Spacewar::clientWantsToJoin()
     }
     // send SERVER_FULL to client
     strcpy_s(connectResponse.response, netNS::SERVER_FULL);
-    size = sizeof(connectResponse);
-    status = net.sendData((char*)&connectResponse, size, remoteIP, port);
+    connectResponse.token = 0;
+    writeConnectResponse(connectResponse, response);
+    size = messageNS::CONNECT_RESPONSE_SIZE;
+    status = net.sendData(response, size, remoteIP, port);
     console->print("Server full.");
 }
 
-
+//=============================================================================
+// Return number of connected players
+//=============================================================================
+int Spacewar::getPlayerCount()
+{
+    int count = 0;
+    for (int i=0; i<playerLimit; i++)
+        if (ship[i].getConnected())
+            count++;
+    return count;
+}
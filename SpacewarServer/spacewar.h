@@ -6,6 +6,8 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
+#include <random>
 #include "game.h"
 #include "textureManager.h"
 #include "image.h"
@@ -14,12 +16,19 @@
 #include "ship.h"
 #include "torpedo.h"
 #include "net.h"
+#include "packetLink.h"
+#include "protocol.h"
+#include "broadphase.h"
+#include "circleBatch.h"
+#include "gravityBatch.h"
+#include "rewind.h"
 
 namespace spacewarNS
 {
     const char FONT[] = "Arial Bold";  // font
     const int FONT_BIG_SIZE = 256;     // font height
     const int FONT_SCORE_SIZE = 48;
+    const int FONT_LABEL_SIZE = 16;    // score shown above ships 3 and up
     const COLOR_ARGB FONT_COLOR = graphicsNS::YELLOW;
     const COLOR_ARGB SHIP1_COLOR = graphicsNS::BLUE;
     const COLOR_ARGB SHIP2_COLOR = graphicsNS::YELLOW;
@@ -39,72 +48,15 @@ namespace spacewarNS
     // Game types
     const int CLIENT = 1;           // client in network game
     const int SERVER = 2;           // server in network game
-    const int MAX_PLAYERS = 2;      // maximum number of network players
+    const int DEFAULT_PLAYERS = 2;  // players in a full game unless changed
+    // Starting orbits, ships fill the first ring before the next
+    const int   ORBITS = 3;
+    const float ORBIT_RADIUS[ORBITS] = {GAME_WIDTH/4.0f, GAME_WIDTH/4.0f + 60, GAME_WIDTH/4.0f - 60};
+    const float ORBIT_SPACING = 44;     // minimum distance between ships on an orbit
     // Network
     const int BUFSIZE = 256;
-    const int LEFT_BIT = 0x01;      // player buttons
-    const int FORWARD_BIT = 0x02;
-    const int RIGHT_BIT = 0x04;
-    const int FIRE_BIT = 0x08;
-    // Game State bits
-    const int ROUND_START_BIT = 0x01;
-    // Network, sounds for client to play
-    const int ENGINE1_BIT       = 0x01; // Bit 0 = engine1      1=on, 0=off
-    const int ENGINE2_BIT       = 0x02; // Bit 1 = engine2      1=on, 0=off
-    const int CHEER_BIT         = 0x04; // Bit 2 = cheer        state change
-    const int COLLIDE_BIT       = 0x08; // Bit 3 = collide      state change
-    const int EXPLODE_BIT       = 0x10; // Bit 4 = explode      state change
-    const int TORPEDO_CRASH_BIT = 0x20; // Bit 5 = torpedoCrash state change
-    const int TORPEDO_FIRE_BIT  = 0x40; // Bit 6 = torpedoFire  state change
-    const int TORPEDO_HIT_BIT   = 0x80; // Bit 7 = torpedoHit   state change
 }
 
-//=============================================================================
-// network play structures
-//=============================================================================
-
-// Sent to client in response to connection request
-struct ConnectResponse
-{
-    char response[netNS::RESPONSE_SIZE];    // server response
-    UCHAR   number;                         // player number if connected
-};
-
-// Player describes the ship and torpedo for one player.
-struct Player
-{
-    ShipStc     shipData;
-    TorpedoStc  torpedoData;
-};
-
-// ToClientStc is the structure that is sent from the server to each client. 
-struct ToClientStc 
-{
-    Player  player[spacewarNS::MAX_PLAYERS];
-    // game state
-    // Bit 0 = roundStart
-    // Bits 1-7 reserved for future use
-    UCHAR   gameState;
-    // sound to play   
-    // Bit 0 = cheer        state change
-    // Bit 1 = collide      state change
-    // Bit 2 = explode      state change
-    // Bit 3 = engine1      1=on, 0=off
-    // Bit 4 = engine2      1=on, 0=off
-    // Bit 5 = torpedoCrash state change
-    // Bit 6 = torpedoFire  state change
-    // Bit 7 = torpedoHit   state change
-    UCHAR   sounds;
-};
-
-// ToServerStc is the structure that is sent from the client to the server.
-struct ToServerStc 
-{
-    // current key presses
-    UCHAR buttons;      // bit 0=Left, 1=Forward, 2=Right, 3=Fire
-    UCHAR playerN;      // player number
-};
-
 //=============================================================================
 // Spacewar is the class we create, it inherits from the Game class
 //=============================================================================
@@ -127,10 +79,21 @@ private:
     float   startTimer;
     TextDX  fontBig;            // DirectX font for game banners
     TextDX  fontScore;
+    TextDX  fontLabel;          // small font for scores above ships
     char    buffer[spacewarNS::BUF_SIZE];
     bool    roundOver;          // true when round is over
     float   roundTimer;         // time until new round starts
-    int     ship1Score, ship2Score; // scores
+    int     playerLimit;        // players in a full game
+    Broadphase broadphase;      // culls ship and torpedo pairs before collidesWith
+    std::vector<int> proxyEntity;   // broadphase proxy -> playerN*2, +1 if torpedo
+    CircleBatch circles;        // active ships and torpedos, tested against the planet
+    std::vector<int> circleEntity;  // circles index -> playerN*2, +1 if torpedo
+    std::vector<unsigned int> hitMask;  // planet hits from circles.collide()
+    std::vector<VECTOR2> hitVector;
+    GravityBatch gravityBatch;  // active ships and torpedos pulled by the planet
+    std::vector<Entity*> gravityEntity; // gravityBatch index -> entity
+    std::vector<GravitySource> wells;   // gravity sources besides the planet
+    bool    gravityOn;          // false turns off all gravity
 
     // Network variables
     Net  net;                   // network object
@@ -140,7 +103,20 @@ private:
     UINT gameType;
     ToServerStc toServerData;
     ToClientStc toClientData;
+    SnapshotHistory history;    // recent toClientData, baselines for deltas
+    char packet[snapshotNS::MAX_PACKET_SIZE];   // header and newest snapshot for one client
+    USHORT snapshotAck[spacewarNS::MAX_PLAYERS];   // newest snapshot each player has
+    USHORT inputApplied[spacewarNS::MAX_PLAYERS];  // sequence of each player's newest input
+    USHORT inputShown[spacewarNS::MAX_PLAYERS];    // inputApplied when the snapshot was taken
+    USHORT torpedoId[spacewarNS::MAX_PLAYERS];     // serial number of each player's torpedo
+    USHORT nextTorpedoId;       // given to the next torpedo fired
+    double snapshotClock;       // seconds simulated, stamps snapshots and rewind ticks
+    RewindHistory rewind;       // where the ships were, for torpedos fired by lagging players
+    float torpedoLag[spacewarNS::MAX_PLAYERS];     // seconds back each player's torpedo is judged
+    float playoutDelay[spacewarNS::MAX_PLAYERS];   // seconds each player shows the other ships behind
     ConnectResponse connectResponse;
+    UINT sessionToken[spacewarNS::MAX_PLAYERS];    // each player's token, from the join
+    std::random_device tokenSource;                 // unpredictable session tokens
     int playerCount;            // number of players in game
     float netTime;
     int error;
@@ -158,6 +134,12 @@ public:
     void render();      // "
     void consoleCommand(); // process console command
     void roundStart();  // start a new round of play
+    void applyGravity(float frameTime); // add the pull of the planet, wells and, if mutual, other ships
+    void collideShips(int i, int j, UCHAR sounds);    // collide ship i with ship j
+    void collideTorpedo(int i, int j, UCHAR sounds);  // collide ship i with torpedo j
+    void torpedoHit(int i, int j, UCHAR sounds);      // torpedo j hit ship i
+    void compensate(int p);     // judge the torpedo p just fired where p saw the ships
+    int  getPlayerCount();  // return number of connected players
     void releaseAll();
     void resetAll();
 
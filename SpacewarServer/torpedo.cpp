@@ -98,5 +98,7 @@ TorpedoStc Torpedo::getNetData()
     data.Y = getY();
     data.velocity = getVelocity();
     data.active = active;
+    data.id = 0;                // the server numbers the torpedos it sends
+    data.owner = 0;
     return data;
 }
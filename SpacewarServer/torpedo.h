@@ -5,6 +5,7 @@
 
 #include "entity.h"
 #include "constants.h"
+#include "protocol.h"
 
 namespace torpedoNS
 {
@@ -20,15 +21,6 @@ namespace torpedoNS
     const float ANIMATION_DELAY = 0.1f; // time between frames
 }
 
-// TorpedoStc contains all of the information a client needs for one torpedo.
-struct TorpedoStc 
-{
-    float X;
-    float Y;
-    VECTOR2 velocity;
-    bool  active;                       // true when active
-};
-
 // inherits from Entity class
 class Torpedo : public Entity
 {